@@ -7,13 +7,20 @@
 /* Header files needed */
 /* Do NOT include private HDF5 files here! */
 #include <assert.h>
+#include <ctype.h>
 #include <stdarg.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
 #include <errno.h>
+#include <fnmatch.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
+#include <zlib.h>
 
 /* Public HDF5 file */
 #include "hdf5.h"
@@ -48,11 +55,427 @@
 const uint8_t H5_EXT_LENGTH = 6;
 const char FILE_EXTENTION[] = ".split";
 const char ATTRIBUTE_NAME[] = "split_file";
+const char OWNER_ATTRIBUTE_NAME[] = "split_owner";
+
+/* Default number of idle split files kept open by the split file pool, none: split files close with their
+ * datasets unless the pool is asked for */
+#define H5VL_DSET_SPLIT_POOL_SIZE_DEFAULT 0
+
+/* Memory growth step of split files using the core driver */
+#define H5VL_DSET_SPLIT_CORE_INCREMENT (1024 * 1024)
+
+/* Dataset operations run on the connector's threads with a thread-safe HDF5 library */
+#if defined(H5_HAVE_THREADSAFE) && defined(H5VL_CAP_FLAG_ASYNC)
+#define H5VL_DSET_SPLIT_CAP_FLAGS H5VL_CAP_FLAG_ASYNC
+#else
+#define H5VL_DSET_SPLIT_CAP_FLAGS 0
+#endif
+
+/* Max. number of threads of a multi-dataset read or write */
+#define H5VL_DSET_SPLIT_DIRECT_THREADS_MAX 16
+
+/* Default memory budget of the write-behind buffers of a file, in bytes */
+#define H5VL_DSET_SPLIT_WB_BUDGET (64 * 1024 * 1024)
+
+/* Max. size of the read-ahead window of a dataset, in bytes */
+#define H5VL_DSET_SPLIT_RA_MAX (64 * 1024 * 1024)
+
+/* Max. number of threads compressing or expanding the chunks of a dataset transfer */
+#define H5VL_DSET_SPLIT_ZIP_THREADS_MAX 64
+
+/* Number of chunks a compression thread may hold ahead of the chunk I/O */
+#define H5VL_DSET_SPLIT_ZIP_WINDOW 4
+
+/* Initial number of hash buckets in the split file pool */
+#define H5VL_DSET_SPLIT_POOL_NBUCKETS 64
+
+/* Max. number of levels of hash-prefix subfolders in a split folder */
+#define H5VL_DSET_SPLIT_SHARD_LEVELS_MAX 3
+
+/* Name prefix of the pre-created split files waiting in a split folder */
+#define H5VL_DSET_SPLIT_RESERVE_PREFIX ".reserve"
+
+/* Part of the memory budget going to the metadata caches of split files, 1/N; the rest is for chunk caches */
+#define H5VL_DSET_SPLIT_GOV_MDC_SHARE 4
+
+/* Bounds of the metadata cache size of a split file under a memory budget */
+#define H5VL_DSET_SPLIT_GOV_MDC_MIN (64 * 1024)
+#define H5VL_DSET_SPLIT_GOV_MDC_MAX (128 * 1024 * 1024)
+
+/* Work dset_split_dataset_create may put off */
+#define H5VL_DSET_SPLIT_CREATE_LAZY  0x1 /* The creation itself, to the first write */
+#define H5VL_DSET_SPLIT_CREATE_QUEUE 0x2 /* The external link, to the next flush of the file */
+
+/* Kinds of bounding boxes of the ranks' selections, see H5VL_dset_split_box_t */
+#define H5VL_DSET_SPLIT_BOX_UNKNOWN 0 /* The rank has no selection to go by */
+#define H5VL_DSET_SPLIT_BOX_EMPTY   1 /* The rank selects nothing */
+#define H5VL_DSET_SPLIT_BOX_SET     2 /* 'first' and 'last' are the corners of the selection */
 
 /************/
 /* Typedefs */
 /************/
 
+/* An open split file, shared by all the datasets which borrow it from the pool */
+typedef struct H5VL_dset_split_pool_entry_t {
+    char *path;     /* Split file name, as stored in the external link */
+    hid_t fid;      /* ID of the open split file */
+    unsigned flags; /* Access flags the split file was opened with */
+    unsigned nrefs; /* Number of datasets currently borrowing the split file */
+    const unsigned char *map; /* The split file mapped into memory, NULL until a dataset needs it */
+    size_t map_size;
+    hbool_t map_failed;       /* The split file can't be mapped */
+    struct H5VL_dset_split_t *users;                  /* Datasets opened from the split file */
+    uint64_t naccess;                                 /* Dataset accesses since the split file was opened */
+    struct H5VL_dset_split_pool_entry_t *prev;        /* LRU list, most recently used first */
+    struct H5VL_dset_split_pool_entry_t *next;
+    struct H5VL_dset_split_pool_entry_t *hash_next;   /* Next entry in the same hash bucket */
+} H5VL_dset_split_pool_entry_t;
+
+/* Connector-owned pool of open split files, keyed by path, with LRU eviction of idle files */
+typedef struct H5VL_dset_split_pool_t {
+    H5VL_dset_split_pool_entry_t **buckets; /* Hash buckets */
+    size_t nbuckets;
+    size_t nentries;                        /* Number of open split files */
+    size_t nidle;                           /* Number of open split files not borrowed by any dataset */
+    unsigned capacity;                      /* Max. number of idle split files kept open */
+    unsigned max_open;                      /* Max. number of split files open, borrowed or idle (0 for no limit) */
+    H5VL_dset_split_pool_entry_t *head;     /* Most recently used */
+    H5VL_dset_split_pool_entry_t *tail;     /* Least recently used */
+} H5VL_dset_split_pool_t;
+
+/* Connector-wide memory budget of the metadata caches of split files and the chunk caches of split datasets */
+typedef struct H5VL_dset_split_gov_t {
+    hsize_t budget;     /* In bytes, 0 disables the governor */
+    size_t mdc_size;    /* Metadata cache size of each open split file, 0 until one is open */
+    hsize_t chunk_used; /* Chunk cache bytes of the open split datasets */
+    uint64_t weight;    /* Sum of the weights of the open chunked split datasets */
+    size_t nusers;      /* Number of open chunked split datasets */
+} H5VL_dset_split_gov_t;
+
+/* Names of the external links below a group, gathered by dset_split_mirror_collect() */
+typedef struct H5VL_dset_split_names_t {
+    char **names;
+    size_t count;
+    size_t nalloc;
+} H5VL_dset_split_names_t;
+
+/* Empty split files pre-created in one split folder, waiting to be renamed into place */
+typedef struct H5VL_dset_split_reserve_t {
+    char *folder;       /* Split folder the files are created in */
+    char *owner;        /* Main file the split files are created for, see dset_split_create_attribute() */
+    hid_t fcpl_id;      /* Creation properties of the split files */
+    hid_t fapl_id;      /* Access properties of the split files */
+    hid_t *fids;        /* Open pre-created split files */
+    char **paths;       /* Their current (temporary) names */
+    size_t count;       /* Number of split files in the reserve */
+    size_t nalloc;      /* Size of 'fids' and 'paths' */
+    hbool_t busy;       /* Whether split files are being created for this reserve */
+    hbool_t closing;    /* Set when the main file closed while the reserve was busy */
+    hbool_t failed;     /* Pre-creation failed or is not possible in this folder */
+    struct H5VL_dset_split_reserve_t *next;
+} H5VL_dset_split_reserve_t;
+
+/* Background pre-creation of split files */
+typedef struct H5VL_dset_split_precreate_t {
+    unsigned target;                   /* Number of split files to keep in each reserve (0 disables) */
+    H5VL_dset_split_reserve_t *head;   /* Reserves, one per split folder */
+    unsigned long serial;              /* Used to name the pre-created files */
+    hbool_t threaded;                  /* Whether the HDF5 library allows a background worker */
+    pthread_mutex_t mutex;             /* Protects the reserves */
+    hbool_t worker_running;            /* Whether the worker thread refilling the reserves runs */
+    hbool_t shutdown;                  /* Asks the worker to exit */
+    hbool_t joinable;                  /* Whether 'worker' was started and not joined yet */
+    pthread_t worker;                  /* The worker thread */
+} H5VL_dset_split_precreate_t;
+
+/* How a split policy rule matches dataset paths */
+typedef enum H5VL_dset_split_match_t {
+    H5VL_DSET_SPLIT_MATCH_ANY,    /* "*" */
+    H5VL_DSET_SPLIT_MATCH_EXACT,  /* No wildcard */
+    H5VL_DSET_SPLIT_MATCH_PREFIX, /* Single trailing '*' */
+    H5VL_DSET_SPLIT_MATCH_SUFFIX, /* Single leading '*' */
+    H5VL_DSET_SPLIT_MATCH_GLOB    /* Anything else, through fnmatch() */
+} H5VL_dset_split_match_t;
+
+/* A split policy rule, "pattern:placement" */
+typedef struct H5VL_dset_split_rule_t {
+    H5VL_dset_split_match_t match;
+    char *pattern;                    /* Pattern, without the '*' for prefix and suffix rules */
+    size_t len;                       /* Length of 'pattern' */
+    H5VL_dset_split_mode_t placement; /* Where matching datasets go */
+} H5VL_dset_split_rule_t;
+
+/* Compiled split policy table, first matching rule wins */
+typedef struct H5VL_dset_split_policy_t {
+    size_t nrules;
+    H5VL_dset_split_rule_t *rules;
+} H5VL_dset_split_policy_t;
+
+struct H5VL_dset_split_wb_t;
+
+/* External link of a split dataset, waiting to be inserted in the main file */
+typedef struct H5VL_dset_split_link_t {
+    char *path;      /* Absolute path of the dataset */
+    char *file_name; /* Split file of the dataset */
+    char *dsetname;  /* Name of the dataset in the split file */
+    struct H5VL_dset_split_link_t *next;
+} H5VL_dset_split_link_t;
+
+/* Parent-file metadata, computed once per file and shared with the objects opened from it */
+typedef struct H5VL_dset_split_file_ctx_t {
+    unsigned nrefs;     /* Number of objects sharing the context */
+    char *parent_name;  /* Main file name, without ".h5" */
+    char *owner;        /* Main file name without its folder, recorded in the split files it creates */
+    char *split_folder; /* Folder hosting the split files */
+    hbool_t folder_ready; /* The split folder was checked to exist since the main file was opened */
+    unsigned shard_levels; /* Levels of hash-prefix subfolders split files go in (0 for none) */
+    uint8_t *shard_ready;  /* Bitmap of the subfolders checked to exist, NULL until one is */
+    hbool_t mirror_groups; /* Split files go in subfolders mirroring their group path */
+    char *dir_ready;       /* Last mirrored subfolder checked to exist, NULL for none */
+    hid_t fcpl_id;      /* Creation properties of new split files */
+    hid_t fapl_id;      /* Access properties of split files */
+    unsigned intent;    /* Access flags of the main file */
+    hbool_t subfiling;  /* Write the datasets of a parallel main file to rank-local split files */
+    hbool_t direct_io;  /* Allow multi-dataset reads and writes to bypass the library */
+    hsize_t split_threshold; /* Datasets up to this size in bytes stay in the main file (0 splits all) */
+    H5VL_dset_split_mode_t split_mode; /* Placement of datasets no policy rule matches */
+    H5VL_dset_split_policy_t *policy;  /* Per-path placement, NULL to use 'split_mode' for all */
+    hsize_t write_behind;  /* Dataset writes up to this size in bytes are buffered (0 disables) */
+    hsize_t wb_budget;     /* Memory the write-behind buffers of the file may use */
+    hsize_t wb_used;       /* Memory they use */
+    struct H5VL_dset_split_wb_t *wb_head; /* Non-empty write-behind buffers of the file */
+    unsigned read_ahead;   /* Number of sequential dataset reads prefetched (0 disables) */
+    hbool_t mmap_read;     /* Serve reads of read-only split files from memory mappings */
+    unsigned compress_threads; /* Threads compressing the chunks of deflated datasets (0 leaves it to the library) */
+    hbool_t lazy_create;   /* Defer the creation of split datasets to their first write */
+    struct H5VL_dset_split_lazy_t *lazy_head; /* Datasets of the file whose creation is deferred */
+    hbool_t batch_links;   /* Queue the external links of new datasets until the file is flushed */
+    void *file_under;      /* Underlying main file object, to insert the queued links in */
+    H5VL_dset_split_link_t *link_head; /* Queued external links */
+    size_t nlinks;         /* Number of queued external links */
+#ifdef H5_HAVE_PARALLEL
+    MPI_Comm comm;      /* Communicator of a main file opened with MPI-IO, else MPI_COMM_NULL */
+    int mpi_rank;       /* Rank in 'comm' */
+#endif
+} H5VL_dset_split_file_ctx_t;
+
+/* A main file opened through the connector, with the options to rebuild the file contexts of its objects */
+typedef struct H5VL_dset_split_main_t {
+    char *name;                   /* Main file name, as it was opened */
+    H5VL_dset_split_info_t *info; /* Copy of the connector options it was opened with */
+    unsigned nopens;              /* Number of open file objects of the main file */
+    struct H5VL_dset_split_main_t *next;
+} H5VL_dset_split_main_t;
+
+/* Layout of a dataset of a parallel main file written to rank-local split files */
+typedef struct H5VL_dset_split_subfile_t {
+    hid_t space_id;                 /* Dataspace of the whole dataset */
+    hsize_t start[H5S_MAX_RANK];    /* First element of the rank's block */
+    hsize_t count[H5S_MAX_RANK];    /* Extent of the rank's block, 0 for a rank that wrote nothing */
+    char *file_name;                /* Split file stitching the blocks together */
+    struct H5VL_dset_split_lazy_t *pending; /* Creation arguments, until the first collective write lays it out */
+} H5VL_dset_split_subfile_t;
+
+/* Bounding box of a rank's selection, exchanged to lay a rank-local dataset out */
+typedef struct H5VL_dset_split_box_t {
+    int kind;
+    hsize_t first[H5S_MAX_RANK];
+    hsize_t last[H5S_MAX_RANK];
+} H5VL_dset_split_box_t;
+
+/* Dataset operations run by the asynchronous engine */
+typedef enum H5VL_dset_split_task_op_t {
+    H5VL_DSET_SPLIT_TASK_CREATE,
+    H5VL_DSET_SPLIT_TASK_READ,
+    H5VL_DSET_SPLIT_TASK_WRITE,
+    H5VL_DSET_SPLIT_TASK_FLUSH,
+    H5VL_DSET_SPLIT_TASK_CLOSE,
+    H5VL_DSET_SPLIT_TASK_PREFETCH /* Fills the read-ahead window, without a request */
+} H5VL_dset_split_task_op_t;
+
+/* An asynchronous dataset operation, shared by its request and the engine */
+typedef struct H5VL_dset_split_task_t {
+    H5VL_dset_split_task_op_t op;
+    struct H5VL_dset_split_t *dset;   /* Dataset operated on, a placeholder until created */
+    struct H5VL_dset_split_t *parent; /* Location of a dataset creation */
+    H5I_type_t parent_type;           /* Its object type */
+    char *name;                       /* Name of a created dataset */
+    hid_t lcpl_id;                    /* Copies of the operation's arguments */
+    hid_t dcpl_id;
+    hid_t dapl_id;
+    hid_t type_id;                    /* Dataset type when created, memory type when read or written */
+    hid_t space_id;                   /* Dataspace when created, memory selection when read or written */
+    hid_t file_space_id;
+    hid_t dxpl_id;
+    hid_t dset_id;                    /* Dataset ID of a flush */
+    void *buf;                        /* Application buffer, held by the application until completion */
+    H5VL_request_status_t status;
+    hid_t err_stack_id;               /* Errors of a failed task */
+    uint64_t exec_ts;                 /* Start time, in microseconds */
+    uint64_t exec_time;               /* Run time, in microseconds */
+    H5VL_request_notify_t notify_cb;  /* Called on completion */
+    void *notify_ctx;
+    unsigned nrefs;                   /* Held by the request and by the engine until completion */
+    struct H5VL_dset_split_queue_t *queue; /* Queue of the task's dataset */
+    struct H5VL_dset_split_task_t *next;   /* Next task of the same dataset */
+} H5VL_dset_split_task_t;
+
+/* Tasks of one dataset, run one after the other in submission order */
+typedef struct H5VL_dset_split_queue_t {
+    H5VL_dset_split_task_t *head;
+    H5VL_dset_split_task_t *tail;
+    hbool_t running;                  /* A worker runs a task of the queue */
+    pthread_t runner;                 /* That worker */
+    hbool_t ready;                    /* In the engine's ready list */
+    hbool_t orphaned;                 /* The dataset was released while a task ran, the worker frees the queue */
+    struct H5VL_dset_split_queue_t *ready_next;
+} H5VL_dset_split_queue_t;
+
+/* Connector-owned thread pool running dataset operations asynchronously */
+typedef struct H5VL_dset_split_async_t {
+    unsigned nthreads;                /* Number of worker threads to run (0 disables the engine) */
+    unsigned nworkers;                /* Number of worker threads started */
+    pthread_t *workers;
+    pthread_mutex_t mutex;            /* Protects the queues and the tasks' status */
+    pthread_cond_t work_cond;         /* Signaled when a queue is ready or on shutdown */
+    pthread_cond_t done_cond;         /* Broadcast when a task completes */
+    H5VL_dset_split_queue_t *ready_head; /* Queues with a task to run and no task running */
+    H5VL_dset_split_queue_t *ready_tail;
+    size_t npending;                  /* Number of tasks queued or running */
+    hbool_t shutdown;                 /* Asks the workers to exit */
+} H5VL_dset_split_async_t;
+
+/* A byte range of a split file, read or written around the HDF5 library */
+typedef struct H5VL_dset_split_direct_t {
+    int fd;             /* Descriptor of the split file */
+    off_t offset;       /* Position in the split file */
+    size_t nbytes;
+    void *buf;          /* Application buffer */
+    H5VL_dset_split_pool_entry_t *split_file; /* Borrowed until the job is done, keeping 'fd' open */
+} H5VL_dset_split_direct_t;
+
+/* Direct I/O jobs of a multi-dataset read or write, one thread per split file */
+typedef struct H5VL_dset_split_direct_batch_t {
+    H5VL_dset_split_direct_t *jobs;
+    size_t njobs;
+    hbool_t write;      /* Write, else read */
+    size_t *groups;     /* First job of each split file, and 'njobs' */
+    size_t ngroups;     /* Number of split files */
+    size_t next_group;  /* Next split file for a thread to take */
+    size_t nerrors;     /* Number of jobs that failed */
+    pthread_t threads[H5VL_DSET_SPLIT_DIRECT_THREADS_MAX];
+    size_t nthreads;
+    pthread_mutex_t mutex; /* Protects 'next_group' and 'nerrors' */
+} H5VL_dset_split_direct_batch_t;
+
+/* A run of elements, contiguous in row-major order, held by a write-behind buffer */
+typedef struct H5VL_dset_split_wb_run_t {
+    hsize_t start;       /* First element (linear index in the dataset) */
+    hsize_t nelem;
+    unsigned char *data; /* 'nelem' elements of the buffer's memory type */
+} H5VL_dset_split_wb_run_t;
+
+/* Small writes to a dataset, held back and written together */
+typedef struct H5VL_dset_split_wb_t {
+    hid_t type_id;       /* Memory type of the buffered elements */
+    size_t type_size;
+    hid_t space_id;      /* Extent of the dataset */
+    hid_t dxpl_id;       /* Transfer properties of the buffered writes */
+    H5VL_dset_split_wb_run_t *runs; /* Sorted, neither overlapping nor adjacent */
+    size_t nruns;
+    size_t nalloc;       /* Size of 'runs' */
+    hsize_t nbytes;      /* Bytes buffered */
+    struct H5VL_dset_split_t *dset;  /* Dataset the buffer belongs to */
+    struct H5VL_dset_split_wb_t *next; /* Next non-empty buffer of the same file */
+} H5VL_dset_split_wb_t;
+
+/* Sequential reads of a dataset and the window prefetched ahead of them */
+typedef struct H5VL_dset_split_ra_t {
+    hsize_t next_start;  /* Where the next read starts if the access is sequential */
+    hsize_t last_nelem;  /* Elements of the last read */
+    unsigned nseq;       /* Number of sequential reads in a row */
+    hid_t type_id;       /* Memory type of the window */
+    hid_t space_id;      /* Extent of the dataset */
+    hsize_t start;       /* First element (linear index) of the window */
+    hsize_t nelem;       /* Elements in the window */
+    unsigned char *data; /* The window, NULL if none */
+    hbool_t valid;       /* 'data' was read successfully */
+} H5VL_dset_split_ra_t;
+
+/* A contiguous dataset of a read-only split file, mapped into memory */
+typedef struct H5VL_dset_split_mapped_t {
+    const unsigned char *data; /* First byte of the dataset, NULL if it can't be mapped */
+    size_t nbytes;
+    hid_t type_id;             /* Dataset type */
+    size_t type_size;
+} H5VL_dset_split_mapped_t;
+
+/* A chunked dataset compressed with deflate, its chunks filtered by the connector */
+typedef struct H5VL_dset_split_zip_t {
+    hbool_t usable;      /* The connector can filter the chunks, else the library does */
+    int rank;
+    hsize_t chunk_dims[H5S_MAX_RANK];
+    size_t chunk_bytes;  /* Size of an uncompressed chunk */
+    hid_t type_id;       /* Dataset type */
+    size_t type_size;
+    int level;           /* Deflate level */
+    unsigned char *fill; /* User-defined fill value of an element, NULL if it is zero */
+} H5VL_dset_split_zip_t;
+
+/* A chunk of a dataset transfer through the chunk compression pipeline */
+typedef struct H5VL_dset_split_zip_chunk_t {
+    hsize_t offset[H5S_MAX_RANK]; /* First element of the chunk */
+    unsigned char *data; /* Chunk as stored in the file */
+    size_t nbytes;       /* Size of 'data' */
+    uint32_t filters;    /* Mask of the filters skipped for the chunk */
+    int status;          /* 0 until filtered, then 1, or -1 on failure */
+} H5VL_dset_split_zip_chunk_t;
+
+/* A dataset transfer through the chunk compression pipeline: threads compress
+ * or expand the chunks while the calling thread writes or reads them */
+typedef struct H5VL_dset_split_zip_batch_t {
+    const H5VL_dset_split_zip_t *zip;
+    hbool_t write;       /* Write, else read */
+    hsize_t start[H5S_MAX_RANK]; /* Block of the dataset transferred */
+    hsize_t end[H5S_MAX_RANK];
+    unsigned char *buf;  /* Application buffer */
+    hsize_t mem_dims[H5S_MAX_RANK];   /* Shape of the application buffer */
+    hsize_t mem_origin[H5S_MAX_RANK]; /* Element of the buffer holding 'start' */
+    H5VL_dset_split_zip_chunk_t *chunks;
+    size_t nchunks;
+    size_t next;         /* Next chunk for a thread to filter */
+    size_t nio;          /* Number of chunks written or read */
+    size_t nfiltered;    /* Number of chunks filtered */
+    size_t window;       /* Max. number of chunks between the two stages */
+    hbool_t abort;       /* The chunk I/O failed */
+    pthread_t threads[H5VL_DSET_SPLIT_ZIP_THREADS_MAX];
+    size_t nthreads;
+    pthread_mutex_t mutex; /* Protects the counters and the chunks' status */
+    pthread_cond_t cond;   /* Broadcast when a counter or a status changes */
+} H5VL_dset_split_zip_batch_t;
+
+/* Creation of a dataset deferred to its first write */
+typedef struct H5VL_dset_split_lazy_t {
+    void *loc_under;     /* Group of the dataset, held open meanwhile */
+    char *name;          /* Name of the dataset in the group */
+    char *path;          /* Absolute path of the dataset */
+    hid_t lcpl_id;       /* Copies of the creation arguments */
+    hid_t type_id;
+    hid_t space_id;
+    hid_t dcpl_id;
+    hid_t dapl_id;
+    struct H5VL_dset_split_t *dset;      /* Placeholder dataset the application holds */
+    struct H5VL_dset_split_lazy_t *next; /* Next deferred creation of the file */
+} H5VL_dset_split_lazy_t;
+
+/* A dataset closed in its split file to stay within 'max_open_files' or 'mem_budget', reopened on next access */
+typedef struct H5VL_dset_split_detached_t {
+    char *file_name;  /* Split file */
+    char *obj_path;   /* Path of the dataset in the split file */
+    unsigned flags;   /* Access flags the split file was opened with */
+    hid_t dapl_id;    /* Access properties the dataset was opened with */
+} H5VL_dset_split_detached_t;
+
 /* The dset_split VOL info object */
 typedef struct H5VL_dset_split_t {
     hid_t under_vol_id; /* ID for underlying VOL connector */
@@ -60,12 +483,29 @@ typedef struct H5VL_dset_split_t {
     H5I_type_t type;
     hid_t fid;
     int set;
+    H5VL_dset_split_pool_entry_t *split_file; /* Pool entry of the split file hosting the dataset */
+    H5VL_dset_split_file_ctx_t *file_ctx;     /* Metadata of the main file, NULL until needed */
+    H5VL_dset_split_main_t *main_file;        /* Set for a main file, its entry among the open main files */
+    H5VL_dset_split_subfile_t *subfile;       /* Set for a dataset written to rank-local split files */
+    H5VL_dset_split_queue_t *queue;           /* Asynchronous tasks of a dataset, NULL if none were submitted */
+    H5VL_dset_split_task_t *task;             /* Set for a request of the asynchronous engine */
+    H5VL_dset_split_wb_t *wb;                 /* Buffered small writes of a dataset, NULL if none */
+    H5VL_dset_split_ra_t *ra;                 /* Read-ahead of a dataset, NULL until read */
+    H5VL_dset_split_mapped_t *map;            /* Mapped view of a dataset, NULL until read */
+    H5VL_dset_split_zip_t *zip;               /* Chunk filtering of a dataset, NULL until transferred */
+    H5VL_dset_split_lazy_t *lazy;             /* Set for a dataset whose creation is deferred */
+    H5VL_dset_split_detached_t *detached;     /* Set for a dataset whose split file was closed meanwhile */
+    struct H5VL_dset_split_t *user_prev;      /* Other datasets opened from the same split file */
+    struct H5VL_dset_split_t *user_next;
+    size_t cache_bytes;                       /* Chunk cache of the dataset, counted in the memory budget */
+    uint64_t cache_weight;                    /* Weight of the dataset in the memory budget */
 } H5VL_dset_split_t;
 
 /* The dset_split VOL wrapper context */
 typedef struct H5VL_dset_split_wrap_ctx_t {
     hid_t under_vol_id;   /* VOL ID for under VOL */
     void *under_wrap_ctx; /* Object wrapping context for under VOL */
+    H5VL_dset_split_file_ctx_t *file_ctx; /* Metadata of the main file, passed on to wrapped objects */
 } H5VL_dset_split_wrap_ctx_t;
 
 /********************* */
@@ -76,9 +516,48 @@ typedef struct H5VL_dset_split_wrap_ctx_t {
 
 static H5VL_dset_split_t *H5VL_dset_split_new_obj(void *under_obj, hid_t under_vol_id);
 static herr_t H5VL_dset_split_free_obj(H5VL_dset_split_t *obj);
-herr_t dset_split_create_attribute(hid_t file_id);
-hid_t dset_split_file_create(const char* name, void* obj, H5I_type_t obj_type, hid_t connector_id);
+herr_t dset_split_create_attribute(hid_t file_id, const char *owner);
+hid_t dset_split_file_create(const char* name, const H5VL_dset_split_file_ctx_t *file_ctx, unsigned flags);
 hid_t get_parent_file_fapl(void* file_obj, hid_t connector_id);
+static H5VL_dset_split_pool_entry_t *dset_split_pool_insert(const char *path, hid_t fid, unsigned flags);
+static H5VL_dset_split_pool_entry_t *dset_split_pool_open(const char *path, unsigned flags, hid_t fapl_id);
+static herr_t dset_split_pool_release(H5VL_dset_split_pool_entry_t *entry);
+static herr_t dset_split_pool_evict(size_t keep);
+static herr_t dset_split_pool_evict_folder(const char *folder);
+static herr_t dset_split_pool_resize(void);
+static void dset_split_pool_trim(void);
+static void dset_split_gov_files(H5VL_dset_split_pool_entry_t *opened);
+static hid_t dset_split_gov_dapl(H5VL_dset_split_pool_entry_t *entry, hid_t dapl_id);
+static void dset_split_user_bind(H5VL_dset_split_t *o);
+static void dset_split_user_moved(H5VL_dset_split_t *o);
+static void *get_parent_file_obj(void* obj, H5I_type_t obj_type, hid_t connector_id);
+static H5VL_dset_split_file_ctx_t *dset_split_file_ctx_get(H5VL_dset_split_t *o, H5I_type_t obj_type);
+static void dset_split_file_ctx_release(H5VL_dset_split_file_ctx_t *file_ctx);
+static void dset_split_main_release(H5VL_dset_split_main_t *main_file);
+static H5VL_dset_split_policy_t *dset_split_policy_compile(const char *str);
+static void dset_split_policy_free(H5VL_dset_split_policy_t *policy);
+static void dset_split_inherit_file_ctx(H5VL_dset_split_t *child, const H5VL_dset_split_t *parent);
+static void dset_split_subfile_free(H5VL_dset_split_subfile_t *subfile);
+static herr_t dset_split_mirror_collect(hid_t group, const char *name, const H5L_info2_t *info, void *op_data);
+static H5VL_dset_split_pool_entry_t *dset_split_reserve_take(const H5VL_dset_split_file_ctx_t *file_ctx,
+                                                             const char *path);
+static void dset_split_reserve_refill(void);
+static void dset_split_reserve_drain(const char *folder);
+#ifdef H5_HAVE_THREADSAFE
+static unsigned dset_split_hdf5_unlock(void);
+static void dset_split_hdf5_lock(unsigned count);
+#endif
+static void dset_split_async_sync(H5VL_dset_split_t *o);
+static void dset_split_async_drain(void);
+static void dset_split_queue_release(H5VL_dset_split_queue_t *queue);
+static herr_t dset_split_ra_fill(H5VL_dset_split_t *o, hid_t dxpl_id);
+static void dset_split_ra_invalidate(H5VL_dset_split_t *o);
+static void *dset_split_dataset_create(void *obj, const H5VL_loc_params_t *loc_params, const char *name,
+                                       hid_t lcpl_id, hid_t type_id, hid_t space_id, hid_t dcpl_id,
+                                       hid_t dapl_id, hid_t dxpl_id, void **req, unsigned flags);
+herr_t dset_create_split_folder (char* name);
+void dset_get_normalized_name (char* name);
+size_t get_file_name(void* obj, hid_t connector_id, H5I_type_t type, char* name, size_t size);
 
 
 /* Management callbacks */
@@ -244,7 +723,7 @@ static const H5VL_class_t H5VL_dset_split_g = {
     (H5VL_class_value_t)H5VL_DSET_SPLIT_VALUE, /* value        */
     H5VL_DSET_SPLIT_NAME,                      /* name         */
     H5VL_DSET_SPLIT_VERSION,                   /* connector version */
-    0,                                       /* capability flags */
+    H5VL_DSET_SPLIT_CAP_FLAGS,               /* capability flags */
     H5VL_dset_split_init,                  /* initialize   */
     H5VL_dset_split_term,                  /* terminate    */
     {
@@ -371,6 +850,24 @@ static hid_t H5VL_DSET_SPLIT_g = H5I_INVALID_HID;
 hid_t H5VL_ERR_STACK_g = H5I_INVALID_HID;
 hid_t H5VL_ERR_CLS_g = H5I_INVALID_HID;
 
+/* The split file pool */
+static H5VL_dset_split_pool_t H5VL_dset_split_pool_g = {NULL, 0, 0, 0, 0, 0, NULL, NULL};
+
+/* Main files opened through the connector */
+static H5VL_dset_split_main_t *H5VL_dset_split_mains_g = NULL;
+
+/* Memory budget of the split files' caches */
+static H5VL_dset_split_gov_t H5VL_dset_split_gov_g = {0, 0, 0, 0, 0};
+
+/* Pre-created split files */
+static H5VL_dset_split_precreate_t H5VL_dset_split_precreate_g = {0, NULL, 0, FALSE, PTHREAD_MUTEX_INITIALIZER,
+                                                                  FALSE, FALSE};
+
+/* Asynchronous engine */
+static H5VL_dset_split_async_t H5VL_dset_split_async_g = {0, 0, NULL, PTHREAD_MUTEX_INITIALIZER,
+                                                          PTHREAD_COND_INITIALIZER, PTHREAD_COND_INITIALIZER,
+                                                          NULL, NULL, 0, FALSE};
+
 /****Helper Functions*****/
 
 /*-------------------------------------------------------------------------
@@ -564,8 +1061,9 @@ get_file_name(void* obj, hid_t connector_id, H5I_type_t type, char* name, size_t
 /*-------------------------------------------------------------------------
  * Function:    dset_split_file_create
  *
- * Purpose:     Helper funtion to create file
- *              
+ * Purpose:     Helper funtion to create file, with the split file
+ *              properties prepared for the main file and the H5Fcreate
+ *              'flags'
  *
  * Return:      Success:    0
  *              Failure:    -1
@@ -574,34 +1072,13 @@ get_file_name(void* obj, hid_t connector_id, H5I_type_t type, char* name, size_t
  */
 
 hid_t 
-dset_split_file_create(const char* name, void* obj, H5I_type_t obj_type, hid_t connector_id)
+dset_split_file_create(const char* name, const H5VL_dset_split_file_ctx_t *file_ctx, unsigned flags)
 {
     hid_t  file_id = -1;
-    void * vol_obj_file = NULL;
-    H5VL_object_get_args_t vol_cb_args;
-    H5VL_loc_params_t      loc_params;
     FUNC_ENTER_VOL( hid_t, H5I_INVALID_HID)
 
-    loc_params.type     = H5VL_OBJECT_BY_SELF;
-    loc_params.obj_type = obj_type;
-
-    vol_cb_args.op_type            = H5VL_OBJECT_GET_FILE;
-    vol_cb_args.args.get_file.file = &vol_obj_file;
-
-    if (H5VLobject_get(obj, &loc_params, connector_id, &vol_cb_args, H5P_DATASET_XFER_DEFAULT, NULL) < 0)
-        HGOTO_ERROR(H5E_VOL, H5E_CANTGET, H5I_INVALID_HID, "can't retrieve file from object");
-
-    hid_t pfcpl_id = get_parent_file_fcpl(vol_obj_file, connector_id);
-    hid_t fcpl_id = H5Pcopy(pfcpl_id);
-    hid_t pfapl_id = get_parent_file_fapl(vol_obj_file, connector_id);
-    hid_t fapl_id = H5Pcopy(pfapl_id);
-
-    file_id = H5Fcreate(name, H5F_ACC_EXCL, fcpl_id, fapl_id);
-	
-    H5Pclose(fapl_id);
-    H5Pclose(pfapl_id);
-    H5Pclose(fcpl_id);
-    H5Pclose(pfcpl_id);
+    if ((file_id = H5Fcreate(name, flags, file_ctx->fcpl_id, file_ctx->fapl_id)) < 0)
+        HGOTO_ERROR(H5E_VOL, H5E_CANTCREATE, H5I_INVALID_HID, "can't create the split file");
 
 #ifdef DEBUG
     if( file_id < 0 )
@@ -617,7 +1094,8 @@ dset_split_file_create(const char* name, void* obj, H5I_type_t obj_type, hid_t c
  * Function:    dset_split_create_attribute
  *
  * Purpose:     Creates a attribute named 'split_file' to identify the 
- *              file as split file
+ *              file as split file, and one named 'split_owner' holding
+ *              the name of the main file 'owner' it belongs to
  *
  * Return:      Success:    0
  *              Failure:    -1
@@ -626,7 +1104,7 @@ dset_split_file_create(const char* name, void* obj, H5I_type_t obj_type, hid_t c
  */
 
 herr_t 
-dset_split_create_attribute(hid_t file_id)
+dset_split_create_attribute(hid_t file_id, const char *owner)
 {
     int value = 1;
     hid_t intType = H5Tcopy(H5T_NATIVE_INT32);
@@ -634,67 +1112,156 @@ dset_split_create_attribute(hid_t file_id)
     hid_t attr= H5Acreate(file_id, ATTRIBUTE_NAME, intType, valueSpace,
                                             H5P_DEFAULT, H5P_DEFAULT);
     herr_t status= H5Awrite(attr, intType, &value);
-    H5Sclose(valueSpace);
     H5Aclose(attr);
+    H5Tclose(intType);
+
+    if (status >= 0) {
+        hid_t strType = H5Tcopy(H5T_C_S1);
+
+        status = H5Tset_size(strType, strlen(owner) + 1);
+        attr   = H5Acreate(file_id, OWNER_ATTRIBUTE_NAME, strType, valueSpace, H5P_DEFAULT, H5P_DEFAULT);
+        if (status < 0 || attr < 0 || H5Awrite(attr, strType, owner) < 0)
+            status = -1;
+        if (attr >= 0)
+            H5Aclose(attr);
+        H5Tclose(strType);
+    }
+    H5Sclose(valueSpace);
     return status;
 }
 
 /*-------------------------------------------------------------------------
- * Function:    H5VL__dset_split_new_obj
+ * Function:    dset_split_is_owner
  *
- * Purpose:     Create a new dset_split object for an underlying object
+ * Purpose:     Checks whether the split file 'file_id' was created for
+ *              the main file 'owner'. Split files without the
+ *              'split_owner' attribute belong to no main file.
  *
- * Return:      Success:    Pointer to the new dset_split object
- *              Failure:    NULL
+ * Return:      TRUE/FALSE
  *
  *-------------------------------------------------------------------------
  */
-static H5VL_dset_split_t *
-H5VL_dset_split_new_dataset_obj(void *under_obj, hid_t under_vol_id, hid_t fid, H5I_type_t type)
+static hbool_t
+dset_split_is_owner(hid_t file_id, const char *owner)
 {
-    H5VL_dset_split_t *new_obj;
+    hbool_t ret_value = FALSE;
+    hid_t   attr      = H5I_INVALID_HID;
+    hid_t   type      = H5I_INVALID_HID;
+    char *  name      = NULL;
+    size_t  size;
 
-    new_obj               = (H5VL_dset_split_t *)calloc(1, sizeof(H5VL_dset_split_t));
-    new_obj->under_object = under_obj;
-    new_obj->under_vol_id = under_vol_id;
-    new_obj->fid          = fid;
-    new_obj->type         = type;
-    new_obj->set          = 1;
-    H5Iinc_ref(new_obj->under_vol_id);
+    H5E_BEGIN_TRY
+    {
+        if ((attr = H5Aopen(file_id, OWNER_ATTRIBUTE_NAME, H5P_DEFAULT)) < 0 || (type = H5Aget_type(attr)) < 0)
+            goto done;
+        if (H5Tget_class(type) != H5T_STRING || H5Tis_variable_str(type) != 0 ||
+            (size = H5Tget_size(type)) != strlen(owner) + 1)
+            goto done;
+        if (NULL == (name = (char *)malloc(size)) || H5Aread(attr, type, name) < 0)
+            goto done;
+        ret_value = (hbool_t)(name[size - 1] == '\0' && !strcmp(name, owner));
+
+done:
+        if (type >= 0)
+            H5Tclose(type);
+        if (attr >= 0)
+            H5Aclose(attr);
+    }
+    H5E_END_TRY;
+    free(name);
 
-    return new_obj;
-} /* end H5VL__dset_split_new_obj() */
+    return ret_value;
+}
 
 /*-------------------------------------------------------------------------
- * Function:    H5VL__dset_split_new_obj
+ * Function:    dset_split_hash_str
  *
- * Purpose:     Create a new dset_split object for an underlying object
+ * Purpose:     64-bit FNV-1a hash of a string
  *
- * Return:      Success:    Pointer to the new dset_split object
- *              Failure:    NULL
+ * Return:      Hash value
  *
  *-------------------------------------------------------------------------
  */
-static H5VL_dset_split_t *
-H5VL_dset_split_new_obj(void *under_obj, hid_t under_vol_id)
+static uint64_t
+dset_split_hash_str(const char *str)
 {
-    H5VL_dset_split_t *new_obj;
+    uint64_t hash = 14695981039346656037ULL;
 
-    new_obj               = (H5VL_dset_split_t *)calloc(1, sizeof(H5VL_dset_split_t));
-    new_obj->under_object = under_obj;
-    new_obj->under_vol_id = under_vol_id;
-    H5Iinc_ref(new_obj->under_vol_id);
+    while (*str) {
+        hash ^= (uint8_t)*str++;
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
 
-    return new_obj;
-} /* end H5VL__dset_split_new_obj() */
+/*-------------------------------------------------------------------------
+ * Function:    dset_split_pool_lookup
+ *
+ * Purpose:     Finds the open split file 'path' in the split file pool
+ *
+ * Return:      Success:    Pool entry
+ *              Failure:    NULL, if the split file is not in the pool
+ *
+ *-------------------------------------------------------------------------
+ */
+static H5VL_dset_split_pool_entry_t *
+dset_split_pool_lookup(const char *path)
+{
+    H5VL_dset_split_pool_t *      pool = &H5VL_dset_split_pool_g;
+    H5VL_dset_split_pool_entry_t *entry;
+
+    if (!pool->buckets)
+        return NULL;
+
+    entry = pool->buckets[dset_split_hash_str(path) % pool->nbuckets];
+    while (entry && strcmp(entry->path, path) != 0)
+        entry = entry->hash_next;
+
+    return entry;
+}
 
 /*-------------------------------------------------------------------------
- * Function:    H5VL__dset_split_free_obj
+ * Function:    dset_split_pool_lru_unlink / dset_split_pool_lru_push
  *
- * Purpose:     Release a dset_split object
+ * Purpose:     Removes an entry from / inserts an entry at the head of
+ *              the LRU list of the split file pool
  *
- * Note:	Take care to preserve the current HDF5 error stack
- *		when calling HDF5 API calls.
+ *-------------------------------------------------------------------------
+ */
+static void
+dset_split_pool_lru_unlink(H5VL_dset_split_pool_entry_t *entry)
+{
+    H5VL_dset_split_pool_t *pool = &H5VL_dset_split_pool_g;
+
+    if (entry->prev)
+        entry->prev->next = entry->next;
+    else
+        pool->head = entry->next;
+    if (entry->next)
+        entry->next->prev = entry->prev;
+    else
+        pool->tail = entry->prev;
+    entry->prev = entry->next = NULL;
+}
+
+static void
+dset_split_pool_lru_push(H5VL_dset_split_pool_entry_t *entry)
+{
+    H5VL_dset_split_pool_t *pool = &H5VL_dset_split_pool_g;
+
+    entry->prev = NULL;
+    entry->next = pool->head;
+    if (pool->head)
+        pool->head->prev = entry;
+    else
+        pool->tail = entry;
+    pool->head = entry;
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    dset_split_pool_grow
+ *
+ * Purpose:     Doubles the number of hash buckets of the split file pool
  *
  * Return:      Success:    0
  *              Failure:    -1
@@ -702,48 +1269,83 @@ H5VL_dset_split_new_obj(void *under_obj, hid_t under_vol_id)
  *-------------------------------------------------------------------------
  */
 static herr_t
-H5VL_dset_split_free_obj(H5VL_dset_split_t *obj)
+dset_split_pool_grow(void)
 {
-    hid_t err_id;
+    H5VL_dset_split_pool_t *       pool = &H5VL_dset_split_pool_g;
+    H5VL_dset_split_pool_entry_t **buckets;
+    H5VL_dset_split_pool_entry_t * entry;
+    size_t                         nbuckets = pool->nbuckets ? 2 * pool->nbuckets : H5VL_DSET_SPLIT_POOL_NBUCKETS;
 
-    err_id = H5Eget_current_stack();
+    if (NULL == (buckets = (H5VL_dset_split_pool_entry_t **)calloc(nbuckets, sizeof(*buckets))))
+        return -1;
 
-    H5Idec_ref(obj->under_vol_id);
+    /* Rehash the open split files, walking the LRU list */
+    for (entry = pool->head; entry; entry = entry->next) {
+        size_t idx = dset_split_hash_str(entry->path) % nbuckets;
 
-    H5Eset_current_stack(err_id);
+        entry->hash_next = buckets[idx];
+        buckets[idx]     = entry;
+    }
 
-    free(obj);
+    if (pool->buckets)
+        free(pool->buckets);
+    pool->buckets  = buckets;
+    pool->nbuckets = nbuckets;
 
     return 0;
-} /* end H5VL__dset_split_free_obj() */
+}
 
 /*-------------------------------------------------------------------------
- * Function:    H5VL_dset_split_register
+ * Function:    dset_split_pool_insert
  *
- * Purpose:     Register the dset_split VOL connector and retrieve an ID
- *              for it.
+ * Purpose:     Adds the open split file 'fid' to the split file pool.
+ *              The caller becomes the first borrower of the file. Older
+ *              split files are closed if there are too many open.
  *
- * Return:      Success:    The ID for the dset_split VOL connector
- *              Failure:    -1
+ * Return:      Success:    Pool entry
+ *              Failure:    NULL
  *
  *-------------------------------------------------------------------------
  */
-hid_t
-H5VL_dset_split_register(void)
+static H5VL_dset_split_pool_entry_t *
+dset_split_pool_insert(const char *path, hid_t fid, unsigned flags)
 {
-    /* Singleton register the dset_split VOL connector ID */
-    if (H5VL_DSET_SPLIT_g < 0)
-        H5VL_DSET_SPLIT_g = H5VLregister_connector(&H5VL_dset_split_g, H5P_DEFAULT);
+    H5VL_dset_split_pool_t *      pool = &H5VL_dset_split_pool_g;
+    H5VL_dset_split_pool_entry_t *entry;
+    size_t                        idx;
 
-    return H5VL_DSET_SPLIT_g;
-} /* end H5VL_dset_split_register() */
+    if (!pool->buckets || pool->nentries >= 2 * pool->nbuckets)
+        if (dset_split_pool_grow() < 0)
+            return NULL;
+
+    if (NULL == (entry = (H5VL_dset_split_pool_entry_t *)calloc(1, sizeof(H5VL_dset_split_pool_entry_t))))
+        return NULL;
+    if (NULL == (entry->path = strdup(path))) {
+        free(entry);
+        return NULL;
+    }
+    entry->fid   = fid;
+    entry->flags = flags;
+    entry->nrefs = 1;
+
+    idx                 = dset_split_hash_str(path) % pool->nbuckets;
+    entry->hash_next    = pool->buckets[idx];
+    pool->buckets[idx]  = entry;
+    dset_split_pool_lru_push(entry);
+    pool->nentries++;
+
+    /* Stay within the budget of open split files, and share the memory budget with the new one */
+    dset_split_pool_trim();
+    dset_split_gov_files(entry);
+
+    return entry;
+}
 
 /*-------------------------------------------------------------------------
- * Function:    H5VL_dset_split_init
+ * Function:    dset_split_pool_remove
  *
- * Purpose:     Initialize this VOL connector, performing any necessary
- *              operations for the connector that will apply to all containers
- *              accessed with the connector.
+ * Purpose:     Removes an entry from the split file pool and closes its
+ *              split file
  *
  * Return:      Success:    0
  *              Failure:    -1
@@ -751,111 +1353,7379 @@ H5VL_dset_split_register(void)
  *-------------------------------------------------------------------------
  */
 static herr_t
-H5VL_dset_split_init(hid_t vipl_id)
+dset_split_pool_remove(H5VL_dset_split_pool_entry_t *entry)
 {
-#ifdef DEBUG
-    printf("DSET-SPLIT VOL INIT\n");
-#endif
+    H5VL_dset_split_pool_t *       pool = &H5VL_dset_split_pool_g;
+    H5VL_dset_split_pool_entry_t **slot;
+    herr_t                         ret_value;
 
-    /* Shut compiler up about unused parameter */
-    (void)vipl_id;
+    slot = &pool->buckets[dset_split_hash_str(entry->path) % pool->nbuckets];
+    while (*slot != entry)
+        slot = &(*slot)->hash_next;
+    *slot = entry->hash_next;
 
-    return 0;
-} /* end H5VL_dset_split_init() */
+    dset_split_pool_lru_unlink(entry);
+    pool->nentries--;
 
-/*---------------------------------------------------------------------------
- * Function:    H5VL_dset_split_term
+    ret_value = H5Fclose(entry->fid);
+    if (entry->map)
+        munmap((void *)entry->map, entry->map_size);
+
+    free(entry->path);
+    free(entry);
+
+    /* The split files left get a larger part of the memory budget */
+    dset_split_gov_files(NULL);
+
+    return ret_value;
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    dset_split_pool_map
  *
- * Purpose:     Terminate this VOL connector, performing any necessary
- *              operations for the connector that release connector-wide
- *              resources (usually created / initialized with the 'init'
- *              callback).
+ * Purpose:     Maps a read-only split file into memory, once. The mapping
+ *              lasts until the split file is closed.
  *
  * Return:      Success:    0
- *              Failure:    (Can't fail)
+ *              Failure:    -1, the split file can't be mapped
  *
- *---------------------------------------------------------------------------
+ *-------------------------------------------------------------------------
  */
 static herr_t
-H5VL_dset_split_term(void)
+dset_split_pool_map(H5VL_dset_split_pool_entry_t *entry)
 {
-#ifdef DEBUG
-    printf("DSET-SPLIT VOL TERM\n");
-#endif
+    struct stat st;
+    void *      map;
+    int         fd;
 
-    /* Reset VOL ID */
-    H5VL_DSET_SPLIT_g = H5I_INVALID_HID;
+    if (entry->map)
+        return 0;
+    if (entry->map_failed || (entry->flags & H5F_ACC_RDWR))
+        return -1;
+
+    entry->map_failed = TRUE;
+    if ((fd = open(entry->path, O_RDONLY)) < 0)
+        return -1;
+    if (fstat(fd, &st) < 0 || st.st_size == 0 ||
+        MAP_FAILED == (map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0))) {
+        close(fd);
+        return -1;
+    }
+    close(fd);
+    entry->map        = (const unsigned char *)map;
+    entry->map_size   = (size_t)st.st_size;
+    entry->map_failed = FALSE;
 
     return 0;
-} /* end H5VL_dset_split_term() */
+}
 
-/*---------------------------------------------------------------------------
- * Function:    H5VL_dset_split_info_copy
+/*-------------------------------------------------------------------------
+ * Function:    dset_split_pool_open
  *
- * Purpose:     Duplicate the connector's info object.
+ * Purpose:     Borrows the split file 'path' from the split file pool,
+ *              opening it if it is not already open
  *
- * Returns:     Success:    New connector info object
+ * Return:      Success:    Pool entry
  *              Failure:    NULL
  *
- *---------------------------------------------------------------------------
+ *-------------------------------------------------------------------------
  */
-static void *
-H5VL_dset_split_info_copy(const void *_info)
+static H5VL_dset_split_pool_entry_t *
+dset_split_pool_open(const char *path, unsigned flags, hid_t fapl_id)
 {
-    const H5VL_dset_split_info_t *info = (const H5VL_dset_split_info_t *)_info;
-    H5VL_dset_split_info_t *      new_info;
+    H5VL_dset_split_pool_t *      pool = &H5VL_dset_split_pool_g;
+    H5VL_dset_split_pool_entry_t *entry;
+    hid_t                         fid;
+
+    if (NULL != (entry = dset_split_pool_lookup(path))) {
+        /* A read-only split file can't serve a read-write open. Reopen it, unless it is in use */
+        if ((flags & H5F_ACC_RDWR) && !(entry->flags & H5F_ACC_RDWR)) {
+            if (entry->nrefs > 0)
+                return NULL;
+            pool->nidle--;
+            if (dset_split_pool_remove(entry) < 0)
+                return NULL;
+        }
+        else {
+            if (entry->nrefs++ == 0)
+                pool->nidle--;
+            dset_split_pool_lru_unlink(entry);
+            dset_split_pool_lru_push(entry);
+            return entry;
+        }
+    }
 
-#ifdef DEBUG
-    printf("DSET-SPLIT VOL INFO Copy\n");
-#endif
+    H5E_BEGIN_TRY {
+        fid = H5Fopen(path, flags, fapl_id);
+    } H5E_END_TRY;
+    if (fid < 0)
+        return NULL;
 
-    /* Allocate new VOL info struct for the dset_split connector */
-    new_info = (H5VL_dset_split_info_t *)calloc(1, sizeof(H5VL_dset_split_info_t));
+    if (NULL == (entry = dset_split_pool_insert(path, fid, flags)))
+        H5Fclose(fid);
 
-    /* Increment reference count on underlying VOL ID, and copy the VOL info */
-    new_info->under_vol_id = info->under_vol_id;
-    H5Iinc_ref(new_info->under_vol_id);
-    if (info->under_vol_info)
-        H5VLcopy_connector_info(new_info->under_vol_id, &(new_info->under_vol_info), info->under_vol_info);
+    return entry;
+}
 
-    return new_info;
-} /* end H5VL_dset_split_info_copy() */
+/*-------------------------------------------------------------------------
+ * Function:    dset_split_pool_release
+ *
+ * Purpose:     Returns a borrowed split file to the split file pool.
+ *              The split file stays open until it is evicted.
+ *
+ * Return:      Success:    0
+ *              Failure:    -1
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+dset_split_pool_release(H5VL_dset_split_pool_entry_t *entry)
+{
+    H5VL_dset_split_pool_t *pool = &H5VL_dset_split_pool_g;
 
-/*---------------------------------------------------------------------------
- * Function:    H5VL_dset_split_info_cmp
+    assert(entry->nrefs > 0);
+
+    if (--entry->nrefs == 0)
+        pool->nidle++;
+    dset_split_pool_lru_unlink(entry);
+    dset_split_pool_lru_push(entry);
+
+    return dset_split_pool_evict(pool->capacity);
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    dset_split_pool_evict
  *
- * Purpose:     Compare two of the connector's info objects, setting *cmp_value,
- *              following the same rules as strcmp().
+ * Purpose:     Closes the least recently used idle split files until at
+ *              most 'keep' idle split files remain open
  *
  * Return:      Success:    0
  *              Failure:    -1
  *
- *---------------------------------------------------------------------------
+ *-------------------------------------------------------------------------
  */
 static herr_t
-H5VL_dset_split_info_cmp(int *cmp_value, const void *_info1, const void *_info2)
+dset_split_pool_evict(size_t keep)
 {
-    const H5VL_dset_split_info_t *info1 = (const H5VL_dset_split_info_t *)_info1;
-    const H5VL_dset_split_info_t *info2 = (const H5VL_dset_split_info_t *)_info2;
+    H5VL_dset_split_pool_t *      pool = &H5VL_dset_split_pool_g;
+    H5VL_dset_split_pool_entry_t *entry, *prev;
+    herr_t                        ret_value = 0;
+
+    for (entry = pool->tail; entry && pool->nidle > keep; entry = prev) {
+        prev = entry->prev;
+        if (entry->nrefs == 0) {
+            pool->nidle--;
+            if (dset_split_pool_remove(entry) < 0)
+                ret_value = -1;
+        }
+    }
 
-#ifdef DEBUG 
-    printf("DSET-SPLIT VOL INFO Compare\n");
-#endif
+    return ret_value;
+}
 
-    /* Sanity checks */
-    assert(info1);
-    assert(info2);
+/*-------------------------------------------------------------------------
+ * Function:    dset_split_pool_evict_folder
+ *
+ * Purpose:     Closes the idle split files in the split folder 'folder',
+ *              those of the other main files stay open
+ *
+ * Return:      Success:    0
+ *              Failure:    -1
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+dset_split_pool_evict_folder(const char *folder)
+{
+    H5VL_dset_split_pool_t *      pool = &H5VL_dset_split_pool_g;
+    H5VL_dset_split_pool_entry_t *entry, *prev;
+    size_t                        len       = strlen(folder);
+    herr_t                        ret_value = 0;
+
+    for (entry = pool->tail; entry && pool->nidle > 0; entry = prev) {
+        prev = entry->prev;
+        if (entry->nrefs == 0 && !strncmp(entry->path, folder, len) && entry->path[len] == '/') {
+            pool->nidle--;
+            if (dset_split_pool_remove(entry) < 0)
+                ret_value = -1;
+        }
+    }
 
-    /* Initialize comparison value */
-    *cmp_value = 0;
+    return ret_value;
+}
 
-    /* Compare under VOL connector classes */
-    H5VLcmp_connector_cls(cmp_value, info1->under_vol_id, info2->under_vol_id);
+/*-------------------------------------------------------------------------
+ * Function:    dset_split_pool_rename
+ *
+ * Purpose:     Renames the open split files of the split file pool that
+ *              were renamed on disk from 'old_name' to 'new_name', or
+ *              moved with their subfolder when both end with '/'
+ *
+ * Return:      Success:    0
+ *              Failure:    -1
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+dset_split_pool_rename(const char *old_name, const char *new_name)
+{
+    H5VL_dset_split_pool_t *       pool    = &H5VL_dset_split_pool_g;
+    H5VL_dset_split_pool_entry_t * entry;
+    H5VL_dset_split_pool_entry_t **slot;
+    size_t                         old_len = strlen(old_name);
+    char *                         path;
+    size_t                         idx;
+    herr_t                         ret_value = 0;
+
+    for (entry = pool->head; entry; entry = entry->next) {
+        if (strncmp(entry->path, old_name, old_len) != 0 ||
+            (old_name[old_len - 1] != '/' && entry->path[old_len] != '\0'))
+            continue;
+        if (NULL == (path = (char *)malloc(strlen(new_name) + strlen(entry->path + old_len) + 1))) {
+            ret_value = -1;
+            continue;
+        }
+        sprintf(path, "%s%s", new_name, entry->path + old_len);
+
+        /* Move the entry to the bucket of its new name */
+        slot = &pool->buckets[dset_split_hash_str(entry->path) % pool->nbuckets];
+        while (*slot != entry)
+            slot = &(*slot)->hash_next;
+        *slot = entry->hash_next;
+        free(entry->path);
+        entry->path        = path;
+        idx                = dset_split_hash_str(path) % pool->nbuckets;
+        entry->hash_next   = pool->buckets[idx];
+        pool->buckets[idx] = entry;
+    }
+
+    return ret_value;
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    get_parent_file_obj
+ *
+ * Purpose:     Helper funtion to get the file object an object belongs to
+ *
+ * Return:      Success:    File object
+ *              Failure:    NULL
+ *
+ *-------------------------------------------------------------------------
+ */
+static void *
+get_parent_file_obj(void* obj, H5I_type_t obj_type, hid_t connector_id)
+{
+    void * vol_obj_file = NULL;
+    H5VL_object_get_args_t vol_cb_args;
+    H5VL_loc_params_t      loc_params;
+
+    loc_params.type     = H5VL_OBJECT_BY_SELF;
+    loc_params.obj_type = obj_type;
+
+    vol_cb_args.op_type            = H5VL_OBJECT_GET_FILE;
+    vol_cb_args.args.get_file.file = &vol_obj_file;
+
+    if (H5VLobject_get(obj, &loc_params, connector_id, &vol_cb_args, H5P_DATASET_XFER_DEFAULT, NULL) < 0)
+        return NULL;
+
+    return vol_obj_file;
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    dset_split_str_to_mode
+ *
+ * Purpose:     Parses a dataset placement: "own" (or "dataset"), "group"
+ *              or "inline", 'len' characters long
+ *
+ * Return:      Success:    0
+ *              Failure:    -1
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+dset_split_str_to_mode(const char *str, size_t len, H5VL_dset_split_mode_t *mode)
+{
+    if ((len == strlen("own") && !strncmp(str, "own", len)) ||
+        (len == strlen("dataset") && !strncmp(str, "dataset", len)))
+        *mode = H5VL_DSET_SPLIT_MODE_DATASET;
+    else if (len == strlen("group") && !strncmp(str, "group", len))
+        *mode = H5VL_DSET_SPLIT_MODE_GROUP;
+    else if (len == strlen("inline") && !strncmp(str, "inline", len))
+        *mode = H5VL_DSET_SPLIT_MODE_INLINE;
+    else
+        return -1;
+
+    return 0;
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    dset_split_mode_to_str
+ *
+ * Purpose:     Names a dataset placement, the way dset_split_str_to_mode
+ *              parses it
+ *
+ *-------------------------------------------------------------------------
+ */
+static const char *
+dset_split_mode_to_str(H5VL_dset_split_mode_t mode)
+{
+    switch (mode) {
+        case H5VL_DSET_SPLIT_MODE_GROUP:
+            return "group";
+        case H5VL_DSET_SPLIT_MODE_INLINE:
+            return "inline";
+        case H5VL_DSET_SPLIT_MODE_DATASET:
+        default:
+            return "dataset";
+    }
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    dset_split_policy_free
+ *
+ * Purpose:     Releases a compiled split policy
+ *
+ *-------------------------------------------------------------------------
+ */
+static void
+dset_split_policy_free(H5VL_dset_split_policy_t *policy)
+{
+    size_t u;
+
+    for (u = 0; u < policy->nrules; u++)
+        free(policy->rules[u].pattern);
+    free(policy->rules);
+    free(policy);
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    dset_split_policy_compile
+ *
+ * Purpose:     Compiles a split policy table, "pattern:placement" rules
+ *              separated by ';' or ','. Patterns are shell globs matched
+ *              against absolute dataset paths. The common shapes, a plain
+ *              path, "prefix*", "*suffix" and "*", are recognized here so
+ *              matching them is a single string compare.
+ *
+ * Return:      Success:    Compiled policy
+ *              Failure:    NULL
+ *
+ *-------------------------------------------------------------------------
+ */
+static H5VL_dset_split_policy_t *
+dset_split_policy_compile(const char *str)
+{
+    H5VL_dset_split_policy_t *policy;
+    const char *              p;
+    size_t                    nalloc = 1;
+
+    for (p = str; *p; p++)
+        if (*p == ';' || *p == ',')
+            nalloc++;
+
+    if (NULL == (policy = (H5VL_dset_split_policy_t *)calloc(1, sizeof(H5VL_dset_split_policy_t))))
+        return NULL;
+    if (NULL == (policy->rules = (H5VL_dset_split_rule_t *)calloc(nalloc, sizeof(H5VL_dset_split_rule_t))))
+        goto error;
+
+    for (p = str; *p;) {
+        H5VL_dset_split_rule_t *rule;
+        const char *            end = p + strcspn(p, ";,");
+        const char *            colon;
+        const char *            pat;
+        size_t                  pat_len;
+        size_t                  u;
+
+        while (p < end && *p == ' ')
+            p++;
+        if (p == end) {
+            p = *end ? end + 1 : end;
+            continue;
+        }
+
+        for (colon = end - 1; colon > p && *colon != ':'; colon--)
+            ;
+        if (*colon != ':')
+            goto error;
+
+        rule = &policy->rules[policy->nrules];
+        for (pat_len = (size_t)(end - colon - 1); pat_len > 0 && colon[pat_len] == ' '; pat_len--)
+            ;
+        if (dset_split_str_to_mode(colon + 1, pat_len, &rule->placement) < 0)
+            goto error;
+
+        pat     = p;
+        pat_len = (size_t)(colon - p);
+        while (pat_len > 0 && pat[pat_len - 1] == ' ')
+            pat_len--;
+        if (pat_len == 0)
+            goto error;
+
+        /* Classify the pattern by where its wildcards are */
+        rule->match = H5VL_DSET_SPLIT_MATCH_EXACT;
+        for (u = 0; u < pat_len; u++)
+            if (pat[u] == '*' || pat[u] == '?' || pat[u] == '[')
+                rule->match = H5VL_DSET_SPLIT_MATCH_GLOB;
+        if (rule->match == H5VL_DSET_SPLIT_MATCH_GLOB) {
+            size_t nwild = 0;
+
+            for (u = 0; u < pat_len; u++)
+                if (pat[u] == '*' || pat[u] == '?' || pat[u] == '[')
+                    nwild++;
+            if (pat_len == 1 && pat[0] == '*')
+                rule->match = H5VL_DSET_SPLIT_MATCH_ANY;
+            else if (nwild == 1 && pat[pat_len - 1] == '*')
+                rule->match = H5VL_DSET_SPLIT_MATCH_PREFIX;
+            else if (nwild == 1 && pat[0] == '*') {
+                rule->match = H5VL_DSET_SPLIT_MATCH_SUFFIX;
+                pat++;
+            }
+            if (rule->match == H5VL_DSET_SPLIT_MATCH_PREFIX || rule->match == H5VL_DSET_SPLIT_MATCH_SUFFIX)
+                pat_len--;
+        }
+
+        if (NULL == (rule->pattern = (char *)malloc(pat_len + 1)))
+            goto error;
+        memcpy(rule->pattern, pat, pat_len);
+        rule->pattern[pat_len] = '\0';
+        rule->len              = pat_len;
+        policy->nrules++;
+
+        p = *end ? end + 1 : end;
+    }
+
+    return policy;
+
+error:
+    dset_split_policy_free(policy);
+    return NULL;
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    dset_split_policy_match
+ *
+ * Purpose:     Looks the placement of the dataset at 'path' up
+ *
+ * Return:      Placement of the first matching rule, 'dflt' if none
+ *
+ *-------------------------------------------------------------------------
+ */
+static H5VL_dset_split_mode_t
+dset_split_policy_match(const H5VL_dset_split_policy_t *policy, const char *path, H5VL_dset_split_mode_t dflt)
+{
+    size_t path_len = strlen(path);
+    size_t u;
+
+    for (u = 0; u < policy->nrules; u++) {
+        const H5VL_dset_split_rule_t *rule = &policy->rules[u];
+
+        switch (rule->match) {
+            case H5VL_DSET_SPLIT_MATCH_ANY:
+                return rule->placement;
+            case H5VL_DSET_SPLIT_MATCH_EXACT:
+                if (path_len == rule->len && !memcmp(path, rule->pattern, path_len))
+                    return rule->placement;
+                break;
+            case H5VL_DSET_SPLIT_MATCH_PREFIX:
+                if (path_len >= rule->len && !memcmp(path, rule->pattern, rule->len))
+                    return rule->placement;
+                break;
+            case H5VL_DSET_SPLIT_MATCH_SUFFIX:
+                if (path_len >= rule->len && !memcmp(path + path_len - rule->len, rule->pattern, rule->len))
+                    return rule->placement;
+                break;
+            case H5VL_DSET_SPLIT_MATCH_GLOB:
+            default:
+                if (fnmatch(rule->pattern, path, 0) == 0)
+                    return rule->placement;
+                break;
+        }
+    }
+
+    return dflt;
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    dset_split_file_ctx_release
+ *
+ * Purpose:     Drops a reference to a file context, releasing it with the
+ *              last one
+ *
+ *-------------------------------------------------------------------------
+ */
+static void
+dset_split_file_ctx_release(H5VL_dset_split_file_ctx_t *file_ctx)
+{
+    if (--file_ctx->nrefs > 0)
+        return;
+
+    /* Links the main file could not take */
+    while (file_ctx->link_head) {
+        H5VL_dset_split_link_t *link = file_ctx->link_head;
+
+        file_ctx->link_head = link->next;
+        free(link->path);
+        free(link->file_name);
+        free(link->dsetname);
+        free(link);
+    }
+    if (file_ctx->fcpl_id >= 0)
+        H5Pclose(file_ctx->fcpl_id);
+    if (file_ctx->fapl_id >= 0)
+        H5Pclose(file_ctx->fapl_id);
+    if (file_ctx->policy)
+        dset_split_policy_free(file_ctx->policy);
+#ifdef H5_HAVE_PARALLEL
+    if (file_ctx->comm != MPI_COMM_NULL) {
+        int finalized = 0;
+
+        MPI_Finalized(&finalized);
+        if (!finalized)
+            MPI_Comm_free(&file_ctx->comm);
+    }
+#endif
+    free(file_ctx->parent_name);
+    free(file_ctx->owner);
+    free(file_ctx->split_folder);
+    free(file_ctx->shard_ready);
+    free(file_ctx->dir_ready);
+    free(file_ctx);
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    dset_split_str_to_driver
+ *
+ * Purpose:     Parses a split file driver: "sec2" or "core", 'len'
+ *              characters long
+ *
+ * Return:      Success:    0
+ *              Failure:    -1
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+dset_split_str_to_driver(const char *str, size_t len, H5VL_dset_split_driver_t *driver)
+{
+    if (len == strlen("sec2") && !strncmp(str, "sec2", len))
+        *driver = H5VL_DSET_SPLIT_DRIVER_SEC2;
+    else if (len == strlen("core") && !strncmp(str, "core", len))
+        *driver = H5VL_DSET_SPLIT_DRIVER_CORE;
+    else if (len == 0 || (len == strlen("inherit") && !strncmp(str, "inherit", len)))
+        *driver = H5VL_DSET_SPLIT_DRIVER_INHERIT;
+    else
+        return -1;
+
+    return 0;
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    dset_split_driver_to_str
+ *
+ * Purpose:     Names a split file driver, the way dset_split_str_to_driver
+ *              parses it
+ *
+ *-------------------------------------------------------------------------
+ */
+static const char *
+dset_split_driver_to_str(H5VL_dset_split_driver_t driver)
+{
+    switch (driver) {
+        case H5VL_DSET_SPLIT_DRIVER_SEC2:
+            return "sec2";
+        case H5VL_DSET_SPLIT_DRIVER_CORE:
+            return "core";
+        case H5VL_DSET_SPLIT_DRIVER_INHERIT:
+        default:
+            return "inherit";
+    }
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    dset_split_set_file_props
+ *
+ * Purpose:     Applies the split file property overrides of the
+ *              connector options to the property lists of new split
+ *              files. Split files hold one large dataset each, they can
+ *              be tuned for streaming I/O without slowing the metadata
+ *              operations of the main file.
+ *
+ * Return:      Success:    0
+ *              Failure:    -1
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+dset_split_set_file_props(const H5VL_dset_split_info_t *info, hid_t fcpl_id, hid_t fapl_id)
+{
+    if (info->split_alignment > 0 &&
+        H5Pset_alignment(fapl_id, info->split_align_threshold > 0 ? info->split_align_threshold : 1,
+                         info->split_alignment) < 0)
+        return -1;
+    if (info->split_meta_block_size > 0 && H5Pset_meta_block_size(fapl_id, info->split_meta_block_size) < 0)
+        return -1;
+    if (info->split_sieve_buf_size > 0 && H5Pset_sieve_buf_size(fapl_id, (size_t)info->split_sieve_buf_size) < 0)
+        return -1;
+
+    /* The library must not cache raw data that direct I/O reads or writes around it */
+    if (info->direct_io && H5Pset_sieve_buf_size(fapl_id, 0) < 0)
+        return -1;
+    if (info->split_libver_latest && H5Pset_libver_bounds(fapl_id, H5F_LIBVER_LATEST, H5F_LIBVER_LATEST) < 0)
+        return -1;
+    if (info->split_page_size > 0 &&
+        (H5Pset_file_space_strategy(fcpl_id, H5F_FSPACE_STRATEGY_PAGE, FALSE, (hsize_t)1) < 0 ||
+         H5Pset_file_space_page_size(fcpl_id, info->split_page_size) < 0))
+        return -1;
+
+    /* Split files of a parallel main file are created by all ranks, they keep MPI-IO */
+#ifdef H5_HAVE_PARALLEL
+    if (H5Pget_driver(fapl_id) == H5FD_MPIO)
+        return 0;
+#endif
+    switch (info->split_driver) {
+        case H5VL_DSET_SPLIT_DRIVER_SEC2:
+            if (H5Pset_fapl_sec2(fapl_id) < 0)
+                return -1;
+            break;
+        case H5VL_DSET_SPLIT_DRIVER_CORE:
+            if (H5Pset_fapl_core(fapl_id, (size_t)H5VL_DSET_SPLIT_CORE_INCREMENT, TRUE) < 0)
+                return -1;
+            break;
+        case H5VL_DSET_SPLIT_DRIVER_INHERIT:
+        default:
+            break;
+    }
+
+    return 0;
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    dset_split_file_ctx_new
+ *
+ * Purpose:     Gathers the metadata of the main file that 'obj' belongs
+ *              to: its normalized name, the split folder name, its access
+ *              flags and the property lists for new split files, with the
+ *              split file overrides applied. The connector options come
+ *              from 'info', defaults if NULL.
+ *
+ * Return:      Success:    New file context, with one reference
+ *              Failure:    NULL
+ *
+ *-------------------------------------------------------------------------
+ */
+static H5VL_dset_split_file_ctx_t *
+dset_split_file_ctx_new(void *obj, H5I_type_t obj_type, hid_t connector_id, const H5VL_dset_split_info_t *info)
+{
+    H5VL_dset_split_file_ctx_t *file_ctx;
+    H5VL_file_get_args_t        vol_cb_args;
+    void *                      vol_obj_file;
+    hid_t                       pfcpl_id;
+    hid_t                       pfapl_id;
+    size_t                      size;
+    const char *                slash;
+
+    if (NULL == (file_ctx = (H5VL_dset_split_file_ctx_t *)calloc(1, sizeof(H5VL_dset_split_file_ctx_t))))
+        return NULL;
+    file_ctx->nrefs   = 1;
+    file_ctx->fcpl_id = H5I_INVALID_HID;
+    file_ctx->fapl_id = H5I_INVALID_HID;
+#ifdef H5_HAVE_PARALLEL
+    file_ctx->comm = MPI_COMM_NULL;
+#endif
+    file_ctx->wb_budget = H5VL_DSET_SPLIT_WB_BUDGET;
+    if (info) {
+        file_ctx->split_threshold = info->split_threshold;
+        file_ctx->split_mode      = info->split_mode;
+        file_ctx->subfiling       = (hbool_t)(info->subfiling != 0);
+        file_ctx->direct_io       = (hbool_t)(info->direct_io != 0);
+        file_ctx->write_behind    = info->write_behind;
+        if (info->write_behind_budget > 0)
+            file_ctx->wb_budget = info->write_behind_budget;
+        file_ctx->read_ahead      = info->read_ahead;
+        file_ctx->mmap_read       = (hbool_t)(info->mmap_read != 0);
+        file_ctx->compress_threads = info->compress_threads;
+        file_ctx->lazy_create     = (hbool_t)(info->lazy_create != 0);
+        file_ctx->batch_links     = (hbool_t)(info->batch_links != 0);
+        file_ctx->shard_levels    = info->shard_levels < H5VL_DSET_SPLIT_SHARD_LEVELS_MAX
+                                     ? info->shard_levels
+                                     : H5VL_DSET_SPLIT_SHARD_LEVELS_MAX;
+        file_ctx->mirror_groups   = (hbool_t)(info->mirror_groups != 0);
+        if (file_ctx->mirror_groups)
+            file_ctx->shard_levels = 0;
+        if (file_ctx->batch_links && obj_type == H5I_FILE)
+            file_ctx->file_under = obj;
+        if (info->split_policy && NULL == (file_ctx->policy = dset_split_policy_compile(info->split_policy)))
+            goto error;
+    }
+
+    /* Split folder, named after the main file */
+    size = get_file_name(obj, connector_id, obj_type, NULL, 0);
+    if (size > 0 && size != (size_t)-1) {
+        if (NULL == (file_ctx->parent_name = (char *)calloc(size + 1, sizeof(char))))
+            goto error;
+        get_file_name(obj, connector_id, obj_type, file_ctx->parent_name, size + 1);
+        slash = strrchr(file_ctx->parent_name, '/');
+        if (NULL == (file_ctx->owner = strdup(slash ? slash + 1 : file_ctx->parent_name)))
+            goto error;
+        dset_get_normalized_name(file_ctx->parent_name);
+        if (NULL == (file_ctx->split_folder = (char *)calloc(size + 7, sizeof(char))))
+            goto error;
+        sprintf(file_ctx->split_folder, "%s-%s", file_ctx->parent_name, "split");
+    }
+    else {
+        if (NULL == (file_ctx->parent_name = strdup("")) || NULL == (file_ctx->owner = strdup("")) ||
+            NULL == (file_ctx->split_folder = strdup("split")))
+            goto error;
+    }
+
+    /* Split files get the access flags and properties of the main file */
+    if (NULL == (vol_obj_file = get_parent_file_obj(obj, obj_type, connector_id)))
+        goto error;
+    vol_cb_args.op_type               = H5VL_FILE_GET_INTENT;
+    vol_cb_args.args.get_intent.flags = &file_ctx->intent;
+    if (H5VLfile_get(vol_obj_file, connector_id, &vol_cb_args, H5P_DATASET_XFER_DEFAULT, NULL) < 0)
+        goto error;
+    if ((pfcpl_id = get_parent_file_fcpl(vol_obj_file, connector_id)) < 0)
+        goto error;
+    file_ctx->fcpl_id = H5Pcopy(pfcpl_id);
+    H5Pclose(pfcpl_id);
+    if ((pfapl_id = get_parent_file_fapl(vol_obj_file, connector_id)) < 0)
+        goto error;
+    file_ctx->fapl_id = H5Pcopy(pfapl_id);
+    H5Pclose(pfapl_id);
+    if (file_ctx->fcpl_id < 0 || file_ctx->fapl_id < 0)
+        goto error;
+    if (info && dset_split_set_file_props(info, file_ctx->fcpl_id, file_ctx->fapl_id) < 0)
+        goto error;
+
+#ifdef H5_HAVE_PARALLEL
+    /* Split files of a parallel main file are created collectively, on the main file's communicator */
+    if (H5Pget_driver(file_ctx->fapl_id) == H5FD_MPIO) {
+        MPI_Info mpi_info = MPI_INFO_NULL;
+
+        if (H5Pget_fapl_mpio(file_ctx->fapl_id, &file_ctx->comm, &mpi_info) < 0)
+            goto error;
+        MPI_Comm_rank(file_ctx->comm, &file_ctx->mpi_rank);
+
+        /* Funnel the split file I/O through fewer ranks */
+        if (info && info->aggregators > 0) {
+            char cb_nodes[16];
+
+            if (mpi_info == MPI_INFO_NULL)
+                MPI_Info_create(&mpi_info);
+            snprintf(cb_nodes, sizeof(cb_nodes), "%u", info->aggregators);
+            MPI_Info_set(mpi_info, "cb_nodes", cb_nodes);
+            if (H5Pset_fapl_mpio(file_ctx->fapl_id, file_ctx->comm, mpi_info) < 0) {
+                MPI_Info_free(&mpi_info);
+                goto error;
+            }
+        }
+        if (mpi_info != MPI_INFO_NULL)
+            MPI_Info_free(&mpi_info);
+    }
+#endif
+
+    return file_ctx;
+
+error:
+    dset_split_file_ctx_release(file_ctx);
+    return NULL;
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    dset_split_main_add
+ *
+ * Purpose:     Records a main file opened as 'name' with the connector
+ *              options 'info', or counts one more open of it
+ *
+ * Return:      Success:    Entry of the main file
+ *              Failure:    NULL
+ *
+ *-------------------------------------------------------------------------
+ */
+static H5VL_dset_split_main_t *
+dset_split_main_add(const char *name, const H5VL_dset_split_info_t *info)
+{
+    H5VL_dset_split_main_t *main_file;
+
+    for (main_file = H5VL_dset_split_mains_g; main_file; main_file = main_file->next)
+        if (!strcmp(main_file->name, name)) {
+            main_file->nopens++;
+            return main_file;
+        }
+
+    if (NULL == (main_file = (H5VL_dset_split_main_t *)calloc(1, sizeof(H5VL_dset_split_main_t))))
+        return NULL;
+    if (NULL == (main_file->name = strdup(name)) ||
+        NULL == (main_file->info = (H5VL_dset_split_info_t *)H5VL_dset_split_info_copy(info))) {
+        free(main_file->name);
+        free(main_file);
+        return NULL;
+    }
+    main_file->nopens       = 1;
+    main_file->next         = H5VL_dset_split_mains_g;
+    H5VL_dset_split_mains_g = main_file;
+
+    return main_file;
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    dset_split_main_release
+ *
+ * Purpose:     Counts one less open of a main file, forgetting it with
+ *              the last one
+ *
+ *-------------------------------------------------------------------------
+ */
+static void
+dset_split_main_release(H5VL_dset_split_main_t *main_file)
+{
+    H5VL_dset_split_main_t **prev;
+
+    if (--main_file->nopens > 0)
+        return;
+
+    for (prev = &H5VL_dset_split_mains_g; *prev; prev = &(*prev)->next)
+        if (*prev == main_file) {
+            *prev = main_file->next;
+            break;
+        }
+    H5VL_dset_split_info_free(main_file->info);
+    free(main_file->name);
+    free(main_file);
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    dset_split_pool_resize
+ *
+ * Purpose:     Sizes the split file pool for the largest 'pool_size' of
+ *              the open main files, closing idle split files past it
+ *
+ * Return:      Success:    0
+ *              Failure:    -1
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+dset_split_pool_resize(void)
+{
+    H5VL_dset_split_pool_t *pool = &H5VL_dset_split_pool_g;
+    H5VL_dset_split_main_t *main_file;
+
+    pool->capacity = 0;
+    for (main_file = H5VL_dset_split_mains_g; main_file; main_file = main_file->next)
+        if (main_file->info->pool_size > pool->capacity)
+            pool->capacity = main_file->info->pool_size;
+
+    return dset_split_pool_evict(pool->capacity);
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    dset_split_file_ctx_get
+ *
+ * Purpose:     Returns the main file metadata of an object, gathering it
+ *              on first use if the object did not inherit it. The
+ *              connector options come from the main file the object
+ *              belongs to, which must be open through the connector.
+ *
+ * Return:      Success:    File context, owned by the object
+ *              Failure:    NULL
+ *
+ *-------------------------------------------------------------------------
+ */
+static H5VL_dset_split_file_ctx_t *
+dset_split_file_ctx_get(H5VL_dset_split_t *o, H5I_type_t obj_type)
+{
+    H5VL_dset_split_main_t *main_file = o->main_file;
+    char *                  name;
+    size_t                  size;
+
+    if (o->file_ctx)
+        return o->file_ctx;
+
+    /* Objects of a mounted file or reached through an external link name the main file they belong to */
+    if (!main_file) {
+        size = get_file_name(o->under_object, o->under_vol_id, obj_type, NULL, 0);
+        if (size == 0 || size == (size_t)-1 || NULL == (name = (char *)calloc(size + 1, sizeof(char))))
+            return NULL;
+        if (get_file_name(o->under_object, o->under_vol_id, obj_type, name, size + 1) != (size_t)-1)
+            for (main_file = H5VL_dset_split_mains_g; main_file; main_file = main_file->next)
+                if (!strcmp(main_file->name, name))
+                    break;
+        free(name);
+
+        /* The connector options are not known, defaults would put the datasets elsewhere */
+        if (!main_file)
+            return NULL;
+    }
+
+    o->file_ctx = dset_split_file_ctx_new(o->under_object, obj_type, o->under_vol_id, main_file->info);
+
+    return o->file_ctx;
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    dset_split_inherit_file_ctx
+ *
+ * Purpose:     Shares the main file metadata of 'parent' with an object
+ *              opened or created from it
+ *
+ *-------------------------------------------------------------------------
+ */
+static void
+dset_split_inherit_file_ctx(H5VL_dset_split_t *child, const H5VL_dset_split_t *parent)
+{
+    if (!child || !parent->file_ctx || child->file_ctx)
+        return;
+
+    child->file_ctx = parent->file_ctx;
+    child->file_ctx->nrefs++;
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    dset_split_dataset_is_small
+ *
+ * Purpose:     Checks whether a dataset of type 'type_id' and dataspace
+ *              'space_id' can never grow past 'threshold' bytes. Datasets
+ *              with unlimited dimensions are never small.
+ *
+ * Return:      TRUE/FALSE
+ *
+ *-------------------------------------------------------------------------
+ */
+static hbool_t
+dset_split_dataset_is_small(hid_t type_id, hid_t space_id, hsize_t threshold)
+{
+    hsize_t maxdims[H5S_MAX_RANK];
+    hsize_t size;
+    int     ndims;
+    int     i;
+
+    if (0 == (size = (hsize_t)H5Tget_size(type_id)))
+        return FALSE;
+    if ((ndims = H5Sget_simple_extent_dims(space_id, NULL, maxdims)) < 0)
+        return FALSE;
+
+    /* The dataset may be extended up to its maximum dimensions */
+    for (i = 0; i < ndims; i++) {
+        if (maxdims[i] == H5S_UNLIMITED || size > threshold / (maxdims[i] ? maxdims[i] : 1))
+            return FALSE;
+        size *= maxdims[i];
+    }
+
+    return size <= threshold;
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    dset_split_get_group_path
+ *
+ * Purpose:     Builds the absolute path of the group a dataset named
+ *              'name' is created in, relative to the object 'o'
+ *
+ * Return:      Success:    Normalized group path, to be freed by the caller
+ *              Failure:    NULL
+ *
+ *-------------------------------------------------------------------------
+ */
+static char *
+dset_split_get_group_path(H5VL_dset_split_t *o, const H5VL_loc_params_t *loc_params, const char *name)
+{
+    H5VL_object_get_args_t vol_cb_args;
+    H5VL_loc_params_t      obj_loc_params;
+    const char *           slash    = strrchr(name, '/');
+    size_t                 dir_len  = slash ? (size_t)(slash - name) : 0;
+    char *                 obj_path = NULL;
+    size_t                 obj_len  = 0;
+    char *                 path;
+    char *                 in;
+    char *                 out;
+
+    /* Path of the object the name is relative to */
+    if (name[0] != '/' && loc_params->obj_type != H5I_FILE) {
+        obj_loc_params.type     = H5VL_OBJECT_BY_SELF;
+        obj_loc_params.obj_type = loc_params->obj_type;
+
+        vol_cb_args.op_type                = H5VL_OBJECT_GET_NAME;
+        vol_cb_args.args.get_name.buf_size = 0;
+        vol_cb_args.args.get_name.buf      = NULL;
+        vol_cb_args.args.get_name.name_len = &obj_len;
+        if (H5VLobject_get(o->under_object, &obj_loc_params, o->under_vol_id, &vol_cb_args,
+                           H5P_DATASET_XFER_DEFAULT, NULL) < 0)
+            return NULL;
+        if (NULL == (obj_path = (char *)calloc(obj_len + 1, sizeof(char))))
+            return NULL;
+        vol_cb_args.args.get_name.buf_size = obj_len + 1;
+        vol_cb_args.args.get_name.buf      = obj_path;
+        if (H5VLobject_get(o->under_object, &obj_loc_params, o->under_vol_id, &vol_cb_args,
+                           H5P_DATASET_XFER_DEFAULT, NULL) < 0) {
+            free(obj_path);
+            return NULL;
+        }
+    }
+
+    if (NULL == (path = (char *)malloc(obj_len + dir_len + 3))) {
+        free(obj_path);
+        return NULL;
+    }
+    sprintf(path, "/%s/%.*s", obj_path ? obj_path : "", (int)dir_len, name);
+    free(obj_path);
+
+    /* Collapse repeated '/' and drop the trailing one */
+    for (in = out = path; *in; in++)
+        if (*in != '/' || out == path || out[-1] != '/')
+            *out++ = *in;
+    if (out > path + 1 && out[-1] == '/')
+        out--;
+    *out = '\0';
+
+    return path;
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    dset_split_escape_path
+ *
+ * Purpose:     Turns an HDF5 path into a file name component, escaping
+ *              '/' and '%' the way URLs do
+ *
+ * Return:      Success:    Escaped path, to be freed by the caller
+ *              Failure:    NULL
+ *
+ *-------------------------------------------------------------------------
+ */
+static char *
+dset_split_escape_path(const char *path)
+{
+    char * escaped;
+    char * out;
+
+    if (NULL == (out = escaped = (char *)malloc(3 * strlen(path) + 1)))
+        return NULL;
+    for (; *path; path++) {
+        if (*path == '/' || *path == '%')
+            out += sprintf(out, "%%%02X", (unsigned char)*path);
+        else
+            *out++ = *path;
+    }
+    *out = '\0';
+
+    return escaped;
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    dset_split_get_dataset_path
+ *
+ * Purpose:     Builds the absolute paths of the group and of the dataset
+ *              named 'name', whose last component is 'dsetname'
+ *
+ * Return:      Success:    0, the paths are to be freed by the caller
+ *              Failure:    -1
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+dset_split_get_dataset_path(H5VL_dset_split_t *o, const H5VL_loc_params_t *loc_params, const char *name,
+                            const char *dsetname, char **group_path, char **dset_path)
+{
+    if (NULL == (*group_path = dset_split_get_group_path(o, loc_params, name)))
+        return -1;
+    if (NULL == (*dset_path = (char *)malloc(strlen(*group_path) + strlen(dsetname) + 2)))
+        return -1;
+    sprintf(*dset_path, "%s/%s", ((*group_path)[1] ? *group_path : ""), dsetname);
+
+    return 0;
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    dset_split_shard_prefix
+ *
+ * Purpose:     Writes the hash-prefix subfolders of a split file whose
+ *              path hash is 'hash', "ab/cd/" for two levels, one byte of
+ *              the hash per level. Empty without sharding. The hash is
+ *              mixed first: paths differing in their last characters,
+ *              such as numbered datasets, differ in its low bits only.
+ *
+ *-------------------------------------------------------------------------
+ */
+static void
+dset_split_shard_prefix(const H5VL_dset_split_file_ctx_t *file_ctx, uint64_t hash, char *prefix)
+{
+    unsigned u;
+
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdULL;
+    hash ^= hash >> 33;
+    hash *= 0xc4ceb9fe1a85ec53ULL;
+    hash ^= hash >> 33;
+
+    for (u = 0; u < file_ctx->shard_levels; u++)
+        prefix += sprintf(prefix, "%02x/", (unsigned)((hash >> (56 - 8 * u)) & 0xff));
+    *prefix = '\0';
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    dset_split_mirror_dir
+ *
+ * Purpose:     Turns the first 'len' characters of a group path into the
+ *              subfolders mirroring it in the split folder, "Data1/grp2/"
+ *              for "/Data1/grp2". Each component is escaped the way
+ *              dset_split_escape_path does, "." and ".." as "%2E" and
+ *              "%2E%2E".
+ *
+ * Return:      Success:    Subfolders, empty for the root group, to be
+ *                          freed by the caller
+ *              Failure:    NULL
+ *
+ *-------------------------------------------------------------------------
+ */
+static char *
+dset_split_mirror_dir(const char *path, size_t len)
+{
+    const char *end = path + len;
+    char *      dir;
+    size_t      size = 1;
+    size_t      used = 0;
+
+    if (NULL == (dir = (char *)calloc(size, 1)))
+        return NULL;
+
+    while (path < end) {
+        const char *comp_end;
+        char *      comp;
+        char *      escaped;
+        size_t      comp_len;
+
+        while (path < end && *path == '/')
+            path++;
+        for (comp_end = path; comp_end < end && *comp_end != '/'; comp_end++)
+            ;
+        if (0 == (comp_len = (size_t)(comp_end - path)))
+            break;
+
+        if (NULL == (comp = strndup(path, comp_len))) {
+            free(dir);
+            return NULL;
+        }
+        if (!strcmp(comp, "."))
+            escaped = strdup("%2E");
+        else if (!strcmp(comp, ".."))
+            escaped = strdup("%2E%2E");
+        else
+            escaped = dset_split_escape_path(comp);
+        free(comp);
+        if (!escaped) {
+            free(dir);
+            return NULL;
+        }
+
+        size += strlen(escaped) + 1;
+        if (NULL == (comp = (char *)realloc(dir, size))) {
+            free(escaped);
+            free(dir);
+            return NULL;
+        }
+        dir = comp;
+        used += (size_t)sprintf(dir + used, "%s/", escaped);
+        free(escaped);
+        path = comp_end;
+    }
+
+    return dir;
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    dset_split_get_file_name
+ *
+ * Purpose:     Names the split file of the dataset at 'dset_path':
+ *              "<split folder>/<shards>/<escaped dsetname>-<path hash>.split",
+ *              <shards> being the hash-prefix subfolders if the split
+ *              folder is sharded, or with mirrored groups
+ *              "<split folder>/<group path>/<escaped dsetname>.split". The
+ *              name only depends on the dataset path, so a rerun gives the
+ *              same main file and the same split files.
+ *
+ * Return:      Success:    0
+ *              Failure:    -1, if the name does not fit in 'size'
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+dset_split_get_file_name(const H5VL_dset_split_file_ctx_t *file_ctx, const char *dsetname, const char *dset_path,
+                         char *file_name, size_t size)
+{
+    char        shards[3 * H5VL_DSET_SPLIT_SHARD_LEVELS_MAX + 1];
+    char *      escaped;
+    char *      dir;
+    const char *slash;
+    uint64_t    hash = dset_split_hash_str(dset_path);
+    size_t      len;
+
+    if (NULL == (escaped = dset_split_escape_path(dsetname)))
+        return -1;
+    if (file_ctx->mirror_groups) {
+        slash = strrchr(dset_path, '/');
+        if (NULL == (dir = dset_split_mirror_dir(dset_path, slash ? (size_t)(slash - dset_path) : 0))) {
+            free(escaped);
+            return -1;
+        }
+        len = (size_t)snprintf(file_name, size, "%s/%s%s%s", file_ctx->split_folder, dir, escaped, FILE_EXTENTION);
+        free(dir);
+    }
+    else {
+        dset_split_shard_prefix(file_ctx, hash, shards);
+        len = (size_t)snprintf(file_name, size, "%s/%s%s-%016llx%s", file_ctx->split_folder, shards, escaped,
+                               (unsigned long long)hash, FILE_EXTENTION);
+    }
+    free(escaped);
+
+    return len < size ? 0 : -1;
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    dset_split_shard_index
+ *
+ * Purpose:     Reads the hash-prefix subfolders of the split file
+ *              'file_name' as a number, the leaf subfolder's index
+ *
+ * Return:      Success:    0
+ *              Failure:    -1, the split file is not in subfolders
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+dset_split_shard_index(const H5VL_dset_split_file_ctx_t *file_ctx, const char *file_name, size_t *index)
+{
+    size_t      folder_len = strlen(file_ctx->split_folder);
+    const char *p          = file_name + folder_len + 1;
+    unsigned    u;
+
+    if (file_ctx->shard_levels == 0 || strncmp(file_name, file_ctx->split_folder, folder_len) != 0 ||
+        file_name[folder_len] != '/')
+        return -1;
+
+    *index = 0;
+    for (u = 0; u < file_ctx->shard_levels; u++, p += 3) {
+        char byte[3] = {p[0], p[1], '\0'};
+
+        if (!isxdigit((unsigned char)p[0]) || !isxdigit((unsigned char)p[1]) || p[2] != '/')
+            return -1;
+        *index = *index * 256 + (size_t)strtoul(byte, NULL, 16);
+    }
+
+    return 0;
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    dset_split_make_folders
+ *
+ * Purpose:     Creates the split folder, unless it was checked already,
+ *              and the hash-prefix or mirrored subfolders of the split
+ *              file 'file_name' if there is one
+ *
+ * Return:      Success:    0
+ *              Failure:    -1
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+dset_split_make_folders(const H5VL_dset_split_file_ctx_t *file_ctx, const char *file_name)
+{
+    size_t   index;
+    size_t   len;
+    unsigned u;
+    char *   path;
+    herr_t   ret_value = 0;
+
+    if (!file_ctx->folder_ready && dset_create_split_folder(file_ctx->split_folder) < 0)
+        return -1;
+
+    /* Mirrored subfolders, down to the split file's */
+    if (file_name && file_ctx->mirror_groups) {
+        const char *slash;
+
+        len = strlen(file_ctx->split_folder);
+        if (strncmp(file_name, file_ctx->split_folder, len) != 0 || file_name[len] != '/')
+            return 0;
+        if (NULL == (path = strdup(file_name)))
+            return -1;
+        for (slash = strchr(file_name + len + 1, '/'); slash && ret_value >= 0; slash = strchr(slash + 1, '/')) {
+            path[slash - file_name] = '\0';
+            ret_value = dset_create_split_folder(path);
+            path[slash - file_name] = '/';
+        }
+        free(path);
+
+        return ret_value;
+    }
+
+    if (!file_name || dset_split_shard_index(file_ctx, file_name, &index) < 0)
+        return 0;
+
+    /* One level at a time, "<split folder>/ab", then "<split folder>/ab/cd" */
+    len = strlen(file_ctx->split_folder);
+    if (NULL == (path = strdup(file_name)))
+        return -1;
+    for (u = 0; u < file_ctx->shard_levels && ret_value >= 0; u++) {
+        len += 3;
+        path[len] = '\0';
+        ret_value = dset_create_split_folder(path);
+        path[len] = '/';
+    }
+    free(path);
+
+    return ret_value;
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    dset_split_mark_folders
+ *
+ * Purpose:     Records that the split folder, and the hash-prefix or
+ *              mirrored subfolders of the split file 'file_name' if there
+ *              is one, exist
+ *
+ *-------------------------------------------------------------------------
+ */
+static void
+dset_split_mark_folders(H5VL_dset_split_file_ctx_t *file_ctx, const char *file_name)
+{
+    size_t index;
+
+    file_ctx->folder_ready = TRUE;
+    if (file_name && file_ctx->mirror_groups) {
+        free(file_ctx->dir_ready);
+        file_ctx->dir_ready = strndup(file_name, (size_t)(strrchr(file_name, '/') - file_name));
+        return;
+    }
+    if (!file_name || dset_split_shard_index(file_ctx, file_name, &index) < 0)
+        return;
+    if (!file_ctx->shard_ready &&
+        NULL == (file_ctx->shard_ready = (uint8_t *)calloc(((size_t)1 << (8 * file_ctx->shard_levels)) / 8, 1)))
+        return;
+    file_ctx->shard_ready[index / 8] |= (uint8_t)(1 << (index % 8));
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    dset_split_folders_ready
+ *
+ * Purpose:     Checks whether the split folder, and the hash-prefix or
+ *              mirrored subfolders of the split file 'file_name' if there
+ *              is one, were checked to exist already. Only the last
+ *              mirrored subfolder is remembered: datasets tend to be
+ *              created group by group.
+ *
+ * Return:      TRUE/FALSE
+ *
+ *-------------------------------------------------------------------------
+ */
+static hbool_t
+dset_split_folders_ready(const H5VL_dset_split_file_ctx_t *file_ctx, const char *file_name)
+{
+    size_t index;
+
+    if (!file_ctx->folder_ready)
+        return FALSE;
+    if (file_name && file_ctx->mirror_groups)
+        return file_ctx->dir_ready && strlen(file_ctx->dir_ready) == (size_t)(strrchr(file_name, '/') - file_name) &&
+               !strncmp(file_name, file_ctx->dir_ready, strlen(file_ctx->dir_ready));
+    if (!file_name || dset_split_shard_index(file_ctx, file_name, &index) < 0)
+        return TRUE;
+
+    return file_ctx->shard_ready && (file_ctx->shard_ready[index / 8] & (1 << (index % 8)));
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    dset_split_prepare_folder
+ *
+ * Purpose:     Makes sure the split folder exists before the split file
+ *              'file_name' is created in it, once per opening of the main
+ *              file: on parallel file systems the mkdir and stat are each
+ *              a metadata server round trip. For a main file opened with
+ *              MPI-IO, rank 0 alone creates the folder and broadcasts the
+ *              split file name it chose, so that all ranks create the same
+ *              split file collectively. 'file_name' may be NULL when no
+ *              split file is created yet.
+ *
+ * Return:      Success:    0
+ *              Failure:    -1, on all ranks
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+dset_split_prepare_folder(H5VL_dset_split_file_ctx_t *file_ctx, char *file_name, size_t size)
+{
+    if (dset_split_folders_ready(file_ctx, file_name))
+        return 0;
+
+#ifdef H5_HAVE_PARALLEL
+    if (file_ctx->comm != MPI_COMM_NULL) {
+        char status[2] = "1";
+
+        if (!file_name) {
+            file_name = status;
+            size      = sizeof(status);
+        }
+        if (file_ctx->mpi_rank == 0 && dset_split_make_folders(file_ctx, file_name == status ? NULL : file_name) < 0)
+            file_name[0] = '\0';
+        if (MPI_Bcast(file_name, (int)size, MPI_CHAR, 0, file_ctx->comm) != MPI_SUCCESS)
+            return -1;
+        if (!file_name[0])
+            return -1;
+        dset_split_mark_folders(file_ctx, file_name == status ? NULL : file_name);
+
+        return 0;
+    }
+#else
+    /* Shut compiler up about unused parameters */
+    (void)file_name;
+    (void)size;
+#endif
+
+    if (dset_split_make_folders(file_ctx, file_name) < 0)
+        return -1;
+    dset_split_mark_folders(file_ctx, file_name);
+
+    return 0;
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    dset_split_subfile_free_pending
+ *
+ * Purpose:     Releases the creation arguments kept for a dataset of
+ *              rank-local split files until it is laid out
+ *
+ *-------------------------------------------------------------------------
+ */
+static void
+dset_split_subfile_free_pending(H5VL_dset_split_lazy_t *pending)
+{
+    if (pending->lcpl_id >= 0)
+        H5Pclose(pending->lcpl_id);
+    if (pending->type_id >= 0)
+        H5Tclose(pending->type_id);
+    if (pending->space_id >= 0)
+        H5Sclose(pending->space_id);
+    if (pending->dcpl_id >= 0)
+        H5Pclose(pending->dcpl_id);
+    if (pending->dapl_id >= 0)
+        H5Pclose(pending->dapl_id);
+    free(pending->name);
+    free(pending);
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    dset_split_subfile_free
+ *
+ * Purpose:     Releases the rank-local layout of a dataset
+ *
+ *-------------------------------------------------------------------------
+ */
+static void
+dset_split_subfile_free(H5VL_dset_split_subfile_t *subfile)
+{
+    if (subfile->pending)
+        dset_split_subfile_free_pending(subfile->pending);
+    if (subfile->space_id >= 0)
+        H5Sclose(subfile->space_id);
+    free(subfile->file_name);
+    free(subfile);
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    dset_split_subfile_space
+ *
+ * Purpose:     Moves a selection in the whole dataset, H5S_ALL for all of
+ *              it, onto the rank's block, in the rank-local split file.
+ *              The selection must lie in the rank's block. If
+ *              'mem_space_id' is given and is H5S_ALL, the memory buffer
+ *              is shaped like the whole dataset, as for any dataset: it
+ *              is replaced with the selection in the whole dataset, which
+ *              the caller closes.
+ *
+ * Return:      Success:    Dataspace to use with the rank-local dataset
+ *              Failure:    H5I_INVALID_HID, the selection reaches outside
+ *                          the rank's block
+ *
+ *-------------------------------------------------------------------------
+ */
+static hid_t
+dset_split_subfile_space(const H5VL_dset_split_subfile_t *subfile, hid_t file_space_id, hid_t *mem_space_id)
+{
+    hssize_t offset[H5S_MAX_RANK];
+    hsize_t  dims[H5S_MAX_RANK];
+    hsize_t  first[H5S_MAX_RANK];
+    hsize_t  last[H5S_MAX_RANK];
+    hssize_t npoints;
+    hid_t    space_id;
+    hid_t    local_space_id = H5I_INVALID_HID;
+    hid_t    orig_mem_space_id = mem_space_id ? *mem_space_id : H5S_ALL;
+    int      ndims;
+    int      i;
+
+    if (file_space_id == H5S_ALL) {
+        if ((space_id = H5Scopy(subfile->space_id)) < 0 || H5Sselect_all(space_id) < 0)
+            goto done;
+    }
+    else if ((space_id = H5Scopy(file_space_id)) < 0)
+        return H5I_INVALID_HID;
+
+    /* A rank only holds its block */
+    if ((ndims = H5Sget_simple_extent_dims(space_id, dims, NULL)) < 1 ||
+        (npoints = H5Sget_select_npoints(space_id)) < 0)
+        goto done;
+    if (npoints > 0) {
+        if (H5Sget_select_bounds(space_id, first, last) < 0)
+            goto done;
+        for (i = 0; i < ndims; i++)
+            if (first[i] < subfile->start[i] || last[i] >= subfile->start[i] + subfile->count[i])
+                goto done;
+    }
+
+    for (i = 0; i < ndims; i++) {
+        offset[i] = (hssize_t)subfile->start[i];
+        dims[i]   = subfile->count[i];
+    }
+    if ((local_space_id = H5Screate_simple(ndims, dims, NULL)) < 0)
+        goto done;
+    if (mem_space_id && *mem_space_id == H5S_ALL && (*mem_space_id = H5Scopy(space_id)) < 0) {
+        *mem_space_id = H5S_ALL;
+        goto fail;
+    }
+    if (H5Sselect_adjust(space_id, offset) < 0 || H5Sselect_copy(local_space_id, space_id) < 0)
+        goto fail;
+
+done:
+    if (space_id >= 0)
+        H5Sclose(space_id);
+
+    return local_space_id;
+
+fail:
+    if (mem_space_id && *mem_space_id != H5S_ALL && *mem_space_id != orig_mem_space_id) {
+        H5Sclose(*mem_space_id);
+        *mem_space_id = H5S_ALL;
+    }
+    H5Sclose(local_space_id);
+    local_space_id = H5I_INVALID_HID;
+    goto done;
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    dset_split_subfile_chunk
+ *
+ * Purpose:     Moves the offset of a chunk in the whole dataset onto the
+ *              rank's block, in the rank-local split file
+ *
+ * Return:      Success:    0, with the offset in 'local_offset'
+ *              Failure:    -1, the chunk is outside the rank's block
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+dset_split_subfile_chunk(const H5VL_dset_split_subfile_t *subfile, const hsize_t *offset, hsize_t *local_offset)
+{
+    int ndims;
+    int i;
+
+    if ((ndims = H5Sget_simple_extent_ndims(subfile->space_id)) < 1)
+        return -1;
+    for (i = 0; i < ndims; i++) {
+        if (offset[i] < subfile->start[i] || offset[i] >= subfile->start[i] + subfile->count[i])
+            return -1;
+        local_offset[i] = offset[i] - subfile->start[i];
+    }
+
+    return 0;
+}
+
+#ifdef H5_HAVE_PARALLEL
+/*-------------------------------------------------------------------------
+ * Function:    dset_split_subfile_name
+ *
+ * Purpose:     Names the split file of 'rank' after the split file
+ *              'file_name' stitching the ranks' files together:
+ *              "<name>.r<rank>.split"
+ *
+ * Return:      Success:    0
+ *              Failure:    -1, if the name does not fit in 'size'
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+dset_split_subfile_name(const char *file_name, int rank, char *name, size_t size)
+{
+    int base_len = (int)(strlen(file_name) - strlen(FILE_EXTENTION));
+
+    return (size_t)snprintf(name, size, "%.*s.r%d%s", base_len, file_name, rank, FILE_EXTENTION) < size ? 0 : -1;
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    dset_split_subfile_eligible
+ *
+ * Purpose:     Checks whether a dataset with dataspace 'space_id' is
+ *              written to rank-local split files: the main file must use
+ *              MPI-IO with subfiling on, and the dataset must have fixed
+ *              dimensions
+ *
+ * Return:      TRUE/FALSE
+ *
+ *-------------------------------------------------------------------------
+ */
+static hbool_t
+dset_split_subfile_eligible(const H5VL_dset_split_file_ctx_t *file_ctx, hid_t space_id)
+{
+    hsize_t dims[H5S_MAX_RANK];
+    hsize_t maxdims[H5S_MAX_RANK];
+    int     ndims;
+    int     i;
+
+    if (!file_ctx->subfiling || file_ctx->comm == MPI_COMM_NULL)
+        return FALSE;
+    if ((ndims = H5Sget_simple_extent_dims(space_id, dims, maxdims)) < 1)
+        return FALSE;
+    for (i = 0; i < ndims; i++)
+        if (maxdims[i] != dims[i])
+            return FALSE;
+
+    return TRUE;
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    dset_split_subfile_new
+ *
+ * Purpose:     Sets up a dataset of a parallel main file to be written to
+ *              rank-local split files. Nothing is created yet: the blocks
+ *              of the ranks are only known from their first collective
+ *              write, see dset_split_subfile_layout(). The split folder is
+ *              prepared, and the name of the stitching split file agreed
+ *              on, here. Collective.
+ *
+ * Return:      Success:    Pending layout of the dataset
+ *              Failure:    NULL, on all ranks
+ *
+ *-------------------------------------------------------------------------
+ */
+static H5VL_dset_split_subfile_t *
+dset_split_subfile_new(H5VL_dset_split_file_ctx_t *file_ctx, char *file_name, size_t size, const char *dsetname,
+                       hid_t lcpl_id, hid_t type_id, hid_t space_id, hid_t dcpl_id, hid_t dapl_id)
+{
+    H5VL_dset_split_subfile_t *subfile;
+    H5VL_dset_split_lazy_t *   pending;
+
+    if (dset_split_prepare_folder(file_ctx, file_name, size) < 0)
+        return NULL;
+
+    if (NULL == (subfile = (H5VL_dset_split_subfile_t *)calloc(1, sizeof(H5VL_dset_split_subfile_t))))
+        return NULL;
+    subfile->space_id = H5I_INVALID_HID;
+    if (NULL == (subfile->pending = pending = (H5VL_dset_split_lazy_t *)calloc(1, sizeof(H5VL_dset_split_lazy_t)))) {
+        free(subfile);
+        return NULL;
+    }
+    subfile->space_id  = H5Scopy(space_id);
+    subfile->file_name = strdup(file_name);
+    pending->lcpl_id   = H5Pcopy(lcpl_id);
+    pending->type_id   = H5Tcopy(type_id);
+    pending->space_id  = H5Scopy(space_id);
+    pending->dcpl_id   = H5Pcopy(dcpl_id);
+    pending->dapl_id   = H5Pcopy(dapl_id);
+    pending->name      = strdup(dsetname);
+    if (subfile->space_id < 0 || !subfile->file_name || pending->lcpl_id < 0 || pending->type_id < 0 ||
+        pending->space_id < 0 || pending->dcpl_id < 0 || pending->dapl_id < 0 || !pending->name ||
+        H5Sselect_all(pending->space_id) < 0) {
+        dset_split_subfile_free(subfile);
+        return NULL;
+    }
+
+    return subfile;
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    dset_split_subfile_stitch
+ *
+ * Purpose:     Creates the split file 'file_name' holding a virtual
+ *              dataset that maps the blocks of the ranks' split files
+ *              into the whole dataset. Run on rank 0 only.
+ *
+ * Return:      Success:    0
+ *              Failure:    -1
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+dset_split_subfile_stitch(const H5VL_dset_split_file_ctx_t *file_ctx, const char *file_name, const char *dsetname,
+                          hid_t type_id, hid_t space_id, const H5VL_dset_split_box_t *boxes, int nranks)
+{
+    hsize_t count[H5S_MAX_RANK];
+    char    rank_name[1024];
+    hid_t   fapl_id = H5I_INVALID_HID;
+    hid_t   dcpl_id = H5I_INVALID_HID;
+    hid_t   fid     = H5I_INVALID_HID;
+    hid_t   did;
+    herr_t  ret_value = -1;
+    int     ndims;
+    int     r;
+    int     i;
+
+    if ((ndims = H5Sget_simple_extent_ndims(space_id)) < 1)
+        return -1;
+
+    if ((dcpl_id = H5Pcreate(H5P_DATASET_CREATE)) < 0)
+        goto done;
+    for (r = 0; r < nranks; r++) {
+        const char *src_name;
+        hid_t       vspace_id;
+        hid_t       src_space_id;
+        herr_t      status = -1;
+
+        if (boxes[r].kind != H5VL_DSET_SPLIT_BOX_SET)
+            continue;
+        if (dset_split_subfile_name(file_name, r, rank_name, sizeof(rank_name)) < 0)
+            goto done;
+
+        /* The ranks' files sit next to the stitching file, found relative to it */
+        src_name = strrchr(rank_name, '/') ? strrchr(rank_name, '/') + 1 : rank_name;
+
+        for (i = 0; i < ndims; i++)
+            count[i] = boxes[r].last[i] - boxes[r].first[i] + 1;
+        vspace_id    = H5Scopy(space_id);
+        src_space_id = H5Screate_simple(ndims, count, NULL);
+        if (vspace_id >= 0 && src_space_id >= 0 &&
+            H5Sselect_hyperslab(vspace_id, H5S_SELECT_SET, boxes[r].first, NULL, count, NULL) >= 0)
+            status = H5Pset_virtual(dcpl_id, vspace_id, src_name, dsetname, src_space_id);
+        if (vspace_id >= 0)
+            H5Sclose(vspace_id);
+        if (src_space_id >= 0)
+            H5Sclose(src_space_id);
+        if (status < 0)
+            goto done;
+    }
+
+    if ((fapl_id = H5Pcopy(file_ctx->fapl_id)) < 0 || H5Pset_fapl_sec2(fapl_id) < 0)
+        goto done;
+    if ((fid = H5Fcreate(file_name, H5F_ACC_TRUNC, file_ctx->fcpl_id, fapl_id)) < 0)
+        goto done;
+    if (dset_split_create_attribute(fid, file_ctx->owner) < 0)
+        goto done;
+    if ((did = H5Dcreate2(fid, dsetname, type_id, space_id, H5P_DEFAULT, dcpl_id, H5P_DEFAULT)) < 0)
+        goto done;
+    H5Dclose(did);
+
+    ret_value = 0;
+
+done:
+    if (fid >= 0)
+        H5Fclose(fid);
+    if (fapl_id >= 0)
+        H5Pclose(fapl_id);
+    if (dcpl_id >= 0)
+        H5Pclose(dcpl_id);
+
+    return ret_value;
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    dset_split_subfile_create
+ *
+ * Purpose:     Creates a dataset of a parallel main file as rank-local
+ *              split files: each rank creates its block, the bounding box
+ *              of its first write, in a split file of its own, with the
+ *              POSIX driver. A rank that wrote nothing gets an empty
+ *              block. Rank 0 then creates the split file whose virtual
+ *              dataset stitches the blocks back together for readers.
+ *              Collective.
+ *
+ * Return:      Success:    Underlying dataset in the rank's split file
+ *              Failure:    NULL, on all ranks
+ *
+ *-------------------------------------------------------------------------
+ */
+static void *
+dset_split_subfile_create(H5VL_dset_split_file_ctx_t *file_ctx, hid_t connector_id,
+                          const H5VL_dset_split_subfile_t *subfile, const H5VL_dset_split_box_t *boxes, int nranks,
+                          hid_t dxpl_id, H5VL_dset_split_pool_entry_t **split_file)
+{
+    const H5VL_dset_split_lazy_t *pending = subfile->pending;
+    const H5VL_dset_split_box_t * box     = &boxes[file_ctx->mpi_rank];
+    H5VL_loc_params_t             file_loc_params;
+    hsize_t                       dims[H5S_MAX_RANK];
+    hsize_t                       chunk_dims[H5S_MAX_RANK];
+    char                          rank_name[1024];
+    hid_t                         fapl_id        = H5I_INVALID_HID;
+    hid_t                         local_space_id = H5I_INVALID_HID;
+    hid_t                         local_dcpl_id  = H5I_INVALID_HID;
+    hid_t                         fid;
+    void *                        under = NULL;
+    hbool_t                       clamped = FALSE;
+    int                           ndims;
+    int                           ok;
+    int                           all_ok = 0;
+    int                           i;
+
+    *split_file = NULL;
+
+    ndims = H5Sget_simple_extent_ndims(subfile->space_id);
+    for (i = 0; i < ndims; i++)
+        dims[i] = box->kind == H5VL_DSET_SPLIT_BOX_SET ? box->last[i] - box->first[i] + 1 : 0;
+
+    /* The rank's block, in a file only this rank accesses */
+    if (dset_split_subfile_name(subfile->file_name, file_ctx->mpi_rank, rank_name, sizeof(rank_name)) < 0)
+        goto sync;
+    if ((fapl_id = H5Pcopy(file_ctx->fapl_id)) < 0 || H5Pset_fapl_sec2(fapl_id) < 0)
+        goto sync;
+    if ((fid = H5Fcreate(rank_name, H5F_ACC_TRUNC, file_ctx->fcpl_id, fapl_id)) < 0)
+        goto sync;
+    if (dset_split_create_attribute(fid, file_ctx->owner) < 0 ||
+        NULL == (*split_file = dset_split_pool_insert(rank_name, fid, H5F_ACC_RDWR))) {
+        H5Fclose(fid);
+        goto sync;
+    }
+
+    /* Chunks can't be larger than the rank's block */
+    if ((local_dcpl_id = H5Pcopy(pending->dcpl_id)) < 0)
+        goto sync;
+    if (H5Pget_layout(local_dcpl_id) == H5D_CHUNKED && H5Pget_chunk(local_dcpl_id, ndims, chunk_dims) == ndims) {
+        for (i = 0; i < ndims; i++)
+            if (chunk_dims[i] > dims[i]) {
+                chunk_dims[i] = dims[i] > 0 ? dims[i] : 1;
+                clamped       = TRUE;
+            }
+        if (clamped && H5Pset_chunk(local_dcpl_id, ndims, chunk_dims) < 0)
+            goto sync;
+    }
+    if ((local_space_id = H5Screate_simple(ndims, dims, NULL)) < 0)
+        goto sync;
+
+    file_loc_params.type     = H5VL_OBJECT_BY_SELF;
+    file_loc_params.obj_type = H5I_FILE;
+    under = H5VLdataset_create(H5VLobject((*split_file)->fid), &file_loc_params, connector_id, pending->name,
+                               pending->lcpl_id, pending->type_id, local_space_id, local_dcpl_id, pending->dapl_id,
+                               dxpl_id, NULL);
+
+sync:
+    /* All ranks must have their block before the blocks are stitched together */
+    ok = (under != NULL);
+    MPI_Allreduce(&ok, &all_ok, 1, MPI_INT, MPI_MIN, file_ctx->comm);
+    if (all_ok) {
+        if (file_ctx->mpi_rank == 0)
+            all_ok = (dset_split_subfile_stitch(file_ctx, subfile->file_name, pending->name, pending->type_id,
+                                                subfile->space_id, boxes, nranks) >= 0);
+        MPI_Bcast(&all_ok, 1, MPI_INT, 0, file_ctx->comm);
+    }
+
+    if (!all_ok) {
+        if (under)
+            H5VLdataset_close(under, connector_id, dxpl_id, NULL);
+        under = NULL;
+        if (*split_file)
+            dset_split_pool_release(*split_file);
+        *split_file = NULL;
+    }
+
+    if (local_space_id >= 0)
+        H5Sclose(local_space_id);
+    if (local_dcpl_id >= 0)
+        H5Pclose(local_dcpl_id);
+    if (fapl_id >= 0)
+        H5Pclose(fapl_id);
+
+    return under;
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    dset_split_subfile_box
+ *
+ * Purpose:     Gets the bounding box of the selection 'file_space_id' in
+ *              the dataset, H5S_ALL for all of it, H5I_INVALID_HID when
+ *              the rank has no selection to go by
+ *
+ *-------------------------------------------------------------------------
+ */
+static void
+dset_split_subfile_box(const H5VL_dset_split_subfile_t *subfile, hid_t file_space_id, H5VL_dset_split_box_t *box)
+{
+    hsize_t  dims[H5S_MAX_RANK];
+    hssize_t npoints;
+    int      ndims;
+    int      i;
+
+    memset(box, 0, sizeof(*box));
+    box->kind = H5VL_DSET_SPLIT_BOX_UNKNOWN;
+    if (file_space_id == H5I_INVALID_HID)
+        return;
+
+    if (file_space_id == H5S_ALL) {
+        if ((ndims = H5Sget_simple_extent_dims(subfile->space_id, dims, NULL)) < 1)
+            return;
+        box->kind = H5VL_DSET_SPLIT_BOX_SET;
+        for (i = 0; i < ndims; i++) {
+            if (dims[i] == 0)
+                box->kind = H5VL_DSET_SPLIT_BOX_EMPTY;
+            else
+                box->last[i] = dims[i] - 1;
+        }
+    }
+    else if ((npoints = H5Sget_select_npoints(file_space_id)) == 0)
+        box->kind = H5VL_DSET_SPLIT_BOX_EMPTY;
+    else if (npoints > 0 && H5Sget_select_bounds(file_space_id, box->first, box->last) >= 0)
+        box->kind = H5VL_DSET_SPLIT_BOX_SET;
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    dset_split_subfile_layout
+ *
+ * Purpose:     Lays out a dataset set up by dset_split_subfile_new(), on
+ *              its first collective write: the ranks exchange the bounding
+ *              boxes of their selections 'file_space_id'. If the boxes
+ *              are disjoint, whatever the decomposition, each rank's box
+ *              becomes its block in a rank-local split file. If they
+ *              overlap, or some rank passes H5I_INVALID_HID as it lays
+ *              the dataset out for another reason, the dataset goes to
+ *              one split file created collectively, as without
+ *              subfiling. Collective.
+ *
+ * Return:      Success:    0
+ *              Failure:    -1, on all ranks; the dataset stays pending
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+dset_split_subfile_layout(H5VL_dset_split_t *o, hid_t file_space_id, hid_t dxpl_id)
+{
+    H5VL_dset_split_file_ctx_t *  file_ctx = o->file_ctx;
+    H5VL_dset_split_subfile_t *   subfile  = o->subfile;
+    H5VL_dset_split_lazy_t *      pending  = subfile->pending;
+    H5VL_dset_split_pool_entry_t *entry    = NULL;
+    H5VL_dset_split_box_t *       boxes    = NULL;
+    H5VL_dset_split_box_t         box;
+    H5VL_loc_params_t             file_loc_params;
+    hbool_t                       local = TRUE;
+    void *                        under = NULL;
+    hid_t                         fid;
+    int                           nranks;
+    int                           ndims;
+    int                           r;
+    int                           q;
+    int                           i;
+
+    MPI_Comm_size(file_ctx->comm, &nranks);
+    ndims = H5Sget_simple_extent_ndims(subfile->space_id);
+
+    dset_split_subfile_box(subfile, file_space_id, &box);
+    if (NULL == (boxes = (H5VL_dset_split_box_t *)malloc((size_t)nranks * sizeof(H5VL_dset_split_box_t))))
+        return -1;
+    if (MPI_Allgather(&box, (int)sizeof(box), MPI_BYTE, boxes, (int)sizeof(box), MPI_BYTE, file_ctx->comm) !=
+        MPI_SUCCESS) {
+        free(boxes);
+        return -1;
+    }
+
+    /* Each rank keeps its block only if no other rank writes in it */
+    for (r = 0; r < nranks && local; r++) {
+        if (boxes[r].kind == H5VL_DSET_SPLIT_BOX_UNKNOWN)
+            local = FALSE;
+        for (q = 0; q < r && local && boxes[r].kind == H5VL_DSET_SPLIT_BOX_SET; q++) {
+            if (boxes[q].kind != H5VL_DSET_SPLIT_BOX_SET)
+                continue;
+            for (i = 0; i < ndims && boxes[r].first[i] <= boxes[q].last[i] && boxes[q].first[i] <= boxes[r].last[i];
+                 i++)
+                ;
+            if (i == ndims)
+                local = FALSE;
+        }
+    }
+
+    if (local)
+        under = dset_split_subfile_create(file_ctx, o->under_vol_id, subfile, boxes, nranks, dxpl_id, &entry);
+    else if ((fid = dset_split_file_create(subfile->file_name, file_ctx, H5F_ACC_TRUNC)) >= 0) {
+        if (dset_split_create_attribute(fid, file_ctx->owner) < 0 ||
+            NULL == (entry = dset_split_pool_insert(subfile->file_name, fid, H5F_ACC_RDWR)))
+            H5Fclose(fid);
+        else {
+            file_loc_params.type     = H5VL_OBJECT_BY_SELF;
+            file_loc_params.obj_type = H5I_FILE;
+            if (NULL == (under = H5VLdataset_create(H5VLobject(fid), &file_loc_params, o->under_vol_id, pending->name,
+                                                    pending->lcpl_id, pending->type_id, pending->space_id,
+                                                    pending->dcpl_id, pending->dapl_id, dxpl_id, NULL))) {
+                dset_split_pool_release(entry);
+                entry = NULL;
+            }
+        }
+    }
+    if (!under) {
+        free(boxes);
+        return -1;
+    }
+
+    o->under_object = under;
+    o->fid          = entry->fid;
+    o->set          = 1;
+    o->split_file   = entry;
+    dset_split_user_bind(o);
+
+    if (local) {
+        box = boxes[file_ctx->mpi_rank];
+        for (i = 0; i < ndims; i++) {
+            subfile->start[i] = box.kind == H5VL_DSET_SPLIT_BOX_SET ? box.first[i] : 0;
+            subfile->count[i] = box.kind == H5VL_DSET_SPLIT_BOX_SET ? box.last[i] - box.first[i] + 1 : 0;
+        }
+        subfile->pending = NULL;
+        dset_split_subfile_free_pending(pending);
+    }
+    else {
+        dset_split_subfile_free(subfile);
+        o->subfile = NULL;
+    }
+    free(boxes);
+
+    return 0;
+}
+#endif /* H5_HAVE_PARALLEL */
+
+/*-------------------------------------------------------------------------
+ * Function:    dset_split_file_linked
+ *
+ * Purpose:     Checks whether an external link of the main file, queued
+ *              or inserted, points to the split file 'file_name'. A
+ *              dataset moved or linked elsewhere keeps the split file
+ *              named after its first path. The whole main file is
+ *              visited, only done when a split file is in the way.
+ *
+ * Return:      Success:    1 if a link points to the split file, 0 if
+ *                          none does
+ *              Failure:    -1
+ *
+ *-------------------------------------------------------------------------
+ */
+static int
+dset_split_file_linked(H5VL_dset_split_t *o, const H5VL_loc_params_t *loc_params,
+                       const H5VL_dset_split_file_ctx_t *file_ctx, const char *file_name)
+{
+    H5VL_dset_split_link_t *  link;
+    H5VL_link_specific_args_t spec_args;
+    H5VL_link_get_args_t      get_args;
+    H5VL_loc_params_t         link_loc_params;
+    H5VL_dset_split_names_t   list = {NULL, 0, 0};
+    H5L_info2_t               linfo;
+    void *                    linkval;
+    const char *              link_file;
+    const char *              obj_path;
+    unsigned                  link_flags;
+    char *                    path;
+    size_t                    u;
+    int                       ret_value = 0;
+
+    for (link = file_ctx->link_head; link; link = link->next)
+        if (!strcmp(link->file_name, file_name))
+            return 1;
+
+    link_loc_params.type                         = H5VL_OBJECT_BY_NAME;
+    link_loc_params.loc_data.loc_by_name.name    = "/";
+    link_loc_params.loc_data.loc_by_name.lapl_id = H5P_LINK_ACCESS_DEFAULT;
+    link_loc_params.obj_type                     = loc_params->obj_type;
+
+    spec_args.op_type                = H5VL_LINK_ITER;
+    spec_args.args.iterate.recursive = TRUE;
+    spec_args.args.iterate.idx_type  = H5_INDEX_NAME;
+    spec_args.args.iterate.order     = H5_ITER_NATIVE;
+    spec_args.args.iterate.idx_p     = NULL;
+    spec_args.args.iterate.op        = dset_split_mirror_collect;
+    spec_args.args.iterate.op_data   = &list;
+    if (H5VLlink_specific(o->under_object, &link_loc_params, o->under_vol_id, &spec_args,
+                          H5P_DATASET_XFER_DEFAULT, NULL) < 0)
+        ret_value = -1;
+
+    for (u = 0; u < list.count && ret_value == 0; u++) {
+        if (NULL == (path = (char *)malloc(strlen(list.names[u]) + 2))) {
+            ret_value = -1;
+            break;
+        }
+        sprintf(path, "/%s", list.names[u]);
+        link_loc_params.loc_data.loc_by_name.name = path;
+
+        linkval                      = NULL;
+        get_args.op_type             = H5VL_LINK_GET_INFO;
+        get_args.args.get_info.linfo = &linfo;
+        if (H5VLlink_get(o->under_object, &link_loc_params, o->under_vol_id, &get_args, H5P_DATASET_XFER_DEFAULT,
+                         NULL) < 0 ||
+            NULL == (linkval = malloc(linfo.u.val_size)))
+            ret_value = -1;
+        else {
+            get_args.op_type               = H5VL_LINK_GET_VAL;
+            get_args.args.get_val.buf_size = linfo.u.val_size;
+            get_args.args.get_val.buf      = linkval;
+            if (H5VLlink_get(o->under_object, &link_loc_params, o->under_vol_id, &get_args,
+                             H5P_DATASET_XFER_DEFAULT, NULL) < 0 ||
+                H5Lunpack_elink_val(linkval, linfo.u.val_size, &link_flags, &link_file, &obj_path) < 0)
+                ret_value = -1;
+            else if (!strcmp(link_file, file_name))
+                ret_value = 1;
+        }
+        free(linkval);
+        free(path);
+    }
+
+    for (u = 0; u < list.count; u++)
+        free(list.names[u]);
+    free(list.names);
+
+    return ret_value;
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    dset_split_reclaim_stale
+ *
+ * Purpose:     Makes way for a new split file at 'file_name', which
+ *              already exists. That is fine if it was left by an earlier
+ *              run or by a deleted dataset, but not if the dataset 'name'
+ *              exists or the split file belongs to another main file
+ *              sharing the split folder. A split file still in use, by a
+ *              dataset moved away from 'name' or by an open dataset, is
+ *              kept and the new one takes another name.
+ *
+ * Return:      Success:    0, the split file may be overwritten, or 1,
+ *                          it must be kept
+ *              Failure:    -1
+ *
+ *-------------------------------------------------------------------------
+ */
+static int
+dset_split_reclaim_stale(H5VL_dset_split_t *o, const H5VL_loc_params_t *loc_params, const char *name,
+                         const H5VL_dset_split_file_ctx_t *file_ctx, const char *file_name)
+{
+    H5VL_dset_split_pool_entry_t *entry;
+    H5VL_link_specific_args_t     vol_cb_args;
+    H5VL_loc_params_t             link_loc_params;
+    hbool_t                       exists = FALSE;
+    hbool_t                       owned;
+    herr_t                        status;
+    hid_t                         fid;
+    int                           linked;
+
+    link_loc_params.type                         = H5VL_OBJECT_BY_NAME;
+    link_loc_params.loc_data.loc_by_name.name    = name;
+    link_loc_params.loc_data.loc_by_name.lapl_id = H5P_LINK_ACCESS_DEFAULT;
+    link_loc_params.obj_type                     = loc_params->obj_type;
+
+    vol_cb_args.op_type            = H5VL_LINK_EXISTS;
+    vol_cb_args.args.exists.exists = &exists;
+    H5E_BEGIN_TRY {
+        status = H5VLlink_specific(o->under_object, &link_loc_params, o->under_vol_id, &vol_cb_args,
+                                   H5P_DATASET_XFER_DEFAULT, NULL);
+    } H5E_END_TRY;
+    if (status >= 0 && exists)
+        return -1;
+
+    /* Only split files of this main file are overwritten */
+    if (NULL != (entry = dset_split_pool_lookup(file_name)))
+        owned = dset_split_is_owner(entry->fid, file_ctx->owner);
+    else {
+        H5E_BEGIN_TRY {
+            fid = H5Fopen(file_name, H5F_ACC_RDONLY, file_ctx->fapl_id);
+        } H5E_END_TRY;
+        if (fid < 0)
+            return -1;
+        owned = dset_split_is_owner(fid, file_ctx->owner);
+        H5Fclose(fid);
+    }
+    if (!owned)
+        return -1;
+
+    /* Keep the split file of a dataset moved away, or still open */
+    if (entry && entry->nrefs > 0)
+        linked = 1;
+    else if ((linked = dset_split_file_linked(o, loc_params, file_ctx, file_name)) < 0)
+        return -1;
+    if (linked) {
+#ifdef H5_HAVE_PARALLEL
+        /* The ranks would have to agree on another name */
+        if (file_ctx->comm != MPI_COMM_NULL)
+            return -1;
+#endif
+        return 1;
+    }
+
+    /* Close the old split file if the pool kept it open */
+    if (entry) {
+        H5VL_dset_split_pool_g.nidle--;
+        dset_split_pool_remove(entry);
+    }
+
+    return 0;
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    dset_split_fresh_file_name
+ *
+ * Purpose:     Changes the split file name 'file_name' into a free one,
+ *              "<name>-<n>.split", next to it
+ *
+ * Return:      Success:    0
+ *              Failure:    -1, if the name does not fit in 'size'
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+dset_split_fresh_file_name(char *file_name, size_t size)
+{
+    size_t   base_len = strlen(file_name) - strlen(FILE_EXTENTION);
+    char *   base;
+    unsigned n;
+    herr_t   ret_value = -1;
+
+    if (NULL == (base = strndup(file_name, base_len)))
+        return -1;
+    for (n = 1; n > 0; n++) {
+        if ((size_t)snprintf(file_name, size, "%s-%u%s", base, n, FILE_EXTENTION) >= size)
+            break;
+        if (access(file_name, F_OK) != 0 && !dset_split_pool_lookup(file_name)) {
+            ret_value = 0;
+            break;
+        }
+    }
+    free(base);
+
+    return ret_value;
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    dset_split_bundle_open
+ *
+ * Purpose:     Finds, or creates, the split file shared by the datasets of
+ *              the group at 'group_path'. Its name is returned in
+ *              'file_name'.
+ *
+ * Return:      Success:    Pool entry of the group's split file
+ *              Failure:    NULL
+ *
+ *-------------------------------------------------------------------------
+ */
+static H5VL_dset_split_pool_entry_t *
+dset_split_bundle_open(const char *group_path, H5VL_dset_split_file_ctx_t *file_ctx, char *file_name,
+                       size_t size)
+{
+    H5VL_dset_split_pool_entry_t *entry   = NULL;
+    char                          shards[3 * H5VL_DSET_SPLIT_SHARD_LEVELS_MAX + 1];
+    char *                        escaped = NULL;
+    char *                        dir;
+    size_t                        len;
+    hid_t                         fid;
+
+    if (NULL == (escaped = dset_split_escape_path(group_path)))
+        goto done;
+    if (file_ctx->mirror_groups) {
+        /* "%2E" in the group's own subfolder, a name no dataset escapes to
+         * and that stays right when the group is renamed */
+        if (NULL == (dir = dset_split_mirror_dir(group_path, strlen(group_path))))
+            goto done;
+        len = (size_t)snprintf(file_name, size, "%s/%s%%2E%s", file_ctx->split_folder, dir, FILE_EXTENTION);
+        free(dir);
+    }
+    else {
+        dset_split_shard_prefix(file_ctx, dset_split_hash_str(group_path), shards);
+        len = (size_t)snprintf(file_name, size, "%s/%s%s%s", file_ctx->split_folder, shards, escaped, FILE_EXTENTION);
+    }
+    if (len >= size)
+        goto done;
+
+    /* Reuse the bundle if it is open or already on disk, unless another main file owns it */
+    H5E_BEGIN_TRY {
+        entry = dset_split_pool_open(file_name, H5F_ACC_RDWR, file_ctx->fapl_id);
+    } H5E_END_TRY;
+    if (entry) {
+        if (!dset_split_is_owner(entry->fid, file_ctx->owner)) {
+            dset_split_pool_release(entry);
+            entry = NULL;
+        }
+        goto done;
+    }
+
+    if (dset_split_prepare_folder(file_ctx, file_name, size) < 0)
+        goto done;
+    if ((fid = dset_split_file_create(file_name, file_ctx, H5F_ACC_EXCL)) < 0)
+        goto done;
+    if (dset_split_create_attribute(fid, file_ctx->owner) < 0 ||
+        NULL == (entry = dset_split_pool_insert(file_name, fid, H5F_ACC_RDWR))) {
+        H5Fclose(fid);
+        unlink(file_name);
+    }
+
+done:
+    free(escaped);
+
+    return entry;
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    dset_split_dataset_open_pooled
+ *
+ * Purpose:     Resolves the external link 'name' of a split dataset and
+ *              opens the dataset in its split file, borrowing the split
+ *              file from the pool instead of reopening it
+ *
+ * Return:      Success:    Pointer to the underlying dataset object
+ *              Failure:    NULL, the caller opens the dataset through the link
+ *
+ *-------------------------------------------------------------------------
+ */
+static void *
+dset_split_dataset_open_pooled(H5VL_dset_split_t *o, const H5VL_loc_params_t *loc_params, const char *name,
+                               hid_t dapl_id, hid_t dxpl_id, void **req, H5VL_dset_split_pool_entry_t **split_file)
+{
+    H5VL_link_get_args_t link_args;
+    H5VL_loc_params_t    link_loc_params;
+    H5VL_loc_params_t    file_loc_params;
+    H5L_info2_t          linfo;
+    H5VL_dset_split_file_ctx_t *file_ctx;
+    void *               linkval = NULL;
+    const char *         file_name;
+    const char *         obj_path;
+    unsigned             link_flags;
+    herr_t               status;
+    hid_t                gov_dapl_id = H5I_INVALID_HID;
+    void *               under = NULL;
+
+    *split_file = NULL;
+
+    if (loc_params->type != H5VL_OBJECT_BY_SELF)
+        goto done;
+
+    link_loc_params.type                         = H5VL_OBJECT_BY_NAME;
+    link_loc_params.loc_data.loc_by_name.name    = name;
+    link_loc_params.loc_data.loc_by_name.lapl_id = H5P_LINK_ACCESS_DEFAULT;
+    link_loc_params.obj_type                     = loc_params->obj_type;
+
+    link_args.op_type             = H5VL_LINK_GET_INFO;
+    link_args.args.get_info.linfo = &linfo;
+    H5E_BEGIN_TRY {
+        status = H5VLlink_get(o->under_object, &link_loc_params, o->under_vol_id, &link_args, dxpl_id, NULL);
+    } H5E_END_TRY;
+    if (status < 0 || linfo.type != H5L_TYPE_EXTERNAL)
+        goto done;
+
+    if (NULL == (linkval = malloc(linfo.u.val_size)))
+        goto done;
+    link_args.op_type               = H5VL_LINK_GET_VAL;
+    link_args.args.get_val.buf_size = linfo.u.val_size;
+    link_args.args.get_val.buf      = linkval;
+    if (H5VLlink_get(o->under_object, &link_loc_params, o->under_vol_id, &link_args, dxpl_id, NULL) < 0)
+        goto done;
+    if (H5Lunpack_elink_val(linkval, linfo.u.val_size, &link_flags, &file_name, &obj_path) < 0)
+        goto done;
+
+    /* Open the split file with the access flags and properties of the main file */
+    if (NULL == (file_ctx = dset_split_file_ctx_get(o, loc_params->obj_type)))
+        goto done;
+
+    if (NULL == (*split_file = dset_split_pool_open(file_name, (file_ctx->intent & H5F_ACC_RDWR) ? H5F_ACC_RDWR : H5F_ACC_RDONLY,
+                                                    file_ctx->fapl_id)))
+        goto done;
+
+    file_loc_params.type     = H5VL_OBJECT_BY_SELF;
+    file_loc_params.obj_type = H5I_FILE;
+
+    gov_dapl_id = dset_split_gov_dapl(*split_file, dapl_id);
+    if (NULL == (under = H5VLdataset_open(H5VLobject((*split_file)->fid), &file_loc_params, o->under_vol_id, obj_path,
+                                          gov_dapl_id >= 0 ? gov_dapl_id : dapl_id, dxpl_id, req))) {
+        dset_split_pool_release(*split_file);
+        *split_file = NULL;
+    }
+
+done:
+    if (gov_dapl_id >= 0)
+        H5Pclose(gov_dapl_id);
+    if (linkval)
+        free(linkval);
+
+    return under;
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    dset_split_link_find
+ *
+ * Purpose:     Looks for a queued external link of the file
+ *
+ * Return:      The queued link of the dataset at 'path', or NULL
+ *
+ *-------------------------------------------------------------------------
+ */
+static H5VL_dset_split_link_t *
+dset_split_link_find(const H5VL_dset_split_file_ctx_t *file_ctx, const char *path)
+{
+    H5VL_dset_split_link_t *link;
+
+    for (link = file_ctx->link_head; link; link = link->next)
+        if (!strcmp(link->path, path))
+            return link;
+
+    return NULL;
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    dset_split_link_free
+ *
+ * Purpose:     Frees a queued external link
+ *
+ *-------------------------------------------------------------------------
+ */
+static void
+dset_split_link_free(H5VL_dset_split_link_t *link)
+{
+    free(link->path);
+    free(link->file_name);
+    free(link->dsetname);
+    free(link);
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    dset_split_link_queue
+ *
+ * Purpose:     Queues the external link 'name' of a new split dataset
+ *              instead of inserting it in the main file. The name must be
+ *              free in the main file: it is checked now, the insertion
+ *              can't fail later on that.
+ *
+ * Return:      Success:    0 if queued, 1 if the link must be created now
+ *              Failure:    -1, the name is taken
+ *
+ *-------------------------------------------------------------------------
+ */
+static int
+dset_split_link_queue(H5VL_dset_split_t *o, const H5VL_loc_params_t *loc_params, const char *name,
+                      const char *dset_path, const char *file_name, const char *dsetname)
+{
+    H5VL_dset_split_file_ctx_t *file_ctx = o->file_ctx;
+    H5VL_dset_split_link_t *    link;
+    H5VL_link_specific_args_t   vol_cb_args;
+    H5VL_loc_params_t           link_loc_params;
+    hbool_t                     exists = FALSE;
+    herr_t                      status;
+
+    if (!file_ctx->file_under)
+        return 1;
+    if (dset_split_link_find(file_ctx, dset_path))
+        return -1;
+
+    link_loc_params.type                         = H5VL_OBJECT_BY_NAME;
+    link_loc_params.loc_data.loc_by_name.name    = name;
+    link_loc_params.loc_data.loc_by_name.lapl_id = H5P_LINK_ACCESS_DEFAULT;
+    link_loc_params.obj_type                     = loc_params->obj_type;
+    vol_cb_args.op_type                          = H5VL_LINK_EXISTS;
+    vol_cb_args.args.exists.exists               = &exists;
+    H5E_BEGIN_TRY {
+        status = H5VLlink_specific(o->under_object, &link_loc_params, o->under_vol_id, &vol_cb_args,
+                                   H5P_DATASET_XFER_DEFAULT, NULL);
+    } H5E_END_TRY;
+    /* A missing group fails the insertion right away, with the library's error */
+    if (status < 0)
+        return 1;
+    if (exists)
+        return -1;
+
+    if (NULL == (link = (H5VL_dset_split_link_t *)calloc(1, sizeof(H5VL_dset_split_link_t))))
+        return 1;
+    link->path      = strdup(dset_path);
+    link->file_name = strdup(file_name);
+    link->dsetname  = strdup(dsetname);
+    if (!link->path || !link->file_name || !link->dsetname) {
+        dset_split_link_free(link);
+        return 1;
+    }
+    link->next          = file_ctx->link_head;
+    file_ctx->link_head = link;
+    file_ctx->nlinks++;
+
+    return 0;
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    dset_split_link_drop
+ *
+ * Purpose:     Drops the queued external link of the dataset at 'path',
+ *              whose creation failed after the link was queued
+ *
+ *-------------------------------------------------------------------------
+ */
+static void
+dset_split_link_drop(H5VL_dset_split_file_ctx_t *file_ctx, const char *path)
+{
+    H5VL_dset_split_link_t **prev;
+    H5VL_dset_split_link_t * link;
+
+    for (prev = &file_ctx->link_head; *prev; prev = &(*prev)->next)
+        if (!strcmp((*prev)->path, path)) {
+            link  = *prev;
+            *prev = link->next;
+            file_ctx->nlinks--;
+            dset_split_link_free(link);
+            return;
+        }
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    dset_split_link_cmp
+ *
+ * Purpose:     Orders queued external links by path, for qsort()
+ *
+ *-------------------------------------------------------------------------
+ */
+static int
+dset_split_link_cmp(const void *a, const void *b)
+{
+    return strcmp((*(H5VL_dset_split_link_t *const *)a)->path, (*(H5VL_dset_split_link_t *const *)b)->path);
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    dset_split_link_commit
+ *
+ * Purpose:     Inserts the queued external links of a file in the main
+ *              file, in path order so that the links of a group go in
+ *              together
+ *
+ * Return:      Success:    0
+ *              Failure:    -1, the links not inserted stay queued
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+dset_split_link_commit(H5VL_dset_split_file_ctx_t *file_ctx, hid_t connector_id)
+{
+    H5VL_dset_split_link_t **links;
+    H5VL_dset_split_link_t * link;
+    H5VL_loc_params_t        loc_params;
+    size_t                   n;
+    size_t                   u;
+    herr_t                   ret_value = 0;
+
+    if (!file_ctx->link_head)
+        return 0;
+    if (NULL == (links = (H5VL_dset_split_link_t **)malloc(file_ctx->nlinks * sizeof(*links))))
+        return -1;
+    for (n = 0, link = file_ctx->link_head; link; link = link->next)
+        links[n++] = link;
+    qsort(links, n, sizeof(*links), dset_split_link_cmp);
+
+    loc_params.type     = H5VL_OBJECT_BY_SELF;
+    loc_params.obj_type = H5I_FILE;
+    for (u = 0; u < n; u++) {
+        if (dset_split_extlink_create(links[u]->file_name, links[u]->dsetname, links[u]->path, &loc_params,
+                                      file_ctx->file_under, connector_id, H5P_LINK_CREATE_DEFAULT,
+                                      H5P_LINK_CREATE_DEFAULT, H5P_DATASET_XFER_DEFAULT, NULL) < 0) {
+            ret_value = -1;
+            break;
+        }
+        dset_split_link_free(links[u]);
+    }
+
+    /* Keep the links left */
+    file_ctx->link_head = NULL;
+    file_ctx->nlinks    = n - u;
+    while (n-- > u) {
+        links[n]->next      = file_ctx->link_head;
+        file_ctx->link_head = links[n];
+    }
+    free(links);
+
+    return ret_value;
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    dset_split_link_sync
+ *
+ * Purpose:     Inserts the queued external links of the file of an
+ *              object before an operation that reads or changes the
+ *              links of the main file
+ *
+ * Return:      Success:    0
+ *              Failure:    -1
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+dset_split_link_sync(const H5VL_dset_split_t *o)
+{
+    if (!o || !o->file_ctx || !o->file_ctx->link_head)
+        return 0;
+
+    return dset_split_link_commit(o->file_ctx, o->under_vol_id);
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    dset_split_link_resolve
+ *
+ * Purpose:     Finds the queued external link a name relative to an
+ *              object stands for
+ *
+ * Return:      The queued link, or NULL
+ *
+ *-------------------------------------------------------------------------
+ */
+static H5VL_dset_split_link_t *
+dset_split_link_resolve(H5VL_dset_split_t *o, const H5VL_loc_params_t *loc_params, const char *name)
+{
+    H5VL_dset_split_link_t *link = NULL;
+    char *                  group_path = NULL;
+    char *                  dset_path  = NULL;
+    char *                  temp_path;
+    char *                  dsetname;
+
+    if (!o->file_ctx || !o->file_ctx->link_head || !name)
+        return NULL;
+    if (NULL == (temp_path = strdup(name)))
+        return NULL;
+    if (NULL != (dsetname = get_dataset_name(temp_path)) &&
+        dset_split_get_dataset_path(o, loc_params, name, dsetname, &group_path, &dset_path) >= 0)
+        link = dset_split_link_find(o->file_ctx, dset_path);
+
+    free(group_path);
+    free(dset_path);
+    free(temp_path);
+
+    return link;
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    dset_split_dataset_open_queued
+ *
+ * Purpose:     Opens a split dataset whose external link is still queued,
+ *              in its split file
+ *
+ * Return:      Success:    Pointer to the underlying dataset object
+ *              Failure:    NULL, the caller opens the dataset through the
+ *                          main file
+ *
+ *-------------------------------------------------------------------------
+ */
+static void *
+dset_split_dataset_open_queued(H5VL_dset_split_t *o, const H5VL_loc_params_t *loc_params, const char *name,
+                               hid_t dapl_id, hid_t dxpl_id, void **req, H5VL_dset_split_pool_entry_t **split_file)
+{
+    H5VL_dset_split_link_t *link;
+    H5VL_loc_params_t       file_loc_params;
+    hid_t                   gov_dapl_id;
+    void *                  under = NULL;
+
+    *split_file = NULL;
+
+    if (loc_params->type != H5VL_OBJECT_BY_SELF || NULL == (link = dset_split_link_resolve(o, loc_params, name)))
+        return NULL;
+
+    if (NULL == (*split_file = dset_split_pool_open(link->file_name,
+                                                    (o->file_ctx->intent & H5F_ACC_RDWR) ? H5F_ACC_RDWR
+                                                                                          : H5F_ACC_RDONLY,
+                                                    o->file_ctx->fapl_id)))
+        return NULL;
+
+    file_loc_params.type     = H5VL_OBJECT_BY_SELF;
+    file_loc_params.obj_type = H5I_FILE;
+    gov_dapl_id              = dset_split_gov_dapl(*split_file, dapl_id);
+    if (NULL == (under = H5VLdataset_open(H5VLobject((*split_file)->fid), &file_loc_params, o->under_vol_id,
+                                          link->dsetname, gov_dapl_id >= 0 ? gov_dapl_id : dapl_id, dxpl_id,
+                                          req))) {
+        dset_split_pool_release(*split_file);
+        *split_file = NULL;
+    }
+    if (gov_dapl_id >= 0)
+        H5Pclose(gov_dapl_id);
+
+    return under;
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    dset_split_mirror_relink
+ *
+ * Purpose:     Points the external link 'path' of a split dataset to its
+ *              split file, renamed from 'old_name' to 'new_name', or
+ *              moved with its subfolder when both end with '/'. Other
+ *              links are left alone.
+ *
+ * Return:      Success:    1 if the link was repointed, 0 if it is not
+ *                          one to 'old_name'
+ *              Failure:    -1
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+dset_split_mirror_relink(H5VL_dset_split_t *o, H5I_type_t obj_type, const char *path, const char *old_name,
+                         const char *new_name)
+{
+    H5VL_link_get_args_t      get_args;
+    H5VL_link_specific_args_t spec_args;
+    H5VL_loc_params_t         loc_params;
+    H5L_info2_t               linfo;
+    void *                    linkval   = NULL;
+    char *                    file_name = NULL;
+    const char *              old_file;
+    const char *              obj_path;
+    unsigned                  link_flags;
+    size_t                    old_len = strlen(old_name);
+    herr_t                    ret_value = -1;
+
+    loc_params.type                         = H5VL_OBJECT_BY_NAME;
+    loc_params.loc_data.loc_by_name.name    = path;
+    loc_params.loc_data.loc_by_name.lapl_id = H5P_LINK_ACCESS_DEFAULT;
+    loc_params.obj_type                     = obj_type;
+
+    get_args.op_type             = H5VL_LINK_GET_INFO;
+    get_args.args.get_info.linfo = &linfo;
+    if (H5VLlink_get(o->under_object, &loc_params, o->under_vol_id, &get_args, H5P_DATASET_XFER_DEFAULT, NULL) < 0)
+        return -1;
+    if (linfo.type != H5L_TYPE_EXTERNAL)
+        return 0;
+
+    if (NULL == (linkval = malloc(linfo.u.val_size)))
+        return -1;
+    get_args.op_type               = H5VL_LINK_GET_VAL;
+    get_args.args.get_val.buf_size = linfo.u.val_size;
+    get_args.args.get_val.buf      = linkval;
+    if (H5VLlink_get(o->under_object, &loc_params, o->under_vol_id, &get_args, H5P_DATASET_XFER_DEFAULT, NULL) < 0 ||
+        H5Lunpack_elink_val(linkval, linfo.u.val_size, &link_flags, &old_file, &obj_path) < 0)
+        goto done;
+    if (strncmp(old_file, old_name, old_len) != 0 || (old_name[old_len - 1] != '/' && old_file[old_len] != '\0')) {
+        ret_value = 0;
+        goto done;
+    }
+    if (NULL == (file_name = (char *)malloc(strlen(new_name) + strlen(old_file + old_len) + 1)))
+        goto done;
+    sprintf(file_name, "%s%s", new_name, old_file + old_len);
+
+    spec_args.op_type = H5VL_LINK_DELETE;
+    if (H5VLlink_specific(o->under_object, &loc_params, o->under_vol_id, &spec_args, H5P_DATASET_XFER_DEFAULT,
+                          NULL) < 0)
+        goto done;
+    if (dset_split_extlink_create(file_name, (char *)obj_path + (obj_path[0] == '/'), path, &loc_params,
+                                  o->under_object, o->under_vol_id, H5P_LINK_CREATE_DEFAULT, H5P_LINK_ACCESS_DEFAULT,
+                                  H5P_DATASET_XFER_DEFAULT, NULL) >= 0)
+        ret_value = 1;
+
+done:
+    free(file_name);
+    free(linkval);
+
+    return ret_value;
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    dset_split_mirror_collect
+ *
+ * Purpose:     Link iteration callback gathering the names of the
+ *              external links below a group
+ *
+ * Return:      Success:    0
+ *              Failure:    -1
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+dset_split_mirror_collect(hid_t group, const char *name, const H5L_info2_t *info, void *op_data)
+{
+    H5VL_dset_split_names_t *list = (H5VL_dset_split_names_t *)op_data;
+    char **                  names;
+
+    (void)group;
+    if (info->type != H5L_TYPE_EXTERNAL)
+        return 0;
+    if (list->count == list->nalloc) {
+        list->nalloc = list->nalloc ? 2 * list->nalloc : 64;
+        if (NULL == (names = (char **)realloc(list->names, list->nalloc * sizeof(char *))))
+            return -1;
+        list->names = names;
+    }
+    if (NULL == (list->names[list->count] = strdup(name)))
+        return -1;
+    list->count++;
+
+    return 0;
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    dset_split_mirror_rename
+ *
+ * Purpose:     Keeps the mirrored layout of the split folder in step with
+ *              the link moved from 'old_path' to 'new_path': renames the
+ *              split file of a moved dataset, or the subfolder of a moved
+ *              group, and repoints the external links to the new names.
+ *              The move itself is done: if a split file or subfolder
+ *              can't be renamed, it keeps its name and the links still
+ *              point to it.
+ *
+ *-------------------------------------------------------------------------
+ */
+static void
+dset_split_mirror_rename(H5VL_dset_split_t *o, H5I_type_t obj_type, const char *old_path, const char *new_path)
+{
+    H5VL_dset_split_file_ctx_t *file_ctx = o->file_ctx;
+    H5VL_link_get_args_t        get_args;
+    H5VL_link_specific_args_t   spec_args;
+    H5VL_loc_params_t           loc_params;
+    H5L_info2_t                 linfo;
+    H5VL_dset_split_names_t     list = {NULL, 0, 0};
+    char                        old_name[1000];
+    char                        new_name[1000];
+    char *                      old_dir = NULL;
+    char *                      new_dir = NULL;
+    char *                      path;
+    size_t                      u;
+
+    loc_params.type                         = H5VL_OBJECT_BY_NAME;
+    loc_params.loc_data.loc_by_name.name    = new_path;
+    loc_params.loc_data.loc_by_name.lapl_id = H5P_LINK_ACCESS_DEFAULT;
+    loc_params.obj_type                     = obj_type;
+
+    get_args.op_type             = H5VL_LINK_GET_INFO;
+    get_args.args.get_info.linfo = &linfo;
+    if (H5VLlink_get(o->under_object, &loc_params, o->under_vol_id, &get_args, H5P_DATASET_XFER_DEFAULT, NULL) < 0)
+        return;
+
+    if (linfo.type == H5L_TYPE_EXTERNAL) {
+        /* A split dataset, whose split file is named after its old path */
+        if (dset_split_get_file_name(file_ctx, strrchr(old_path, '/') + 1, old_path, old_name, sizeof(old_name)) < 0 ||
+            dset_split_get_file_name(file_ctx, strrchr(new_path, '/') + 1, new_path, new_name, sizeof(new_name)) < 0 ||
+            access(new_name, F_OK) == 0 || dset_split_make_folders(file_ctx, new_name) < 0)
+            return;
+        if (dset_split_mirror_relink(o, obj_type, new_path, old_name, new_name) <= 0)
+            return;
+        if (rename(old_name, new_name) < 0) {
+            dset_split_mirror_relink(o, obj_type, new_path, new_name, old_name);
+            return;
+        }
+        dset_split_pool_rename(old_name, new_name);
+        return;
+    }
+
+    /* A group, whose subfolder holds the split files below it */
+    if (NULL == (old_dir = dset_split_mirror_dir(old_path, strlen(old_path))) ||
+        NULL == (new_dir = dset_split_mirror_dir(new_path, strlen(new_path))) || !old_dir[0] || !new_dir[0])
+        goto done;
+    if ((size_t)snprintf(old_name, sizeof(old_name), "%s/%s", file_ctx->split_folder, old_dir) >= sizeof(old_name) ||
+        (size_t)snprintf(new_name, sizeof(new_name), "%s/%s", file_ctx->split_folder, new_dir) >= sizeof(new_name))
+        goto done;
+    if (access(old_name, F_OK) != 0 || access(new_name, F_OK) == 0)
+        goto done;
+
+    /* Parent subfolders, then the subfolder itself, without its '/' */
+    new_name[strlen(new_name) - 1] = '\0';
+    if (dset_split_make_folders(file_ctx, new_name) < 0)
+        goto done;
+    old_name[strlen(old_name) - 1] = '\0';
+    if (rename(old_name, new_name) < 0)
+        goto done;
+    strcat(old_name, "/");
+    strcat(new_name, "/");
+    free(file_ctx->dir_ready);
+    file_ctx->dir_ready = NULL;
+
+    /* Repoint the links of the split datasets below the group */
+    spec_args.op_type                  = H5VL_LINK_ITER;
+    spec_args.args.iterate.recursive   = TRUE;
+    spec_args.args.iterate.idx_type    = H5_INDEX_NAME;
+    spec_args.args.iterate.order       = H5_ITER_NATIVE;
+    spec_args.args.iterate.idx_p       = NULL;
+    spec_args.args.iterate.op          = dset_split_mirror_collect;
+    spec_args.args.iterate.op_data     = &list;
+    if (H5VLlink_specific(o->under_object, &loc_params, o->under_vol_id, &spec_args, H5P_DATASET_XFER_DEFAULT,
+                          NULL) < 0)
+        goto done;
+    for (u = 0; u < list.count; u++) {
+        if (NULL == (path = (char *)malloc(strlen(new_path) + strlen(list.names[u]) + 2)))
+            continue;
+        sprintf(path, "%s/%s", new_path, list.names[u]);
+        dset_split_mirror_relink(o, obj_type, path, old_name, new_name);
+        free(path);
+    }
+    dset_split_pool_rename(old_name, new_name);
+
+done:
+    for (u = 0; u < list.count; u++)
+        free(list.names[u]);
+    free(list.names);
+    free(old_dir);
+    free(new_dir);
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    dset_split_reserve_free
+ *
+ * Purpose:     Closes and deletes the split files left in a reserve and
+ *              releases the reserve
+ *
+ *-------------------------------------------------------------------------
+ */
+static void
+dset_split_reserve_free(H5VL_dset_split_reserve_t *reserve)
+{
+    size_t u;
+
+    for (u = 0; u < reserve->count; u++) {
+        H5Fclose(reserve->fids[u]);
+        unlink(reserve->paths[u]);
+        free(reserve->paths[u]);
+    }
+    if (reserve->fcpl_id >= 0)
+        H5Pclose(reserve->fcpl_id);
+    if (reserve->fapl_id >= 0)
+        H5Pclose(reserve->fapl_id);
+    free(reserve->fids);
+    free(reserve->paths);
+    free(reserve->folder);
+    free(reserve->owner);
+    free(reserve);
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    dset_split_reserve_new
+ *
+ * Purpose:     Sets up the reserve of pre-created split files for the
+ *              split folder of a main file
+ *
+ * Return:      Success:    New reserve, empty
+ *              Failure:    NULL
+ *
+ *-------------------------------------------------------------------------
+ */
+static H5VL_dset_split_reserve_t *
+dset_split_reserve_new(const H5VL_dset_split_file_ctx_t *file_ctx)
+{
+    H5VL_dset_split_reserve_t *reserve;
+
+    if (NULL == (reserve = (H5VL_dset_split_reserve_t *)calloc(1, sizeof(H5VL_dset_split_reserve_t))))
+        return NULL;
+    reserve->fcpl_id = H5I_INVALID_HID;
+    reserve->fapl_id = H5I_INVALID_HID;
+    reserve->nalloc  = H5VL_dset_split_precreate_g.target;
+    reserve->folder  = strdup(file_ctx->split_folder);
+    reserve->owner   = strdup(file_ctx->owner);
+    reserve->fids    = (hid_t *)calloc(reserve->nalloc, sizeof(hid_t));
+    reserve->paths   = (char **)calloc(reserve->nalloc, sizeof(char *));
+    if (!reserve->folder || !reserve->owner || !reserve->fids || !reserve->paths)
+        goto error;
+
+    /* The worker outlives the main file's objects, so it keeps its own property lists */
+    if ((reserve->fcpl_id = H5Pcopy(file_ctx->fcpl_id)) < 0)
+        goto error;
+    if ((reserve->fapl_id = H5Pcopy(file_ctx->fapl_id)) < 0)
+        goto error;
+
+#ifdef H5_HAVE_PARALLEL
+    /* Split files of a parallel main file are created collectively, never in the background */
+    if (H5Pget_driver(reserve->fapl_id) == H5FD_MPIO)
+        reserve->failed = TRUE;
+#endif
+
+    if (dset_create_split_folder(reserve->folder) < 0)
+        reserve->failed = TRUE;
+
+    return reserve;
+
+error:
+    dset_split_reserve_free(reserve);
+    return NULL;
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    dset_split_reserve_fill
+ *
+ * Purpose:     Tops up a reserve with empty split files carrying the
+ *              'split_file' marker. Called, and returns, with the reserve
+ *              lock held; the lock is dropped around every HDF5 call, as
+ *              the application thread takes it while holding the HDF5
+ *              library lock.
+ *
+ *-------------------------------------------------------------------------
+ */
+static void
+dset_split_reserve_fill(H5VL_dset_split_reserve_t *reserve)
+{
+    H5VL_dset_split_precreate_t *pre = &H5VL_dset_split_precreate_g;
+    size_t                       len = strlen(reserve->folder) + strlen(H5VL_DSET_SPLIT_RESERVE_PREFIX) +
+                     strlen(FILE_EXTENTION) + 64;
+
+    reserve->busy = TRUE;
+    while (!reserve->failed && !reserve->closing && !pre->shutdown &&
+           reserve->count < reserve->nalloc && reserve->count < pre->target) {
+        unsigned long serial = pre->serial++;
+        char *        path;
+        hid_t         fid = H5I_INVALID_HID;
+
+        pthread_mutex_unlock(&pre->mutex);
+        if (NULL != (path = (char *)malloc(len))) {
+            snprintf(path, len, "%s/%s-%ld-%lu%s", reserve->folder, H5VL_DSET_SPLIT_RESERVE_PREFIX,
+                     (long)getpid(), serial, FILE_EXTENTION);
+            if ((fid = H5Fcreate(path, H5F_ACC_EXCL, reserve->fcpl_id, reserve->fapl_id)) >= 0 &&
+                dset_split_create_attribute(fid, reserve->owner) < 0) {
+                H5Fclose(fid);
+                unlink(path);
+                fid = H5I_INVALID_HID;
+            }
+        }
+        pthread_mutex_lock(&pre->mutex);
+
+        if (fid < 0) {
+            reserve->failed = TRUE;
+            free(path);
+        }
+        else if (reserve->closing) {
+            /* HDF5 calls need the library lock, which is taken before ours */
+            pthread_mutex_unlock(&pre->mutex);
+            H5Fclose(fid);
+            unlink(path);
+            free(path);
+            pthread_mutex_lock(&pre->mutex);
+        }
+        else {
+            reserve->fids[reserve->count]  = fid;
+            reserve->paths[reserve->count] = path;
+            reserve->count++;
+        }
+    }
+    reserve->busy = FALSE;
+
+    /* The main file was closed meanwhile, and left the reserve to us. It is
+     * no longer listed, so nothing else reaches it once the lock is dropped. */
+    if (reserve->closing) {
+        pthread_mutex_unlock(&pre->mutex);
+        dset_split_reserve_free(reserve);
+        pthread_mutex_lock(&pre->mutex);
+    }
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    dset_split_reserve_needs_fill
+ *
+ * Purpose:     Finds a reserve which is below its target. Called with the
+ *              reserve lock held.
+ *
+ * Return:      A reserve to fill, or NULL
+ *
+ *-------------------------------------------------------------------------
+ */
+static H5VL_dset_split_reserve_t *
+dset_split_reserve_needs_fill(void)
+{
+    H5VL_dset_split_precreate_t *pre = &H5VL_dset_split_precreate_g;
+    H5VL_dset_split_reserve_t *  reserve;
+
+    for (reserve = pre->head; reserve; reserve = reserve->next)
+        if (!reserve->busy && !reserve->failed && reserve->count < reserve->nalloc &&
+            reserve->count < pre->target)
+            return reserve;
+
+    return NULL;
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    dset_split_reserve_worker
+ *
+ * Purpose:     Background thread refilling the reserves. Exits when all
+ *              of them are full.
+ *
+ *-------------------------------------------------------------------------
+ */
+static void *
+dset_split_reserve_worker(void *arg)
+{
+    H5VL_dset_split_precreate_t *pre = &H5VL_dset_split_precreate_g;
+    H5VL_dset_split_reserve_t *  reserve;
+
+    (void)arg;
+
+    pthread_mutex_lock(&pre->mutex);
+    while (!pre->shutdown && NULL != (reserve = dset_split_reserve_needs_fill()))
+        dset_split_reserve_fill(reserve);
+    pre->worker_running = FALSE;
+    pthread_mutex_unlock(&pre->mutex);
+
+    return NULL;
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    dset_split_reserve_kick
+ *
+ * Purpose:     Starts the background worker, if it is not running and a
+ *              reserve needs refilling. Called with the reserve lock held.
+ *
+ *-------------------------------------------------------------------------
+ */
+static void
+dset_split_reserve_kick(void)
+{
+    H5VL_dset_split_precreate_t *pre = &H5VL_dset_split_precreate_g;
+
+    if (!pre->threaded || pre->worker_running || pre->shutdown || !dset_split_reserve_needs_fill())
+        return;
+
+    /* The previous worker no longer needs the lock, it is exiting */
+    if (pre->joinable) {
+        pthread_join(pre->worker, NULL);
+        pre->joinable = FALSE;
+    }
+    if (pthread_create(&pre->worker, NULL, dset_split_reserve_worker, NULL) == 0) {
+        pre->worker_running = TRUE;
+        pre->joinable       = TRUE;
+    }
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    dset_split_reserve_stop
+ *
+ * Purpose:     Asks the background worker to exit and waits for it. A
+ *              split file being created is finished first, so the HDF5
+ *              library lock is released meanwhile.
+ *
+ *-------------------------------------------------------------------------
+ */
+static void
+dset_split_reserve_stop(void)
+{
+    H5VL_dset_split_precreate_t *pre = &H5VL_dset_split_precreate_g;
+    pthread_t                    worker;
+    hbool_t                      joinable;
+#ifdef H5_HAVE_THREADSAFE
+    unsigned count;
+#endif
+
+    pthread_mutex_lock(&pre->mutex);
+    pre->shutdown = TRUE;
+    joinable      = pre->joinable;
+    worker        = pre->worker;
+    pre->joinable = FALSE;
+    pthread_mutex_unlock(&pre->mutex);
+    if (!joinable)
+        return;
+
+#ifdef H5_HAVE_THREADSAFE
+    count = dset_split_hdf5_unlock();
+#endif
+    pthread_join(worker, NULL);
+#ifdef H5_HAVE_THREADSAFE
+    dset_split_hdf5_lock(count);
+#endif
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    dset_split_reserve_refill
+ *
+ * Purpose:     Tops up the reserves from the calling thread. Used when the
+ *              HDF5 library is not thread-safe, from places off the
+ *              dataset create path.
+ *
+ *-------------------------------------------------------------------------
+ */
+static void
+dset_split_reserve_refill(void)
+{
+    H5VL_dset_split_precreate_t *pre = &H5VL_dset_split_precreate_g;
+    H5VL_dset_split_reserve_t *  reserve;
+
+    pthread_mutex_lock(&pre->mutex);
+    while (NULL != (reserve = dset_split_reserve_needs_fill()))
+        dset_split_reserve_fill(reserve);
+    pthread_mutex_unlock(&pre->mutex);
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    dset_split_reserve_take
+ *
+ * Purpose:     Takes a pre-created split file from the reserve of the split
+ *              folder, renames it to 'path' and adds it to the split file pool.
+ *              The first call for a folder only sets its reserve up.
+ *
+ * Return:      Success:    Pool entry of the split file
+ *              Failure:    NULL, the caller creates the split file itself
+ *
+ *-------------------------------------------------------------------------
+ */
+static H5VL_dset_split_pool_entry_t *
+dset_split_reserve_take(const H5VL_dset_split_file_ctx_t *file_ctx, const char *path)
+{
+    H5VL_dset_split_precreate_t * pre = &H5VL_dset_split_precreate_g;
+    H5VL_dset_split_reserve_t *   reserve;
+    H5VL_dset_split_pool_entry_t *entry = NULL;
+    char *                        reserve_path;
+    hid_t                         fid;
+
+    /* rename() would silently replace a split file left from an earlier run */
+    if (access(path, F_OK) == 0)
+        return NULL;
+
+    pthread_mutex_lock(&pre->mutex);
+    for (reserve = pre->head; reserve && (strcmp(reserve->folder, file_ctx->split_folder) != 0 ||
+                                          strcmp(reserve->owner, file_ctx->owner) != 0);
+         reserve = reserve->next)
+        ;
+    if (!reserve) {
+        pthread_mutex_unlock(&pre->mutex);
+        if (NULL == (reserve = dset_split_reserve_new(file_ctx)))
+            return NULL;
+        pthread_mutex_lock(&pre->mutex);
+        reserve->next = pre->head;
+        pre->head     = reserve;
+    }
+    if (reserve->count == 0) {
+        dset_split_reserve_kick();
+        pthread_mutex_unlock(&pre->mutex);
+        return NULL;
+    }
+    reserve->count--;
+    fid          = reserve->fids[reserve->count];
+    reserve_path = reserve->paths[reserve->count];
+    dset_split_reserve_kick();
+    pthread_mutex_unlock(&pre->mutex);
+
+    /* Move the split file into place */
+    if (rename(reserve_path, path) < 0) {
+        H5Fclose(fid);
+        unlink(reserve_path);
+    }
+    else if (NULL == (entry = dset_split_pool_insert(path, fid, H5F_ACC_RDWR))) {
+        H5Fclose(fid);
+        unlink(path);
+    }
+    free(reserve_path);
+
+    return entry;
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    dset_split_reserve_drain
+ *
+ * Purpose:     Deletes the pre-created split files of 'folder' (or of all
+ *              folders, if NULL, once the worker has exited) and drops
+ *              their reserves
+ *
+ *-------------------------------------------------------------------------
+ */
+static void
+dset_split_reserve_drain(const char *folder)
+{
+    H5VL_dset_split_precreate_t *pre = &H5VL_dset_split_precreate_g;
+    H5VL_dset_split_reserve_t ** slot;
+    H5VL_dset_split_reserve_t *  reserve;
+
+    if (!folder)
+        dset_split_reserve_stop();
+
+    pthread_mutex_lock(&pre->mutex);
+    slot = &pre->head;
+    while (NULL != (reserve = *slot)) {
+        if (folder && strcmp(reserve->folder, folder) != 0) {
+            slot = &reserve->next;
+            continue;
+        }
+        *slot = reserve->next;
+
+        /* A reserve being filled is released by the worker */
+        if (reserve->busy) {
+            size_t u;
+
+            for (u = 0; u < reserve->count; u++) {
+                H5Fclose(reserve->fids[u]);
+                unlink(reserve->paths[u]);
+                free(reserve->paths[u]);
+            }
+            reserve->count   = 0;
+            reserve->closing = TRUE;
+        }
+        else
+            dset_split_reserve_free(reserve);
+    }
+    pthread_mutex_unlock(&pre->mutex);
+}
+
+#ifdef H5_HAVE_THREADSAFE
+/*-------------------------------------------------------------------------
+ * Function:    dset_split_hdf5_unlock
+ *
+ * Purpose:     Releases the HDF5 library lock held by the calling thread,
+ *              so that the asynchronous workers can call into HDF5 while
+ *              the caller waits for them
+ *
+ * Return:      Lock count to pass to dset_split_hdf5_lock
+ *
+ *-------------------------------------------------------------------------
+ */
+static unsigned
+dset_split_hdf5_unlock(void)
+{
+    unsigned int count = 0;
+
+    if (H5TSmutex_release(&count) < 0)
+        return 0;
+
+    return (unsigned)count;
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    dset_split_hdf5_lock
+ *
+ * Purpose:     Takes the HDF5 library lock back, 'count' times
+ *
+ *-------------------------------------------------------------------------
+ */
+static void
+dset_split_hdf5_lock(unsigned count)
+{
+    hbool_t acquired = FALSE;
+
+    while (count > 0 && !acquired) {
+        if (H5TSmutex_acquire((unsigned int)count, &acquired) < 0)
+            break;
+        if (!acquired)
+            usleep(10);
+    }
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    dset_split_time_usec
+ *
+ * Purpose:     Current time, in microseconds, for the task timings
+ *
+ *-------------------------------------------------------------------------
+ */
+static uint64_t
+dset_split_time_usec(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_REALTIME, &now);
+    return (uint64_t)now.tv_sec * 1000000 + (uint64_t)now.tv_nsec / 1000;
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    dset_split_task_copy_id
+ *
+ * Purpose:     Copies a property list, datatype or dataspace argument of
+ *              an asynchronous operation, the application may close it
+ *              before the operation runs. H5P_DEFAULT and H5S_ALL are
+ *              kept as they are.
+ *
+ * Return:      Success:    The copy
+ *              Failure:    H5I_INVALID_HID
+ *
+ *-------------------------------------------------------------------------
+ */
+static hid_t
+dset_split_task_copy_id(hid_t id)
+{
+    if (id <= 0)
+        return id;
+
+    switch (H5Iget_type(id)) {
+        case H5I_GENPROP_LST:
+            return H5Pcopy(id);
+        case H5I_DATATYPE:
+            return H5Tcopy(id);
+        case H5I_DATASPACE:
+            return H5Scopy(id);
+        default:
+            return H5I_INVALID_HID;
+    }
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    dset_split_task_close_id
+ *
+ * Purpose:     Closes an argument copied by dset_split_task_copy_id
+ *
+ *-------------------------------------------------------------------------
+ */
+static void
+dset_split_task_close_id(hid_t id)
+{
+    if (id <= 0)
+        return;
+
+    switch (H5Iget_type(id)) {
+        case H5I_GENPROP_LST:
+            H5Pclose(id);
+            break;
+        case H5I_DATATYPE:
+            H5Tclose(id);
+            break;
+        case H5I_DATASPACE:
+            H5Sclose(id);
+            break;
+        default:
+            break;
+    }
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    dset_split_task_new
+ *
+ * Purpose:     Creates an asynchronous operation 'op' on 'dset', with a
+ *              copy of the dataset transfer properties 'dxpl_id'
+ *
+ * Return:      Success:    New task, not submitted yet
+ *              Failure:    NULL
+ *
+ *-------------------------------------------------------------------------
+ */
+static H5VL_dset_split_task_t *
+dset_split_task_new(H5VL_dset_split_task_op_t op, H5VL_dset_split_t *dset, hid_t dxpl_id)
+{
+    H5VL_dset_split_task_t *task;
+
+    if (NULL == (task = (H5VL_dset_split_task_t *)calloc(1, sizeof(H5VL_dset_split_task_t))))
+        return NULL;
+    task->op            = op;
+    task->dset          = dset;
+    task->lcpl_id       = H5I_INVALID_HID;
+    task->dcpl_id       = H5I_INVALID_HID;
+    task->dapl_id       = H5I_INVALID_HID;
+    task->type_id       = H5I_INVALID_HID;
+    task->space_id      = H5I_INVALID_HID;
+    task->file_space_id = H5I_INVALID_HID;
+    task->dset_id       = H5I_INVALID_HID;
+    task->err_stack_id  = H5I_INVALID_HID;
+    task->status        = H5VL_REQUEST_STATUS_IN_PROGRESS;
+    task->nrefs         = 1;
+    if ((task->dxpl_id = dset_split_task_copy_id(dxpl_id)) < 0) {
+        free(task);
+        return NULL;
+    }
+
+    return task;
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    dset_split_task_release
+ *
+ * Purpose:     Drops a reference to a task, freeing it with the last one
+ *
+ *-------------------------------------------------------------------------
+ */
+static void
+dset_split_task_release(H5VL_dset_split_task_t *task)
+{
+    H5VL_dset_split_async_t *eng = &H5VL_dset_split_async_g;
+    unsigned                 nrefs;
+
+    pthread_mutex_lock(&eng->mutex);
+    nrefs = --task->nrefs;
+    pthread_mutex_unlock(&eng->mutex);
+    if (nrefs > 0)
+        return;
+
+    dset_split_task_close_id(task->lcpl_id);
+    dset_split_task_close_id(task->dcpl_id);
+    dset_split_task_close_id(task->dapl_id);
+    dset_split_task_close_id(task->type_id);
+    dset_split_task_close_id(task->space_id);
+    dset_split_task_close_id(task->file_space_id);
+    dset_split_task_close_id(task->dxpl_id);
+    if (task->err_stack_id >= 0)
+        H5Eclose_stack(task->err_stack_id);
+    free(task->name);
+    free(task);
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    dset_split_task_run
+ *
+ * Purpose:     Runs an asynchronous operation through the synchronous
+ *              callback, from a worker holding the HDF5 library lock
+ *
+ * Return:      Success:    0
+ *              Failure:    -1
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+dset_split_task_run(H5VL_dset_split_task_t *task)
+{
+    H5VL_dset_split_t *          dset = task->dset;
+    H5VL_dset_split_t *          created;
+    H5VL_loc_params_t            loc_params;
+    H5VL_dataset_specific_args_t specific_args;
+
+    /* The creation of the dataset failed or was canceled, only closing it is left */
+    if (task->op != H5VL_DSET_SPLIT_TASK_CREATE && !dset->under_object) {
+        if (task->op != H5VL_DSET_SPLIT_TASK_CLOSE)
+            return -1;
+        return H5VL_dset_split_free_obj(dset);
+    }
+
+    switch (task->op) {
+        case H5VL_DSET_SPLIT_TASK_CREATE:
+            loc_params.type     = H5VL_OBJECT_BY_SELF;
+            loc_params.obj_type = task->parent_type;
+            if (NULL == (created = (H5VL_dset_split_t *)dset_split_dataset_create(
+                             task->parent, &loc_params, task->name, task->lcpl_id, task->type_id, task->space_id,
+                             task->dcpl_id, task->dapl_id, task->dxpl_id, NULL, 0)))
+                return -1;
+
+            /* Fill the placeholder the application holds in */
+            if (created->file_ctx)
+                dset_split_file_ctx_release(created->file_ctx);
+            created->file_ctx = dset->file_ctx;
+            created->queue    = dset->queue;
+            H5Idec_ref(created->under_vol_id);
+            *dset = *created;
+            dset_split_user_moved(dset);
+            free(created);
+            return 0;
+
+        case H5VL_DSET_SPLIT_TASK_READ:
+            return H5VL_dset_split_dataset_read(dset, task->type_id, task->space_id, task->file_space_id,
+                                                task->dxpl_id, task->buf, NULL);
+
+        case H5VL_DSET_SPLIT_TASK_WRITE:
+            return H5VL_dset_split_dataset_write(dset, task->type_id, task->space_id, task->file_space_id,
+                                                 task->dxpl_id, task->buf, NULL);
+
+        case H5VL_DSET_SPLIT_TASK_FLUSH:
+            specific_args.op_type            = H5VL_DATASET_FLUSH;
+            specific_args.args.flush.dset_id = task->dset_id;
+            return H5VL_dset_split_dataset_specific(dset, &specific_args, task->dxpl_id, NULL);
+
+        case H5VL_DSET_SPLIT_TASK_CLOSE:
+            return H5VL_dset_split_dataset_close(dset, task->dxpl_id, NULL);
+
+        case H5VL_DSET_SPLIT_TASK_PREFETCH:
+            return dset_split_ra_fill(dset, task->dxpl_id);
+
+        default:
+            return -1;
+    }
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    dset_split_async_push_ready
+ *
+ * Purpose:     Hands a queue with a task to run to the workers. Called
+ *              with the engine lock held.
+ *
+ *-------------------------------------------------------------------------
+ */
+static void
+dset_split_async_push_ready(H5VL_dset_split_queue_t *queue)
+{
+    H5VL_dset_split_async_t *eng = &H5VL_dset_split_async_g;
+
+    queue->ready      = TRUE;
+    queue->ready_next = NULL;
+    if (eng->ready_tail)
+        eng->ready_tail->ready_next = queue;
+    else
+        eng->ready_head = queue;
+    eng->ready_tail = queue;
+    pthread_cond_signal(&eng->work_cond);
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    dset_split_async_worker
+ *
+ * Purpose:     Worker thread of the asynchronous engine. Runs the tasks
+ *              of one dataset at a time, in submission order, so that
+ *              different datasets (and split files) progress in parallel
+ *              with the application. Tasks take the HDF5 library lock,
+ *              they run while the application computes.
+ *
+ *-------------------------------------------------------------------------
+ */
+static void *
+dset_split_async_worker(void *arg)
+{
+    H5VL_dset_split_async_t *eng = &H5VL_dset_split_async_g;
+
+    (void)arg;
+
+    pthread_mutex_lock(&eng->mutex);
+    for (;;) {
+        H5VL_dset_split_queue_t *queue;
+        H5VL_dset_split_task_t * task;
+        H5VL_request_notify_t    notify_cb;
+        H5VL_request_status_t    status;
+        void *                   notify_ctx;
+
+        while (!eng->ready_head && !eng->shutdown)
+            pthread_cond_wait(&eng->work_cond, &eng->mutex);
+        if (!eng->ready_head)
+            break;
+
+        queue           = eng->ready_head;
+        eng->ready_head = queue->ready_next;
+        if (!eng->ready_head)
+            eng->ready_tail = NULL;
+        queue->ready = FALSE;
+
+        /* Its tasks were canceled meanwhile */
+        if (NULL == (task = queue->head))
+            continue;
+        queue->head = task->next;
+        if (!queue->head)
+            queue->tail = NULL;
+        queue->running = TRUE;
+        queue->runner  = pthread_self();
+        pthread_mutex_unlock(&eng->mutex);
+
+        dset_split_hdf5_lock(1);
+        task->exec_ts = dset_split_time_usec();
+        status        = dset_split_task_run(task) < 0 ? H5VL_REQUEST_STATUS_FAIL : H5VL_REQUEST_STATUS_SUCCEED;
+        task->exec_time = dset_split_time_usec() - task->exec_ts;
+        if (status == H5VL_REQUEST_STATUS_FAIL)
+            task->err_stack_id = H5Eget_current_stack();
+
+        pthread_mutex_lock(&eng->mutex);
+        task->status    = status;
+        notify_cb       = task->notify_cb;
+        notify_ctx      = task->notify_ctx;
+        task->notify_cb = NULL;
+        queue->running  = FALSE;
+        if (queue->orphaned)
+            free(queue);
+        else if (queue->head)
+            dset_split_async_push_ready(queue);
+        eng->npending--;
+        pthread_cond_broadcast(&eng->done_cond);
+        pthread_mutex_unlock(&eng->mutex);
+
+        if (notify_cb)
+            notify_cb(notify_ctx, status);
+        dset_split_task_release(task);
+        dset_split_hdf5_unlock();
+
+        pthread_mutex_lock(&eng->mutex);
+    }
+    pthread_mutex_unlock(&eng->mutex);
+
+    return NULL;
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    dset_split_async_start
+ *
+ * Purpose:     Starts the worker threads. Called with the engine lock
+ *              held.
+ *
+ * Return:      Success:    0
+ *              Failure:    -1, if no worker could be started
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+dset_split_async_start(void)
+{
+    H5VL_dset_split_async_t *eng      = &H5VL_dset_split_async_g;
+    unsigned                 nthreads = eng->nthreads > 0 ? eng->nthreads : 1; /* Prefetches only */
+    unsigned                 u;
+
+    if (NULL == (eng->workers = (pthread_t *)calloc(nthreads, sizeof(pthread_t))))
+        return -1;
+    for (u = 0; u < nthreads; u++) {
+        if (pthread_create(&eng->workers[eng->nworkers], NULL, dset_split_async_worker, NULL) != 0)
+            break;
+        eng->nworkers++;
+    }
+    if (eng->nworkers == 0) {
+        free(eng->workers);
+        eng->workers = NULL;
+        return -1;
+    }
+
+    return 0;
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    dset_split_async_enabled
+ *
+ * Purpose:     Checks whether an operation on 'o' runs asynchronously:
+ *              the application asked for a request, the engine is on, and
+ *              the main file is not a parallel one, whose collective
+ *              operations must keep the application's order on all ranks
+ *
+ * Return:      TRUE/FALSE
+ *
+ *-------------------------------------------------------------------------
+ */
+static hbool_t
+dset_split_async_enabled(const H5VL_dset_split_t *o, void **req)
+{
+    if (!req || H5VL_dset_split_async_g.nthreads == 0 || !o->file_ctx)
+        return FALSE;
+#ifdef H5_HAVE_PARALLEL
+    if (o->file_ctx->comm != MPI_COMM_NULL)
+        return FALSE;
+#endif
+
+    return TRUE;
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    dset_split_async_submit
+ *
+ * Purpose:     Queues a task behind the other tasks of its dataset and
+ *              returns the request tracking it in '*req', unless 'req' is
+ *              NULL. Starts the workers on first use.
+ *
+ * Return:      Success:    0
+ *              Failure:    -1, the task is left to the caller
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+dset_split_async_submit(H5VL_dset_split_task_t *task, void **req)
+{
+    H5VL_dset_split_async_t *eng  = &H5VL_dset_split_async_g;
+    H5VL_dset_split_t *      dset = task->dset;
+    H5VL_dset_split_queue_t *queue;
+    H5VL_dset_split_t *      request = NULL;
+
+    if (req && NULL == (request = H5VL_dset_split_new_obj(NULL, dset->under_vol_id)))
+        return -1;
+
+    pthread_mutex_lock(&eng->mutex);
+    if ((eng->nworkers == 0 && dset_split_async_start() < 0) ||
+        (!dset->queue && NULL == (dset->queue = (H5VL_dset_split_queue_t *)calloc(1, sizeof(H5VL_dset_split_queue_t))))) {
+        pthread_mutex_unlock(&eng->mutex);
+        if (request)
+            H5VL_dset_split_free_obj(request);
+        return -1;
+    }
+    queue = dset->queue;
+
+    /* One reference for the request, one for the engine */
+    task->nrefs = request ? 2 : 1;
+    task->queue = queue;
+    task->next  = NULL;
+    if (queue->tail)
+        queue->tail->next = task;
+    else
+        queue->head = task;
+    queue->tail = task;
+    eng->npending++;
+    if (!queue->ready && !queue->running)
+        dset_split_async_push_ready(queue);
+    pthread_mutex_unlock(&eng->mutex);
+
+    if (request) {
+        request->task = task;
+        *req          = request;
+    }
+
+    return 0;
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    dset_split_async_prefetch
+ *
+ * Purpose:     Queues the filling of the read-ahead window of 'o'
+ *
+ * Return:      Success:    0
+ *              Failure:    -1, the caller fills the window
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+dset_split_async_prefetch(H5VL_dset_split_t *o, hid_t dxpl_id)
+{
+    H5VL_dset_split_task_t *task;
+
+    if (NULL == (task = dset_split_task_new(H5VL_DSET_SPLIT_TASK_PREFETCH, o, dxpl_id)))
+        return -1;
+    if (dset_split_async_submit(task, NULL) < 0) {
+        dset_split_task_release(task);
+        return -1;
+    }
+
+    return 0;
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    dset_split_async_dataset_create
+ *
+ * Purpose:     Queues the creation of a dataset in 'parent'. The dataset
+ *              returned is a placeholder, filled in when the creation
+ *              runs; the operations on it queue up behind the creation.
+ *
+ * Return:      Success:    Placeholder dataset
+ *              Failure:    NULL
+ *
+ *-------------------------------------------------------------------------
+ */
+static H5VL_dset_split_t *
+dset_split_async_dataset_create(H5VL_dset_split_t *parent, H5I_type_t parent_type, const char *name,
+                                hid_t lcpl_id, hid_t type_id, hid_t space_id, hid_t dcpl_id, hid_t dapl_id,
+                                hid_t dxpl_id, void **req)
+{
+    H5VL_dset_split_t *     dset;
+    H5VL_dset_split_task_t *task;
+
+    if (NULL == (dset = H5VL_dset_split_new_obj(NULL, parent->under_vol_id)))
+        return NULL;
+    dset->type = H5I_DATASET;
+    dset_split_inherit_file_ctx(dset, parent);
+
+    if (NULL == (task = dset_split_task_new(H5VL_DSET_SPLIT_TASK_CREATE, dset, dxpl_id))) {
+        H5VL_dset_split_free_obj(dset);
+        return NULL;
+    }
+    task->parent      = parent;
+    task->parent_type = parent_type;
+    task->name        = strdup(name);
+    task->lcpl_id     = dset_split_task_copy_id(lcpl_id);
+    task->type_id     = dset_split_task_copy_id(type_id);
+    task->space_id    = dset_split_task_copy_id(space_id);
+    task->dcpl_id     = dset_split_task_copy_id(dcpl_id);
+    task->dapl_id     = dset_split_task_copy_id(dapl_id);
+    if (!task->name || task->lcpl_id < 0 || task->type_id < 0 || task->space_id < 0 || task->dcpl_id < 0 ||
+        task->dapl_id < 0 || dset_split_async_submit(task, req) < 0) {
+        dset_split_task_release(task);
+        H5VL_dset_split_free_obj(dset);
+        return NULL;
+    }
+
+    return dset;
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    dset_split_async_dataset_op
+ *
+ * Purpose:     Queues a read, write, flush or close of 'dset'. 'type_id',
+ *              'mem_space_id', 'file_space_id' and 'buf' are the read and
+ *              write arguments, 'dset_id' the flush one.
+ *
+ * Return:      Success:    0
+ *              Failure:    -1
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+dset_split_async_dataset_op(H5VL_dset_split_task_op_t op, H5VL_dset_split_t *dset, hid_t type_id,
+                            hid_t mem_space_id, hid_t file_space_id, void *buf, hid_t dset_id, hid_t dxpl_id,
+                            void **req)
+{
+    H5VL_dset_split_task_t *task;
+
+    if (NULL == (task = dset_split_task_new(op, dset, dxpl_id)))
+        return -1;
+    if (op == H5VL_DSET_SPLIT_TASK_READ || op == H5VL_DSET_SPLIT_TASK_WRITE) {
+        task->type_id       = dset_split_task_copy_id(type_id);
+        task->space_id      = dset_split_task_copy_id(mem_space_id);
+        task->file_space_id = dset_split_task_copy_id(file_space_id);
+        task->buf           = buf;
+        if (task->type_id < 0 || task->space_id < 0 || task->file_space_id < 0) {
+            dset_split_task_release(task);
+            return -1;
+        }
+    }
+    task->dset_id = dset_id;
+    if (dset_split_async_submit(task, req) < 0) {
+        dset_split_task_release(task);
+        return -1;
+    }
+
+    return 0;
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    dset_split_async_sync
+ *
+ * Purpose:     Waits for the asynchronous tasks of 'o' to complete, before
+ *              a synchronous operation uses it. Does not wait from the
+ *              worker running a task of 'o'.
+ *
+ *-------------------------------------------------------------------------
+ */
+static void
+dset_split_async_sync(H5VL_dset_split_t *o)
+{
+    H5VL_dset_split_async_t *eng   = &H5VL_dset_split_async_g;
+    H5VL_dset_split_queue_t *queue = o->queue;
+    unsigned                 count;
+
+    if (!queue)
+        return;
+
+    pthread_mutex_lock(&eng->mutex);
+    if ((!queue->head && !queue->running) || (queue->running && pthread_equal(queue->runner, pthread_self()))) {
+        pthread_mutex_unlock(&eng->mutex);
+        return;
+    }
+    pthread_mutex_unlock(&eng->mutex);
+
+    count = dset_split_hdf5_unlock();
+    pthread_mutex_lock(&eng->mutex);
+    while (queue->head || queue->running)
+        pthread_cond_wait(&eng->done_cond, &eng->mutex);
+    pthread_mutex_unlock(&eng->mutex);
+    dset_split_hdf5_lock(count);
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    dset_split_async_drain
+ *
+ * Purpose:     Waits for all asynchronous tasks to complete, before the
+ *              objects they use go away
+ *
+ *-------------------------------------------------------------------------
+ */
+static void
+dset_split_async_drain(void)
+{
+    H5VL_dset_split_async_t *eng = &H5VL_dset_split_async_g;
+    unsigned                 count;
+
+    pthread_mutex_lock(&eng->mutex);
+    if (eng->npending == 0) {
+        pthread_mutex_unlock(&eng->mutex);
+        return;
+    }
+    pthread_mutex_unlock(&eng->mutex);
+
+    count = dset_split_hdf5_unlock();
+    pthread_mutex_lock(&eng->mutex);
+    while (eng->npending > 0)
+        pthread_cond_wait(&eng->done_cond, &eng->mutex);
+    pthread_mutex_unlock(&eng->mutex);
+    dset_split_hdf5_lock(count);
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    dset_split_async_stop
+ *
+ * Purpose:     Completes the pending tasks and stops the workers
+ *
+ *-------------------------------------------------------------------------
+ */
+static void
+dset_split_async_stop(void)
+{
+    H5VL_dset_split_async_t *eng = &H5VL_dset_split_async_g;
+    unsigned                 count;
+    unsigned                 u;
+
+    if (eng->nworkers == 0)
+        return;
+    dset_split_async_drain();
+
+    pthread_mutex_lock(&eng->mutex);
+    eng->shutdown = TRUE;
+    pthread_cond_broadcast(&eng->work_cond);
+    pthread_mutex_unlock(&eng->mutex);
+
+    count = dset_split_hdf5_unlock();
+    for (u = 0; u < eng->nworkers; u++)
+        pthread_join(eng->workers[u], NULL);
+    dset_split_hdf5_lock(count);
+
+    free(eng->workers);
+    eng->workers  = NULL;
+    eng->nworkers = 0;
+    eng->shutdown = FALSE;
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    dset_split_queue_release
+ *
+ * Purpose:     Frees the task queue of a released dataset, or leaves it to
+ *              the worker running its last task (the dataset close)
+ *
+ *-------------------------------------------------------------------------
+ */
+static void
+dset_split_queue_release(H5VL_dset_split_queue_t *queue)
+{
+    H5VL_dset_split_async_t *eng = &H5VL_dset_split_async_g;
+    H5VL_dset_split_queue_t *prev;
+    H5VL_dset_split_queue_t *q;
+
+    pthread_mutex_lock(&eng->mutex);
+    if (queue->running)
+        queue->orphaned = TRUE;
+    else {
+        if (queue->ready) {
+            for (prev = NULL, q = eng->ready_head; q != queue; prev = q, q = q->ready_next)
+                ;
+            if (prev)
+                prev->ready_next = queue->ready_next;
+            else
+                eng->ready_head = queue->ready_next;
+            if (eng->ready_tail == queue)
+                eng->ready_tail = prev;
+        }
+        free(queue);
+    }
+    pthread_mutex_unlock(&eng->mutex);
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    dset_split_task_wait
+ *
+ * Purpose:     Waits up to 'timeout' nanoseconds for a task to complete
+ *              and reports its status
+ *
+ *-------------------------------------------------------------------------
+ */
+static void
+dset_split_task_wait(H5VL_dset_split_task_t *task, uint64_t timeout, H5VL_request_status_t *status)
+{
+    H5VL_dset_split_async_t *eng = &H5VL_dset_split_async_g;
+    struct timespec          deadline;
+    hbool_t                  forever;
+    unsigned                 count;
+
+    pthread_mutex_lock(&eng->mutex);
+    if (task->status == H5VL_REQUEST_STATUS_IN_PROGRESS && timeout > 0) {
+        pthread_mutex_unlock(&eng->mutex);
+
+        /* Timeouts past a year are as good as waiting forever */
+        forever = (timeout >= (uint64_t)365 * 24 * 3600 * 1000000000);
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        if (!forever) {
+            uint64_t nsec = (uint64_t)deadline.tv_nsec + timeout;
+
+            deadline.tv_sec += (time_t)(nsec / 1000000000);
+            deadline.tv_nsec = (long)(nsec % 1000000000);
+        }
+
+        count = dset_split_hdf5_unlock();
+        pthread_mutex_lock(&eng->mutex);
+        while (task->status == H5VL_REQUEST_STATUS_IN_PROGRESS) {
+            if (forever)
+                pthread_cond_wait(&eng->done_cond, &eng->mutex);
+            else if (pthread_cond_timedwait(&eng->done_cond, &eng->mutex, &deadline) == ETIMEDOUT)
+                break;
+        }
+        pthread_mutex_unlock(&eng->mutex);
+        dset_split_hdf5_lock(count);
+        pthread_mutex_lock(&eng->mutex);
+    }
+    *status = task->status;
+    pthread_mutex_unlock(&eng->mutex);
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    dset_split_task_cancel
+ *
+ * Purpose:     Cancels a task that has not started yet. Dataset closes
+ *              are not canceled, the dataset would never be released.
+ *
+ *-------------------------------------------------------------------------
+ */
+static void
+dset_split_task_cancel(H5VL_dset_split_task_t *task, H5VL_request_status_t *status)
+{
+    H5VL_dset_split_async_t *eng      = &H5VL_dset_split_async_g;
+    H5VL_dset_split_task_t * prev     = NULL;
+    H5VL_dset_split_task_t * t;
+    hbool_t                  canceled = FALSE;
+
+    pthread_mutex_lock(&eng->mutex);
+    *status = task->status;
+    if (task->status == H5VL_REQUEST_STATUS_IN_PROGRESS) {
+        *status = H5VL_REQUEST_STATUS_CANT_CANCEL;
+        for (t = task->queue->head; t && t != task; prev = t, t = t->next)
+            ;
+        if (t && task->op != H5VL_DSET_SPLIT_TASK_CLOSE) {
+            if (prev)
+                prev->next = task->next;
+            else
+                task->queue->head = task->next;
+            if (task->queue->tail == task)
+                task->queue->tail = prev;
+            task->status = H5VL_REQUEST_STATUS_CANCELED;
+            *status      = H5VL_REQUEST_STATUS_CANCELED;
+            eng->npending--;
+            pthread_cond_broadcast(&eng->done_cond);
+            canceled = TRUE;
+        }
+    }
+    pthread_mutex_unlock(&eng->mutex);
+
+    /* Drop the engine's reference */
+    if (canceled)
+        dset_split_task_release(task);
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    dset_split_async_idle
+ *
+ * Purpose:     Checks whether 'o' has no asynchronous task queued or
+ *              running
+ *
+ * Return:      TRUE/FALSE
+ *
+ *-------------------------------------------------------------------------
+ */
+static hbool_t
+dset_split_async_idle(const H5VL_dset_split_t *o)
+{
+    hbool_t idle;
+
+    if (!o->queue)
+        return TRUE;
+
+    pthread_mutex_lock(&H5VL_dset_split_async_g.mutex);
+    idle = !o->queue->head && !o->queue->running;
+    pthread_mutex_unlock(&H5VL_dset_split_async_g.mutex);
+
+    return idle;
+}
+#else
+/* Without a thread-safe HDF5 library, operations always complete before returning */
+static hbool_t
+dset_split_async_idle(const H5VL_dset_split_t *o)
+{
+    (void)o;
+    return TRUE;
+}
+
+static herr_t
+dset_split_async_prefetch(H5VL_dset_split_t *o, hid_t dxpl_id)
+{
+    (void)o;
+    (void)dxpl_id;
+    return -1;
+}
+
+static hbool_t
+dset_split_async_enabled(const H5VL_dset_split_t *o, void **req)
+{
+    (void)o;
+    (void)req;
+    return FALSE;
+}
+
+static void
+dset_split_async_sync(H5VL_dset_split_t *o)
+{
+    (void)o;
+}
+
+static void
+dset_split_async_drain(void)
+{
+}
+
+static void
+dset_split_async_stop(void)
+{
+}
+
+static void
+dset_split_queue_release(H5VL_dset_split_queue_t *queue)
+{
+    free(queue);
+}
+
+static H5VL_dset_split_t *
+dset_split_async_dataset_create(H5VL_dset_split_t *parent, H5I_type_t parent_type, const char *name,
+                                hid_t lcpl_id, hid_t type_id, hid_t space_id, hid_t dcpl_id, hid_t dapl_id,
+                                hid_t dxpl_id, void **req)
+{
+    (void)parent;
+    (void)parent_type;
+    (void)name;
+    (void)lcpl_id;
+    (void)type_id;
+    (void)space_id;
+    (void)dcpl_id;
+    (void)dapl_id;
+    (void)dxpl_id;
+    (void)req;
+    return NULL;
+}
+
+static herr_t
+dset_split_async_dataset_op(H5VL_dset_split_task_op_t op, H5VL_dset_split_t *dset, hid_t type_id,
+                            hid_t mem_space_id, hid_t file_space_id, void *buf, hid_t dset_id, hid_t dxpl_id,
+                            void **req)
+{
+    (void)op;
+    (void)dset;
+    (void)type_id;
+    (void)mem_space_id;
+    (void)file_space_id;
+    (void)buf;
+    (void)dset_id;
+    (void)dxpl_id;
+    (void)req;
+    return -1;
+}
+#endif /* H5_HAVE_THREADSAFE */
+
+/*-------------------------------------------------------------------------
+ * Function:    dset_split_direct_dcpl
+ *
+ * Purpose:     Direct I/O needs the storage of a contiguous dataset
+ *              allocated when the dataset is created. The fill value is
+ *              not written, unless the application set one.
+ *
+ * Return:      Success:    Copy of 'dcpl_id' with early allocation
+ *              Failure:    H5I_INVALID_HID, 'dcpl_id' is used as is
+ *
+ *-------------------------------------------------------------------------
+ */
+static hid_t
+dset_split_direct_dcpl(hid_t dcpl_id)
+{
+    H5D_alloc_time_t alloc_time;
+    hid_t            new_dcpl_id;
+
+    if (H5Pget_layout(dcpl_id) != H5D_CONTIGUOUS || H5Pget_alloc_time(dcpl_id, &alloc_time) < 0 ||
+        alloc_time != H5D_ALLOC_TIME_LATE)
+        return H5I_INVALID_HID;
+    if ((new_dcpl_id = H5Pcopy(dcpl_id)) < 0)
+        return H5I_INVALID_HID;
+    if (H5Pset_alloc_time(new_dcpl_id, H5D_ALLOC_TIME_EARLY) < 0) {
+        H5Pclose(new_dcpl_id);
+        return H5I_INVALID_HID;
+    }
+
+    return new_dcpl_id;
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    dset_split_select_contig
+ *
+ * Purpose:     Checks whether the selection of 'space_id' is one run of
+ *              elements, contiguous in row-major order
+ *
+ * Return:      TRUE, with the first element (linear index) in '*start'
+ *              and the number of elements in '*nelem', or FALSE
+ *
+ *-------------------------------------------------------------------------
+ */
+static hbool_t
+dset_split_select_contig(hid_t space_id, hsize_t *start, hsize_t *nelem)
+{
+    hsize_t  dims[H5S_MAX_RANK];
+    hsize_t  first[H5S_MAX_RANK];
+    hsize_t  last[H5S_MAX_RANK];
+    hsize_t  stride = 1;
+    hssize_t npoints;
+    int      ndims;
+    int      k;
+    int      i;
+
+    *start = 0;
+    *nelem = 0;
+    if ((npoints = H5Sget_select_npoints(space_id)) < 0)
+        return FALSE;
+    if (npoints == 0)
+        return TRUE;
+    if (H5Sget_select_type(space_id) == H5S_SEL_ALL) {
+        *nelem = (hsize_t)npoints;
+        return TRUE;
+    }
+
+    if ((ndims = H5Sget_simple_extent_dims(space_id, dims, NULL)) < 1 ||
+        H5Sget_select_bounds(space_id, first, last) < 0)
+        return FALSE;
+
+    /* Trailing dimensions of the bounding box must be whole, leading ones a single row */
+    for (k = ndims - 1; k > 0 && first[k] == 0 && last[k] == dims[k] - 1; k--)
+        ;
+    for (i = 0; i < k; i++)
+        if (first[i] != last[i])
+            return FALSE;
+
+    for (i = ndims - 1; i >= 0; i--) {
+        *start += first[i] * stride;
+        stride *= dims[i];
+    }
+    *nelem = last[k] - first[k] + 1;
+    for (i = k + 1; i < ndims; i++)
+        *nelem *= dims[i];
+
+    /* ... and entirely selected */
+    return *nelem == (hsize_t)npoints;
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    dset_split_direct_plan
+ *
+ * Purpose:     Maps a dataset read or write onto one byte range of its
+ *              split file, when the library would do nothing more than
+ *              copy bytes: a contiguous dataset with allocated storage,
+ *              in a split file using the POSIX driver, the memory type
+ *              equal to the dataset type, and both selections contiguous.
+ *              The split file may host other datasets: the jobs of a
+ *              split file run one after the other, and the library
+ *              transfers to it wait for them.
+ *
+ * Return:      TRUE, with 'job' filled in, or FALSE if the operation has
+ *              to go through the library
+ *
+ *-------------------------------------------------------------------------
+ */
+static hbool_t
+dset_split_direct_plan(hid_t dset_id, hid_t mem_type_id, hid_t mem_space_id, hid_t file_space_id, void *buf,
+                       hbool_t write, H5VL_dset_split_direct_t *job)
+{
+    H5VL_dset_split_t *                 o;
+    H5VL_dataset_get_args_t             get_args;
+    H5VL_optional_args_t                opt_args;
+    H5VL_native_dataset_optional_args_t dset_opt_args;
+    H5VL_class_value_t                  value     = (H5VL_class_value_t)-1;
+    hid_t                               vol_id    = H5I_INVALID_HID;
+    hid_t                               type_id   = H5I_INVALID_HID;
+    hid_t                               dcpl_id   = H5I_INVALID_HID;
+    hid_t                               space_id  = H5I_INVALID_HID;
+    hid_t                               fapl_id   = H5I_INVALID_HID;
+    hid_t                               fcpl_id   = H5I_INVALID_HID;
+    hsize_t                             userblock = 0;
+    hsize_t                             file_start;
+    hsize_t                             file_nelem;
+    hsize_t                             mem_start;
+    hsize_t                             mem_nelem;
+    haddr_t                             addr      = HADDR_UNDEF;
+    size_t                              type_size;
+    int *                               fd        = NULL;
+    hbool_t                             ret_value = FALSE;
+
+    H5E_BEGIN_TRY
+    {
+        /* The dataset must be one of ours, with a split file, and idle */
+        if ((vol_id = H5VLget_connector_id(dset_id)) < 0 || H5VLget_value(vol_id, &value) < 0 ||
+            value != (H5VL_class_value_t)H5VL_DSET_SPLIT_VALUE)
+            goto done;
+        if (NULL == (o = (H5VL_dset_split_t *)H5VLobject(dset_id)) || !o->set || !o->split_file || o->subfile ||
+            !o->file_ctx || !o->file_ctx->direct_io || o->wb || !dset_split_async_idle(o))
+            goto done;
+        if (write && !(o->split_file->flags & H5F_ACC_RDWR))
+            goto done;
+
+        /* Contiguous storage, already allocated, holding the memory type as is. Asked of the
+         * underlying dataset, the connector's own callbacks would flush or fill its buffers */
+        get_args.op_type = H5VL_DATASET_GET_DCPL;
+        if (H5VLdataset_get(o->under_object, o->under_vol_id, &get_args, H5P_DATASET_XFER_DEFAULT, NULL) < 0)
+            goto done;
+        dcpl_id = get_args.args.get_dcpl.dcpl_id;
+        if (H5Pget_layout(dcpl_id) != H5D_CONTIGUOUS || H5Pget_external_count(dcpl_id) != 0)
+            goto done;
+
+        dset_opt_args.get_offset.offset = &addr;
+        opt_args.op_type                = H5VL_NATIVE_DATASET_GET_OFFSET;
+        opt_args.args                   = &dset_opt_args;
+        if (H5VLdataset_optional(o->under_object, o->under_vol_id, &opt_args, H5P_DATASET_XFER_DEFAULT, NULL) < 0 ||
+            addr == HADDR_UNDEF)
+            goto done;
+
+        get_args.op_type = H5VL_DATASET_GET_TYPE;
+        if (H5VLdataset_get(o->under_object, o->under_vol_id, &get_args, H5P_DATASET_XFER_DEFAULT, NULL) < 0)
+            goto done;
+        type_id = get_args.args.get_type.type_id;
+        if (H5Tequal(type_id, mem_type_id) <= 0 || H5Tis_variable_str(type_id) != 0 ||
+            H5Tdetect_class(type_id, H5T_VLEN) != 0 || H5Tdetect_class(type_id, H5T_REFERENCE) != 0 ||
+            0 == (type_size = H5Tget_size(type_id)))
+            goto done;
+
+        /* One run of elements on both sides */
+        get_args.op_type = H5VL_DATASET_GET_SPACE;
+        if (H5VLdataset_get(o->under_object, o->under_vol_id, &get_args, H5P_DATASET_XFER_DEFAULT, NULL) < 0)
+            goto done;
+        space_id = get_args.args.get_space.space_id;
+        if (!dset_split_select_contig(file_space_id == H5S_ALL ? space_id : file_space_id, &file_start,
+                                      &file_nelem))
+            goto done;
+        if (mem_space_id == H5S_ALL) {
+            mem_start = file_start;
+            mem_nelem = file_nelem;
+        }
+        else if (!dset_split_select_contig(mem_space_id, &mem_start, &mem_nelem))
+            goto done;
+        if (mem_nelem != file_nelem)
+            goto done;
+
+        /* The split file's descriptor, with the POSIX driver only */
+        if ((fapl_id = H5Fget_access_plist(o->split_file->fid)) < 0 || H5Pget_driver(fapl_id) != H5FD_SEC2 ||
+            H5Fget_vfd_handle(o->split_file->fid, fapl_id, (void **)&fd) < 0 || !fd)
+            goto done;
+        if ((fcpl_id = H5Fget_create_plist(o->split_file->fid)) < 0 || H5Pget_userblock(fcpl_id, &userblock) < 0)
+            goto done;
+
+        if (write)
+            dset_split_ra_invalidate(o);
+
+        job->fd         = *fd;
+        job->offset     = (off_t)(userblock + addr + file_start * type_size);
+        job->nbytes     = (size_t)(file_nelem * type_size);
+        job->buf        = (unsigned char *)buf + mem_start * type_size;
+        job->split_file = o->split_file;
+        job->split_file->nrefs++;
+        ret_value       = TRUE;
+
+done:
+        if (vol_id >= 0)
+            H5VLclose(vol_id);
+        if (dcpl_id >= 0)
+            H5Pclose(dcpl_id);
+        if (type_id >= 0)
+            H5Tclose(type_id);
+        if (space_id >= 0)
+            H5Sclose(space_id);
+        if (fapl_id >= 0)
+            H5Pclose(fapl_id);
+        if (fcpl_id >= 0)
+            H5Pclose(fcpl_id);
+    }
+    H5E_END_TRY;
+
+    return ret_value;
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    dset_split_direct_cmp
+ *
+ * Purpose:     Orders direct I/O jobs by split file, then by offset
+ *
+ *-------------------------------------------------------------------------
+ */
+static int
+dset_split_direct_cmp(const void *_job1, const void *_job2)
+{
+    const H5VL_dset_split_direct_t *job1 = (const H5VL_dset_split_direct_t *)_job1;
+    const H5VL_dset_split_direct_t *job2 = (const H5VL_dset_split_direct_t *)_job2;
+
+    if (job1->fd != job2->fd)
+        return job1->fd < job2->fd ? -1 : 1;
+    return (job1->offset > job2->offset) - (job1->offset < job2->offset);
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    dset_split_direct_io
+ *
+ * Purpose:     Reads or writes the byte range of a job, restarting after
+ *              short transfers and interrupts
+ *
+ * Return:      Success:    0
+ *              Failure:    -1
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+dset_split_direct_io(const H5VL_dset_split_direct_t *job, hbool_t write)
+{
+    unsigned char *buf    = (unsigned char *)job->buf;
+    size_t         nbytes = job->nbytes;
+    off_t          offset = job->offset;
+
+    while (nbytes > 0) {
+        ssize_t n = write ? pwrite(job->fd, buf, nbytes, offset) : pread(job->fd, buf, nbytes, offset);
+
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            return -1;
+        buf += n;
+        offset += n;
+        nbytes -= (size_t)n;
+    }
+
+    return 0;
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    dset_split_direct_worker
+ *
+ * Purpose:     Thread running the jobs of one split file after the other.
+ *              Makes no HDF5 calls.
+ *
+ *-------------------------------------------------------------------------
+ */
+static void *
+dset_split_direct_worker(void *arg)
+{
+    H5VL_dset_split_direct_batch_t *batch = (H5VL_dset_split_direct_batch_t *)arg;
+
+    for (;;) {
+        size_t group;
+        size_t u;
+
+        pthread_mutex_lock(&batch->mutex);
+        group = batch->next_group++;
+        pthread_mutex_unlock(&batch->mutex);
+        if (group >= batch->ngroups)
+            break;
+
+        for (u = batch->groups[group]; u < batch->groups[group + 1]; u++)
+            if (dset_split_direct_io(&batch->jobs[u], batch->write) < 0) {
+                pthread_mutex_lock(&batch->mutex);
+                batch->nerrors++;
+                pthread_mutex_unlock(&batch->mutex);
+            }
+    }
+
+    return NULL;
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    dset_split_direct_start
+ *
+ * Purpose:     Starts running a batch of direct I/O jobs, one thread per
+ *              split file, up to H5VL_DSET_SPLIT_DIRECT_THREADS_MAX. The
+ *              jobs of a split file run in offset order.
+ *
+ * Return:      Success:    0
+ *              Failure:    -1, nothing was started
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+dset_split_direct_start(H5VL_dset_split_direct_batch_t *batch)
+{
+    size_t u;
+
+    batch->ngroups    = 0;
+    batch->next_group = 0;
+    batch->nerrors    = 0;
+    batch->nthreads   = 0;
+    if (batch->njobs == 0)
+        return 0;
+
+    qsort(batch->jobs, batch->njobs, sizeof(H5VL_dset_split_direct_t), dset_split_direct_cmp);
+    if (NULL == (batch->groups = (size_t *)malloc((batch->njobs + 1) * sizeof(size_t))))
+        return -1;
+    for (u = 0; u < batch->njobs; u++)
+        if (u == 0 || batch->jobs[u].fd != batch->jobs[u - 1].fd)
+            batch->groups[batch->ngroups++] = u;
+    batch->groups[batch->ngroups] = batch->njobs;
+
+    for (u = 0; u < batch->ngroups && u < H5VL_DSET_SPLIT_DIRECT_THREADS_MAX; u++) {
+        if (pthread_create(&batch->threads[batch->nthreads], NULL, dset_split_direct_worker, batch) != 0)
+            break;
+        batch->nthreads++;
+    }
+
+    /* No thread could be started, run the jobs from this one */
+    if (batch->nthreads == 0)
+        dset_split_direct_worker(batch);
+
+    return 0;
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    dset_split_direct_busy
+ *
+ * Purpose:     Checks whether the split file of the dataset 'dset_id' has
+ *              jobs in a batch. The library must not write to it, data or
+ *              metadata, while they run.
+ *
+ * Return:      TRUE/FALSE
+ *
+ *-------------------------------------------------------------------------
+ */
+static hbool_t
+dset_split_direct_busy(const H5VL_dset_split_direct_batch_t *batch, hid_t dset_id)
+{
+    H5VL_dset_split_t *o     = NULL;
+    H5VL_class_value_t value = (H5VL_class_value_t)-1;
+    hid_t              vol_id;
+    size_t             u;
+
+    if (batch->njobs == 0)
+        return FALSE;
+
+    H5E_BEGIN_TRY
+    {
+        if ((vol_id = H5VLget_connector_id(dset_id)) >= 0) {
+            if (H5VLget_value(vol_id, &value) >= 0 && value == (H5VL_class_value_t)H5VL_DSET_SPLIT_VALUE)
+                o = (H5VL_dset_split_t *)H5VLobject(dset_id);
+            H5VLclose(vol_id);
+        }
+    }
+    H5E_END_TRY;
+    if (!o || !o->split_file)
+        return FALSE;
+
+    for (u = 0; u < batch->njobs; u++)
+        if (batch->jobs[u].split_file == o->split_file)
+            return TRUE;
+
+    return FALSE;
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    dset_split_direct_finish
+ *
+ * Purpose:     Waits for a batch of direct I/O jobs to complete
+ *
+ * Return:      Number of jobs that failed
+ *
+ *-------------------------------------------------------------------------
+ */
+static size_t
+dset_split_direct_finish(H5VL_dset_split_direct_batch_t *batch)
+{
+    size_t u;
+
+    for (u = 0; u < batch->nthreads; u++)
+        pthread_join(batch->threads[u], NULL);
+    free(batch->groups);
+    batch->groups = NULL;
+
+    return batch->nerrors;
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    dset_split_select_run
+ *
+ * Purpose:     Adds a run of elements, contiguous in row-major order, to
+ *              the selection of 'space_id', as the few blocks covering it
+ *
+ * Return:      Success:    0
+ *              Failure:    -1
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+dset_split_select_run(hid_t space_id, hsize_t start, hsize_t nelem)
+{
+    hsize_t dims[H5S_MAX_RANK];
+    hsize_t span[H5S_MAX_RANK + 1]; /* Elements in dimensions i and up */
+    hsize_t offset[H5S_MAX_RANK];
+    hsize_t block[H5S_MAX_RANK];
+    hsize_t ones[H5S_MAX_RANK];
+    hsize_t end = start + nelem;
+    int     ndims;
+    int     i;
+    int     j;
+
+    if ((ndims = H5Sget_simple_extent_dims(space_id, dims, NULL)) < 1)
+        return -1;
+    span[ndims] = 1;
+    for (i = ndims - 1; i >= 0; i--) {
+        span[i] = span[i + 1] * dims[i];
+        ones[i] = 1;
+    }
+
+    while (start < end) {
+        hsize_t m;
+
+        /* Largest slab of whole trailing dimensions that starts here and fits in the run */
+        for (j = 1; j < ndims && (start % span[j] != 0 || start + span[j] > end); j++)
+            ;
+
+        /* As many of them as fit in the run and in dimension j - 1 */
+        m = (end - start) / span[j];
+        if (m > dims[j - 1] - (start / span[j]) % dims[j - 1])
+            m = dims[j - 1] - (start / span[j]) % dims[j - 1];
+
+        for (i = 0; i < ndims; i++) {
+            offset[i] = (start / span[i + 1]) % dims[i];
+            block[i]  = i < j - 1 ? 1 : (i == j - 1 ? m : dims[i]);
+        }
+        if (H5Sselect_hyperslab(space_id, H5S_SELECT_OR, offset, NULL, ones, block) < 0)
+            return -1;
+        start += m * span[j];
+    }
+
+    return 0;
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    dset_split_wb_free
+ *
+ * Purpose:     Drops the write-behind buffer of a dataset, without writing
+ *              it
+ *
+ *-------------------------------------------------------------------------
+ */
+static void
+dset_split_wb_free(H5VL_dset_split_t *o)
+{
+    H5VL_dset_split_wb_t * wb = o->wb;
+    H5VL_dset_split_wb_t **prev;
+    size_t                 u;
+
+    for (prev = &o->file_ctx->wb_head; *prev; prev = &(*prev)->next)
+        if (*prev == wb) {
+            *prev = wb->next;
+            break;
+        }
+    o->file_ctx->wb_used -= wb->nbytes;
+
+    for (u = 0; u < wb->nruns; u++)
+        free(wb->runs[u].data);
+    free(wb->runs);
+    if (wb->type_id >= 0)
+        H5Tclose(wb->type_id);
+    if (wb->space_id >= 0)
+        H5Sclose(wb->space_id);
+    if (wb->dxpl_id >= 0)
+        H5Pclose(wb->dxpl_id);
+    free(wb);
+    o->wb = NULL;
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    dset_split_wb_flush
+ *
+ * Purpose:     Writes the buffered writes of a dataset, all its runs in
+ *              one write, and drops the buffer
+ *
+ * Return:      Success:    0
+ *              Failure:    -1, the buffer is kept for a later attempt
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+dset_split_wb_flush(H5VL_dset_split_t *o)
+{
+    H5VL_dset_split_wb_t *wb            = o->wb;
+    hid_t                 file_space_id = H5I_INVALID_HID;
+    hid_t                 mem_space_id  = H5I_INVALID_HID;
+    unsigned char *       data          = NULL;
+    hsize_t               nelem         = 0;
+    size_t                u;
+    herr_t                ret_value     = -1;
+
+    if (!wb)
+        return 0;
+    if (wb->nruns == 0) {
+        dset_split_wb_free(o);
+        return 0;
+    }
+
+    /* The runs are sorted, so the file selection takes their elements in the order they are stored */
+    if ((file_space_id = H5Scopy(wb->space_id)) < 0 || H5Sselect_none(file_space_id) < 0)
+        goto done;
+    for (u = 0; u < wb->nruns; u++) {
+        if (dset_split_select_run(file_space_id, wb->runs[u].start, wb->runs[u].nelem) < 0)
+            goto done;
+        nelem += wb->runs[u].nelem;
+    }
+    if ((mem_space_id = H5Screate_simple(1, &nelem, NULL)) < 0)
+        goto done;
+    if (wb->nruns == 1)
+        data = wb->runs[0].data;
+    else {
+        unsigned char *p;
+
+        if (NULL == (data = (unsigned char *)malloc((size_t)wb->nbytes)))
+            goto done;
+        for (u = 0, p = data; u < wb->nruns; p += wb->runs[u].nelem * wb->type_size, u++)
+            memcpy(p, wb->runs[u].data, wb->runs[u].nelem * wb->type_size);
+    }
+
+    ret_value = H5VLdataset_write(o->under_object, o->under_vol_id, wb->type_id, mem_space_id, file_space_id,
+                                  wb->dxpl_id, data, NULL);
+
+done:
+    if (data && wb->nruns > 1)
+        free(data);
+    if (mem_space_id >= 0)
+        H5Sclose(mem_space_id);
+    if (file_space_id >= 0)
+        H5Sclose(file_space_id);
+    if (ret_value >= 0)
+        dset_split_wb_free(o);
+
+    return ret_value;
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    dset_split_wb_flush_file
+ *
+ * Purpose:     Writes the buffered writes of all datasets of a file
+ *
+ * Return:      Success:    0
+ *              Failure:    -1, if writing any of the buffers failed
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+dset_split_wb_flush_file(H5VL_dset_split_file_ctx_t *file_ctx)
+{
+    H5VL_dset_split_wb_t *wb;
+    H5VL_dset_split_wb_t *next;
+    herr_t                ret_value = 0;
+
+    /* Buffers that fail to write stay listed */
+    for (wb = file_ctx->wb_head; wb; wb = next) {
+        next = wb->next;
+        if (dset_split_wb_flush(wb->dset) < 0)
+            ret_value = -1;
+    }
+
+    return ret_value;
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    dset_split_wb_write
+ *
+ * Purpose:     Buffers a small dataset write: one run of elements of a
+ *              fixed-size type, both in memory and in the file, of at most
+ *              'write_behind' bytes. It is merged with the buffered runs it
+ *              overlaps or touches. The buffers of the file are written
+ *              when they would exceed the file's budget.
+ *
+ * Return:      1 if the write was buffered, 0 if it has to be written
+ *              through, -1 on failure
+ *
+ *-------------------------------------------------------------------------
+ */
+static int
+dset_split_wb_write(H5VL_dset_split_t *o, hid_t mem_type_id, hid_t mem_space_id, hid_t file_space_id,
+                    hid_t dxpl_id, const void *buf)
+{
+    H5VL_dset_split_file_ctx_t *file_ctx = o->file_ctx;
+    H5VL_dset_split_wb_t *      wb;
+    H5VL_dset_split_wb_run_t *  runs;
+    unsigned char *             data;
+    hsize_t                     start;
+    hsize_t                     nelem;
+    hsize_t                     mem_start;
+    hsize_t                     mem_nelem;
+    hsize_t                     lo;
+    hsize_t                     hi;
+    hsize_t                     old_nbytes = 0;
+    size_t                      type_size;
+    size_t                      nbytes;
+    size_t                      first;
+    size_t                      last;
+    size_t                      u;
+
+    if (!file_ctx || file_ctx->write_behind == 0 || o->subfile || file_space_id == H5S_ALL)
+        return 0;
+#ifdef H5_HAVE_PARALLEL
+    /* Collective writes must not be held back on some ranks */
+    if (file_ctx->comm != MPI_COMM_NULL)
+        return 0;
+#endif
+    if (dxpl_id == H5P_DEFAULT)
+        dxpl_id = H5P_DATASET_XFER_DEFAULT;
+
+    /* One small run of fixed-size elements on both sides */
+    if (H5Sget_simple_extent_ndims(file_space_id) < 1 || !dset_split_select_contig(file_space_id, &start, &nelem) ||
+        nelem == 0)
+        return 0;
+    if (mem_space_id == H5S_ALL) {
+        mem_start = start;
+        mem_nelem = nelem;
+    }
+    else if (!dset_split_select_contig(mem_space_id, &mem_start, &mem_nelem))
+        return 0;
+    if (mem_nelem != nelem)
+        return 0;
+    if (0 == (type_size = H5Tget_size(mem_type_id)) || H5Tis_variable_str(mem_type_id) != 0 ||
+        H5Tdetect_class(mem_type_id, H5T_VLEN) != 0 || H5Tdetect_class(mem_type_id, H5T_REFERENCE) != 0)
+        return 0;
+    nbytes = (size_t)(nelem * type_size);
+    if (nbytes > file_ctx->write_behind || nbytes > file_ctx->wb_budget)
+        return 0;
+
+    /* A buffer holds writes of one memory type, extent and transfer property list */
+    if (o->wb && (H5Tequal(o->wb->type_id, mem_type_id) <= 0 || H5Sextent_equal(o->wb->space_id, file_space_id) <= 0 ||
+                  H5Pequal(o->wb->dxpl_id, dxpl_id) <= 0) &&
+        dset_split_wb_flush(o) < 0)
+        return -1;
+
+    /* Keep the buffers of the file within the budget */
+    if (file_ctx->wb_used + nbytes > file_ctx->wb_budget && dset_split_wb_flush_file(file_ctx) < 0)
+        return -1;
+
+    if (NULL == (wb = o->wb)) {
+        if (NULL == (wb = (H5VL_dset_split_wb_t *)calloc(1, sizeof(H5VL_dset_split_wb_t))))
+            return -1;
+        wb->type_size  = type_size;
+        wb->dset       = o;
+        wb->next       = file_ctx->wb_head;
+        file_ctx->wb_head = wb;
+        o->wb          = wb;
+        wb->type_id    = H5Tcopy(mem_type_id);
+        wb->space_id   = H5Scopy(file_space_id);
+        wb->dxpl_id    = H5Pcopy(dxpl_id);
+        if (wb->type_id < 0 || wb->space_id < 0 || wb->dxpl_id < 0) {
+            dset_split_wb_free(o);
+            return -1;
+        }
+    }
+
+    /* Runs [first, last) overlap or touch the new one */
+    for (first = 0; first < wb->nruns && wb->runs[first].start + wb->runs[first].nelem < start; first++)
+        ;
+    for (last = first; last < wb->nruns && wb->runs[last].start <= start + nelem; last++)
+        ;
+    lo = start;
+    hi = start + nelem;
+    if (last > first) {
+        if (wb->runs[first].start < lo)
+            lo = wb->runs[first].start;
+        if (wb->runs[last - 1].start + wb->runs[last - 1].nelem > hi)
+            hi = wb->runs[last - 1].start + wb->runs[last - 1].nelem;
+    }
+    for (u = first; u < last; u++)
+        old_nbytes += wb->runs[u].nelem * type_size;
+
+    /* Appending to a run, or overwriting part of it, extends it in place */
+    if (last == first + 1 && wb->runs[first].start == lo) {
+        if (NULL == (data = (unsigned char *)realloc(wb->runs[first].data, (size_t)((hi - lo) * type_size))))
+            return -1;
+    }
+    else {
+        if (NULL == (data = (unsigned char *)malloc((size_t)((hi - lo) * type_size))))
+            return -1;
+        for (u = first; u < last; u++) {
+            memcpy(data + (wb->runs[u].start - lo) * type_size, wb->runs[u].data,
+                   (size_t)(wb->runs[u].nelem * type_size));
+            free(wb->runs[u].data);
+        }
+
+        /* The merged runs are replaced by one */
+        if (last == first) {
+            if (wb->nruns == wb->nalloc) {
+                size_t nalloc = wb->nalloc ? 2 * wb->nalloc : 8;
+
+                if (NULL == (runs = (H5VL_dset_split_wb_run_t *)realloc(wb->runs,
+                                                                         nalloc * sizeof(H5VL_dset_split_wb_run_t)))) {
+                    free(data);
+                    return -1;
+                }
+                wb->runs   = runs;
+                wb->nalloc = nalloc;
+            }
+            memmove(&wb->runs[first + 1], &wb->runs[first], (wb->nruns - first) * sizeof(H5VL_dset_split_wb_run_t));
+            wb->nruns++;
+        }
+        else if (last > first + 1) {
+            memmove(&wb->runs[first + 1], &wb->runs[last], (wb->nruns - last) * sizeof(H5VL_dset_split_wb_run_t));
+            wb->nruns -= last - first - 1;
+        }
+    }
+    memcpy(data + (start - lo) * type_size, (const unsigned char *)buf + mem_start * type_size, nbytes);
+    wb->runs[first].start = lo;
+    wb->runs[first].nelem = hi - lo;
+    wb->runs[first].data  = data;
+
+    wb->nbytes += (hi - lo) * type_size - old_nbytes;
+    file_ctx->wb_used += (hi - lo) * type_size - old_nbytes;
+
+    return 1;
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    dset_split_ra_invalidate
+ *
+ * Purpose:     Drops the read-ahead window of a dataset, its data may be
+ *              out of date. Prefetches queued for the dataset completed
+ *              before any synchronous operation on it.
+ *
+ *-------------------------------------------------------------------------
+ */
+static void
+dset_split_ra_invalidate(H5VL_dset_split_t *o)
+{
+    if (!o->ra)
+        return;
+
+    free(o->ra->data);
+    o->ra->data  = NULL;
+    o->ra->nelem = 0;
+    o->ra->valid = FALSE;
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    dset_split_ra_free
+ *
+ * Purpose:     Frees the read-ahead state of a dataset
+ *
+ *-------------------------------------------------------------------------
+ */
+static void
+dset_split_ra_free(H5VL_dset_split_t *o)
+{
+    dset_split_ra_invalidate(o);
+    if (o->ra->type_id >= 0)
+        H5Tclose(o->ra->type_id);
+    if (o->ra->space_id >= 0)
+        H5Sclose(o->ra->space_id);
+    free(o->ra);
+    o->ra = NULL;
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    dset_split_ra_fill
+ *
+ * Purpose:     Reads the read-ahead window of a dataset, from a worker of
+ *              the asynchronous engine or inline
+ *
+ * Return:      Success:    0
+ *              Failure:    -1, the window stays invalid
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+dset_split_ra_fill(H5VL_dset_split_t *o, hid_t dxpl_id)
+{
+    H5VL_dset_split_ra_t *ra            = o->ra;
+    hid_t                 file_space_id = H5I_INVALID_HID;
+    hid_t                 mem_space_id  = H5I_INVALID_HID;
+    herr_t                ret_value     = -1;
+
+    if (!ra || !ra->data)
+        return -1;
+
+    if ((file_space_id = H5Scopy(ra->space_id)) < 0 || H5Sselect_none(file_space_id) < 0 ||
+        dset_split_select_run(file_space_id, ra->start, ra->nelem) < 0)
+        goto done;
+    if ((mem_space_id = H5Screate_simple(1, &ra->nelem, NULL)) < 0)
+        goto done;
+    ret_value = H5VLdataset_read(o->under_object, o->under_vol_id, ra->type_id, mem_space_id, file_space_id,
+                                 dxpl_id, ra->data, NULL);
+
+done:
+    if (mem_space_id >= 0)
+        H5Sclose(mem_space_id);
+    if (file_space_id >= 0)
+        H5Sclose(file_space_id);
+    ra->valid = (hbool_t)(ret_value >= 0);
+
+    return ret_value;
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    dset_split_ra_read
+ *
+ * Purpose:     Serves a dataset read of one run of elements of a
+ *              fixed-size type, both in memory and in the file, from the
+ *              read-ahead window, or reads it. After two reads in a row
+ *              of the same number of elements, each starting where the
+ *              previous one ended, the next 'read_ahead' such reads are
+ *              prefetched into the window: on a worker of the
+ *              asynchronous engine if HDF5 is thread-safe, else as one
+ *              read right away.
+ *
+ * Return:      1 if the read was done, 0 if it has to be done by the
+ *              caller, -1 on failure
+ *
+ *-------------------------------------------------------------------------
+ */
+static int
+dset_split_ra_read(H5VL_dset_split_t *o, hid_t mem_type_id, hid_t mem_space_id, hid_t file_space_id,
+                   hid_t dxpl_id, void *buf)
+{
+    H5VL_dset_split_file_ctx_t *file_ctx = o->file_ctx;
+    H5VL_dset_split_ra_t *      ra;
+    hsize_t                     start;
+    hsize_t                     nelem;
+    hsize_t                     mem_start;
+    hsize_t                     mem_nelem;
+    hsize_t                     npoints;
+    hsize_t                     nblocks;
+    size_t                      type_size;
+    hbool_t                     hit;
+
+    if (!file_ctx || file_ctx->read_ahead == 0 || o->subfile || file_space_id == H5S_ALL)
+        return 0;
+#ifdef H5_HAVE_PARALLEL
+    /* Reads may be collective */
+    if (file_ctx->comm != MPI_COMM_NULL)
+        return 0;
+#endif
+    if (dxpl_id == H5P_DEFAULT)
+        dxpl_id = H5P_DATASET_XFER_DEFAULT;
+
+    /* One run of fixed-size elements on both sides */
+    if (H5Sget_simple_extent_ndims(file_space_id) < 1 || !dset_split_select_contig(file_space_id, &start, &nelem) ||
+        nelem == 0)
+        return 0;
+    if (mem_space_id == H5S_ALL) {
+        mem_start = start;
+        mem_nelem = nelem;
+    }
+    else if (!dset_split_select_contig(mem_space_id, &mem_start, &mem_nelem))
+        return 0;
+    if (mem_nelem != nelem)
+        return 0;
+    if (0 == (type_size = H5Tget_size(mem_type_id)) || H5Tis_variable_str(mem_type_id) != 0 ||
+        H5Tdetect_class(mem_type_id, H5T_VLEN) != 0 || H5Tdetect_class(mem_type_id, H5T_REFERENCE) != 0)
+        return 0;
+
+    if (NULL == (ra = o->ra)) {
+        if (NULL == (ra = (H5VL_dset_split_ra_t *)calloc(1, sizeof(H5VL_dset_split_ra_t))))
+            return 0;
+        ra->type_id  = H5I_INVALID_HID;
+        ra->space_id = H5I_INVALID_HID;
+        o->ra        = ra;
+    }
+
+    /* From the window, if it holds the run in the same memory type */
+    hit = ra->valid && start >= ra->start && start + nelem <= ra->start + ra->nelem &&
+          H5Tequal(ra->type_id, mem_type_id) > 0 && H5Sextent_equal(ra->space_id, file_space_id) > 0;
+    if (hit)
+        memcpy((unsigned char *)buf + mem_start * type_size, ra->data + (start - ra->start) * type_size,
+               (size_t)(nelem * type_size));
+    else if (H5VLdataset_read(o->under_object, o->under_vol_id, mem_type_id, mem_space_id, file_space_id,
+                              dxpl_id, buf, NULL) < 0)
+        return -1;
+
+    /* Track sequential access */
+    if (start == ra->next_start && nelem == ra->last_nelem)
+        ra->nseq++;
+    else
+        ra->nseq = 0;
+    ra->next_start = start + nelem;
+    ra->last_nelem = nelem;
+    if (ra->nseq == 0)
+        return 1;
+
+    /* Prefetch the next reads, unless the window already holds the next one */
+    if (ra->valid && ra->next_start >= ra->start && ra->next_start + nelem <= ra->start + ra->nelem)
+        return 1;
+    npoints = (hsize_t)H5Sget_simple_extent_npoints(file_space_id);
+    if (ra->next_start >= npoints)
+        return 1;
+    nblocks = file_ctx->read_ahead;
+    if (nblocks * nelem * type_size > H5VL_DSET_SPLIT_RA_MAX)
+        nblocks = H5VL_DSET_SPLIT_RA_MAX / (nelem * type_size);
+    if (nblocks == 0)
+        return 1;
+
+    dset_split_ra_invalidate(o);
+    ra->start = ra->next_start;
+    ra->nelem = nblocks * nelem;
+    if (ra->start + ra->nelem > npoints)
+        ra->nelem = npoints - ra->start;
+    if (ra->type_id < 0 || H5Tequal(ra->type_id, mem_type_id) <= 0) {
+        if (ra->type_id >= 0)
+            H5Tclose(ra->type_id);
+        ra->type_id = H5Tcopy(mem_type_id);
+    }
+    if (ra->space_id >= 0)
+        H5Sclose(ra->space_id);
+    ra->space_id = H5Scopy(file_space_id);
+    if (ra->type_id < 0 || ra->space_id < 0 ||
+        NULL == (ra->data = (unsigned char *)malloc((size_t)(ra->nelem * type_size)))) {
+        dset_split_ra_invalidate(o);
+        return 1;
+    }
+    if (dset_split_async_prefetch(o, dxpl_id) < 0)
+        dset_split_ra_fill(o, dxpl_id);
+
+    return 1;
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    dset_split_mapped_free
+ *
+ * Purpose:     Frees the mapped view of a dataset. The mapping itself
+ *              belongs to the split file's pool entry.
+ *
+ *-------------------------------------------------------------------------
+ */
+static void
+dset_split_mapped_free(H5VL_dset_split_t *o)
+{
+    if (o->map->type_id >= 0)
+        H5Tclose(o->map->type_id);
+    free(o->map);
+    o->map = NULL;
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    dset_split_mapped_get
+ *
+ * Purpose:     Maps a dataset into memory, on first use: a contiguous
+ *              dataset with allocated storage, in a split file opened
+ *              read-only with a driver storing the file as is. The split
+ *              file is mapped once, for all its datasets.
+ *
+ * Return:      Success:    Mapped view, 'data' is NULL if the dataset
+ *                          can't be mapped
+ *              Failure:    NULL
+ *
+ *-------------------------------------------------------------------------
+ */
+static H5VL_dset_split_mapped_t *
+dset_split_mapped_get(H5VL_dset_split_t *o)
+{
+    H5VL_dset_split_pool_entry_t *      entry = o->split_file;
+    H5VL_dset_split_mapped_t *          map;
+    H5VL_dataset_get_args_t             get_args;
+    H5VL_optional_args_t                opt_args;
+    H5VL_native_dataset_optional_args_t dset_opt_args;
+    hid_t                               dcpl_id   = H5I_INVALID_HID;
+    hid_t                               space_id  = H5I_INVALID_HID;
+    hid_t                               fapl_id   = H5I_INVALID_HID;
+    hid_t                               fcpl_id   = H5I_INVALID_HID;
+    hid_t                               driver_id;
+    hsize_t                             userblock = 0;
+    hssize_t                            npoints;
+    haddr_t                             addr      = HADDR_UNDEF;
+
+    if (o->map)
+        return o->map;
+    if (NULL == (map = (H5VL_dset_split_mapped_t *)calloc(1, sizeof(H5VL_dset_split_mapped_t))))
+        return NULL;
+    map->type_id = H5I_INVALID_HID;
+    o->map       = map;
+
+    if (!o->file_ctx || !o->file_ctx->mmap_read || !o->set || !entry || o->subfile ||
+        (entry->flags & H5F_ACC_RDWR))
+        return map;
+
+    H5E_BEGIN_TRY
+    {
+        /* Contiguous storage, already allocated, of a fixed-size type */
+        get_args.op_type = H5VL_DATASET_GET_DCPL;
+        if (H5VLdataset_get(o->under_object, o->under_vol_id, &get_args, H5P_DATASET_XFER_DEFAULT, NULL) < 0)
+            goto done;
+        dcpl_id = get_args.args.get_dcpl.dcpl_id;
+        if (H5Pget_layout(dcpl_id) != H5D_CONTIGUOUS || H5Pget_external_count(dcpl_id) != 0)
+            goto done;
+
+        get_args.op_type = H5VL_DATASET_GET_TYPE;
+        if (H5VLdataset_get(o->under_object, o->under_vol_id, &get_args, H5P_DATASET_XFER_DEFAULT, NULL) < 0)
+            goto done;
+        map->type_id = get_args.args.get_type.type_id;
+        if (0 == (map->type_size = H5Tget_size(map->type_id)) || H5Tis_variable_str(map->type_id) != 0 ||
+            H5Tdetect_class(map->type_id, H5T_VLEN) != 0 || H5Tdetect_class(map->type_id, H5T_REFERENCE) != 0)
+            goto done;
+
+        get_args.op_type = H5VL_DATASET_GET_SPACE;
+        if (H5VLdataset_get(o->under_object, o->under_vol_id, &get_args, H5P_DATASET_XFER_DEFAULT, NULL) < 0)
+            goto done;
+        space_id = get_args.args.get_space.space_id;
+        if ((npoints = H5Sget_simple_extent_npoints(space_id)) <= 0)
+            goto done;
+
+        dset_opt_args.get_offset.offset = &addr;
+        opt_args.op_type                = H5VL_NATIVE_DATASET_GET_OFFSET;
+        opt_args.args                   = &dset_opt_args;
+        if (H5VLdataset_optional(o->under_object, o->under_vol_id, &opt_args, H5P_DATASET_XFER_DEFAULT, NULL) < 0 ||
+            addr == HADDR_UNDEF)
+            goto done;
+
+        /* The split file must be stored as a single plain file */
+        if ((fapl_id = H5Fget_access_plist(entry->fid)) < 0)
+            goto done;
+        driver_id = H5Pget_driver(fapl_id);
+        if (driver_id != H5FD_SEC2 && driver_id != H5FD_STDIO && driver_id != H5FD_CORE)
+            goto done;
+        if ((fcpl_id = H5Fget_create_plist(entry->fid)) < 0 || H5Pget_userblock(fcpl_id, &userblock) < 0)
+            goto done;
+
+        if (dset_split_pool_map(entry) < 0 ||
+            userblock + addr + (hsize_t)npoints * map->type_size > (hsize_t)entry->map_size)
+            goto done;
+        map->data   = entry->map + userblock + addr;
+        map->nbytes = (size_t)npoints * map->type_size;
+
+done:
+        if (dcpl_id >= 0)
+            H5Pclose(dcpl_id);
+        if (space_id >= 0)
+            H5Sclose(space_id);
+        if (fapl_id >= 0)
+            H5Pclose(fapl_id);
+        if (fcpl_id >= 0)
+            H5Pclose(fcpl_id);
+    }
+    H5E_END_TRY;
+
+    return map;
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    dset_split_mapped_read
+ *
+ * Purpose:     Serves a read of a mapped dataset with a memcpy, when the
+ *              memory type equals the dataset type and both selections
+ *              are one contiguous run of elements
+ *
+ * Return:      1 if the read was done, 0 if it has to go through the
+ *              library
+ *
+ *-------------------------------------------------------------------------
+ */
+static int
+dset_split_mapped_read(H5VL_dset_split_t *o, hid_t mem_type_id, hid_t mem_space_id, hid_t file_space_id,
+                       void *buf)
+{
+    H5VL_dset_split_mapped_t *map;
+    hsize_t                   start;
+    hsize_t                   nelem;
+    hsize_t                   mem_start;
+    hsize_t                   mem_nelem;
+
+    if (!o->file_ctx || !o->file_ctx->mmap_read)
+        return 0;
+    if (NULL == (map = dset_split_mapped_get(o)) || !map->data || H5Tequal(map->type_id, mem_type_id) <= 0)
+        return 0;
+
+    if (file_space_id == H5S_ALL) {
+        start = 0;
+        nelem = map->nbytes / map->type_size;
+    }
+    else if (!dset_split_select_contig(file_space_id, &start, &nelem))
+        return 0;
+    if (mem_space_id == H5S_ALL) {
+        mem_start = start;
+        mem_nelem = nelem;
+    }
+    else if (!dset_split_select_contig(mem_space_id, &mem_start, &mem_nelem))
+        return 0;
+    if (mem_nelem != nelem || (start + nelem) * map->type_size > map->nbytes)
+        return 0;
+
+    memcpy((unsigned char *)buf + mem_start * map->type_size, map->data + start * map->type_size,
+           (size_t)(nelem * map->type_size));
+
+    return 1;
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    dset_split_select_box
+ *
+ * Purpose:     Checks whether the selection of 'space_id' is one block of
+ *              elements
+ *
+ * Return:      TRUE, with the block in ['start', 'end'), or FALSE
+ *
+ *-------------------------------------------------------------------------
+ */
+static hbool_t
+dset_split_select_box(hid_t space_id, int rank, hsize_t *start, hsize_t *end)
+{
+    hsize_t  last[H5S_MAX_RANK];
+    hsize_t  nelem = 1;
+    hssize_t npoints;
+    int      i;
+
+    if (H5Sget_simple_extent_ndims(space_id) != rank || (npoints = H5Sget_select_npoints(space_id)) <= 0 ||
+        H5Sget_select_bounds(space_id, start, last) < 0)
+        return FALSE;
+    for (i = 0; i < rank; i++) {
+        end[i] = last[i] + 1;
+        nelem *= end[i] - start[i];
+    }
+
+    return nelem == (hsize_t)npoints;
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    dset_split_zip_free
+ *
+ * Purpose:     Frees the chunk filtering state of a dataset
+ *
+ *-------------------------------------------------------------------------
+ */
+static void
+dset_split_zip_free(H5VL_dset_split_t *o)
+{
+    if (o->zip->type_id >= 0)
+        H5Tclose(o->zip->type_id);
+    free(o->zip->fill);
+    free(o->zip);
+    o->zip = NULL;
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    dset_split_zip_get
+ *
+ * Purpose:     Checks, on first use, whether the connector can filter the
+ *              chunks of a dataset itself: a chunked dataset of a
+ *              fixed-size type, with deflate as its only filter
+ *
+ * Return:      Success:    Chunk filtering state, 'usable' is FALSE if the
+ *                          chunks must be filtered by the library
+ *              Failure:    NULL
+ *
+ *-------------------------------------------------------------------------
+ */
+static H5VL_dset_split_zip_t *
+dset_split_zip_get(H5VL_dset_split_t *o)
+{
+    H5VL_dset_split_zip_t * zip;
+    H5VL_dataset_get_args_t get_args;
+    hid_t                   dcpl_id = H5I_INVALID_HID;
+    H5D_fill_value_t        defined;
+    unsigned                flags;
+    unsigned                cd_values[1] = {6};
+    size_t                  cd_nelmts    = 1;
+    size_t                  u;
+    int                     i;
+
+    if (o->zip)
+        return o->zip;
+    if (NULL == (zip = (H5VL_dset_split_zip_t *)calloc(1, sizeof(H5VL_dset_split_zip_t))))
+        return NULL;
+    zip->type_id = H5I_INVALID_HID;
+    o->zip       = zip;
+
+    H5E_BEGIN_TRY
+    {
+        get_args.op_type = H5VL_DATASET_GET_DCPL;
+        if (H5VLdataset_get(o->under_object, o->under_vol_id, &get_args, H5P_DATASET_XFER_DEFAULT, NULL) < 0)
+            goto done;
+        dcpl_id = get_args.args.get_dcpl.dcpl_id;
+        if (H5Pget_layout(dcpl_id) != H5D_CHUNKED || H5Pget_nfilters(dcpl_id) != 1 ||
+            H5Pget_filter2(dcpl_id, 0, &flags, &cd_nelmts, cd_values, 0, NULL, NULL) != H5Z_FILTER_DEFLATE)
+            goto done;
+        if ((zip->rank = H5Pget_chunk(dcpl_id, H5S_MAX_RANK, zip->chunk_dims)) < 1)
+            goto done;
+        zip->level = (int)cd_values[0];
+
+        get_args.op_type = H5VL_DATASET_GET_TYPE;
+        if (H5VLdataset_get(o->under_object, o->under_vol_id, &get_args, H5P_DATASET_XFER_DEFAULT, NULL) < 0)
+            goto done;
+        zip->type_id = get_args.args.get_type.type_id;
+        if (0 == (zip->type_size = H5Tget_size(zip->type_id)) || H5Tis_variable_str(zip->type_id) != 0 ||
+            H5Tdetect_class(zip->type_id, H5T_VLEN) != 0 || H5Tdetect_class(zip->type_id, H5T_REFERENCE) != 0)
+            goto done;
+
+        /* Edge chunks are padded with the fill value */
+        if (H5Pfill_value_defined(dcpl_id, &defined) < 0)
+            goto done;
+        if (defined == H5D_FILL_VALUE_USER_DEFINED) {
+            if (NULL == (zip->fill = (unsigned char *)malloc(zip->type_size)) ||
+                H5Pget_fill_value(dcpl_id, zip->type_id, zip->fill) < 0)
+                goto done;
+            for (u = 0; u < zip->type_size && zip->fill[u] == 0; u++)
+                ;
+            if (u == zip->type_size) {
+                free(zip->fill);
+                zip->fill = NULL;
+            }
+        }
+
+        zip->chunk_bytes = zip->type_size;
+        for (i = 0; i < zip->rank; i++)
+            zip->chunk_bytes *= (size_t)zip->chunk_dims[i];
+        zip->usable = TRUE;
+
+done:
+        if (dcpl_id >= 0)
+            H5Pclose(dcpl_id);
+    }
+    H5E_END_TRY;
+
+    return zip;
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    dset_split_zip_copy
+ *
+ * Purpose:     Copies the part of a chunk inside the transferred block
+ *              from the application buffer into the uncompressed chunk
+ *              'raw' for writes, the other way around for reads
+ *
+ *-------------------------------------------------------------------------
+ */
+static void
+dset_split_zip_copy(const H5VL_dset_split_zip_batch_t *batch, const H5VL_dset_split_zip_chunk_t *chunk,
+                    unsigned char *raw)
+{
+    const H5VL_dset_split_zip_t *zip       = batch->zip;
+    size_t                       type_size = zip->type_size;
+    hsize_t                      lo[H5S_MAX_RANK];
+    hsize_t                      count[H5S_MAX_RANK];
+    hsize_t                      idx[H5S_MAX_RANK];
+    size_t                       row;
+    int                          i;
+
+    for (i = 0; i < zip->rank; i++) {
+        hsize_t hi = chunk->offset[i] + zip->chunk_dims[i];
+
+        lo[i]    = chunk->offset[i] > batch->start[i] ? chunk->offset[i] : batch->start[i];
+        count[i] = (hi < batch->end[i] ? hi : batch->end[i]) - lo[i];
+        idx[i]   = 0;
+    }
+    row = (size_t)count[zip->rank - 1] * type_size;
+
+    /* One row of the last dimension at a time */
+    for (;;) {
+        hsize_t raw_pos = 0;
+        hsize_t mem_pos = 0;
+
+        for (i = 0; i < zip->rank; i++) {
+            raw_pos = raw_pos * zip->chunk_dims[i] + lo[i] + idx[i] - chunk->offset[i];
+            mem_pos = mem_pos * batch->mem_dims[i] + batch->mem_origin[i] + lo[i] + idx[i] - batch->start[i];
+        }
+        if (batch->write)
+            memcpy(raw + raw_pos * type_size, batch->buf + mem_pos * type_size, row);
+        else
+            memcpy(batch->buf + mem_pos * type_size, raw + raw_pos * type_size, row);
+
+        for (i = zip->rank - 2; i >= 0; i--) {
+            if (++idx[i] < count[i])
+                break;
+            idx[i] = 0;
+        }
+        if (i < 0)
+            break;
+    }
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    dset_split_zip_filter
+ *
+ * Purpose:     Compresses a chunk of a write from the application buffer,
+ *              or expands a chunk of a read into it. 'raw' is scratch
+ *              space for one uncompressed chunk. Makes no HDF5 calls.
+ *
+ * Return:      Success:    0
+ *              Failure:    -1
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+dset_split_zip_filter(const H5VL_dset_split_zip_batch_t *batch, H5VL_dset_split_zip_chunk_t *chunk,
+                      unsigned char *raw)
+{
+    const H5VL_dset_split_zip_t *zip = batch->zip;
+    uLongf                       nbytes;
+    size_t                       u;
+    int                          i;
+
+    if (batch->write) {
+        /* Edge chunks are padded with the dataset's fill value, as the library pads them */
+        for (i = 0; i < zip->rank; i++)
+            if (chunk->offset[i] + zip->chunk_dims[i] > batch->end[i]) {
+                if (!zip->fill)
+                    memset(raw, 0, zip->chunk_bytes);
+                else
+                    for (u = 0; u < zip->chunk_bytes; u += zip->type_size)
+                        memcpy(raw + u, zip->fill, zip->type_size);
+                break;
+            }
+        dset_split_zip_copy(batch, chunk, raw);
+
+        nbytes = compressBound((uLong)zip->chunk_bytes);
+        if (NULL == (chunk->data = (unsigned char *)malloc((size_t)nbytes)))
+            return -1;
+        if (compress2(chunk->data, &nbytes, raw, (uLong)zip->chunk_bytes, zip->level) != Z_OK)
+            return -1;
+        chunk->nbytes = (size_t)nbytes;
+    }
+    else {
+        /* The library stores a chunk as is when the optional deflate filter fails */
+        if (chunk->filters & 1) {
+            if (chunk->nbytes != zip->chunk_bytes)
+                return -1;
+            memcpy(raw, chunk->data, zip->chunk_bytes);
+        }
+        else {
+            nbytes = (uLongf)zip->chunk_bytes;
+            if (uncompress(raw, &nbytes, chunk->data, (uLong)chunk->nbytes) != Z_OK ||
+                (size_t)nbytes != zip->chunk_bytes)
+                return -1;
+        }
+        dset_split_zip_copy(batch, chunk, raw);
+
+        free(chunk->data);
+        chunk->data = NULL;
+    }
+
+    return 0;
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    dset_split_zip_worker
+ *
+ * Purpose:     Thread filtering the chunks of a read or write, in order.
+ *              Compression runs at most 'window' chunks ahead of the chunk
+ *              writes; expansion follows the chunk reads.
+ *
+ *-------------------------------------------------------------------------
+ */
+static void *
+dset_split_zip_worker(void *arg)
+{
+    H5VL_dset_split_zip_batch_t *batch = (H5VL_dset_split_zip_batch_t *)arg;
+    unsigned char *              raw   = (unsigned char *)malloc(batch->zip->chunk_bytes);
+
+    pthread_mutex_lock(&batch->mutex);
+    for (;;) {
+        H5VL_dset_split_zip_chunk_t *chunk;
+        int                          status;
+
+        while (!batch->abort && batch->next < batch->nchunks &&
+               batch->next >= (batch->write ? batch->nio + batch->window : batch->nio))
+            pthread_cond_wait(&batch->cond, &batch->mutex);
+        if (batch->abort || batch->next >= batch->nchunks)
+            break;
+        chunk = &batch->chunks[batch->next++];
+        pthread_mutex_unlock(&batch->mutex);
+
+        status = raw && dset_split_zip_filter(batch, chunk, raw) >= 0 ? 1 : -1;
+
+        pthread_mutex_lock(&batch->mutex);
+        chunk->status = status;
+        batch->nfiltered++;
+        pthread_cond_broadcast(&batch->cond);
+    }
+    pthread_mutex_unlock(&batch->mutex);
+    free(raw);
+
+    return NULL;
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    dset_split_zip_plan
+ *
+ * Purpose:     Checks whether a dataset read or write can go through the
+ *              chunk compression pipeline and lists its chunks: the memory
+ *              type equals the dataset type, the file selection is one
+ *              block, made of whole chunks for writes, and the memory
+ *              selection is a block of the same shape or one contiguous
+ *              run. Reads need all their chunks allocated.
+ *
+ * Return:      TRUE, with 'batch' ready to start, or FALSE
+ *
+ *-------------------------------------------------------------------------
+ */
+static hbool_t
+dset_split_zip_plan(H5VL_dset_split_t *o, hid_t mem_type_id, hid_t mem_space_id, hid_t file_space_id,
+                    hid_t dxpl_id, void *buf, H5VL_dset_split_zip_batch_t *batch)
+{
+    const H5VL_dset_split_zip_t *       zip = batch->zip;
+    H5VL_dataset_get_args_t             get_args;
+    H5VL_optional_args_t                opt_args;
+    H5VL_native_dataset_optional_args_t dset_opt_args;
+    hid_t                               space_id = H5I_INVALID_HID;
+    hsize_t                             dims[H5S_MAX_RANK];
+    hsize_t                             mem_start[H5S_MAX_RANK];
+    hsize_t                             mem_end[H5S_MAX_RANK];
+    hsize_t                             first[H5S_MAX_RANK];
+    hsize_t                             nper[H5S_MAX_RANK];
+    hsize_t                             idx[H5S_MAX_RANK];
+    hsize_t                             nchunks = 1;
+    hsize_t                             nelem   = 1;
+    hsize_t                             run_start;
+    hsize_t                             run_nelem;
+    size_t                              u;
+    int                                 i;
+    hbool_t                             ret_value = FALSE;
+
+    H5E_BEGIN_TRY
+    {
+        if (H5Tequal(zip->type_id, mem_type_id) <= 0)
+            goto done;
+
+        /* The block of the dataset */
+        get_args.op_type = H5VL_DATASET_GET_SPACE;
+        if (H5VLdataset_get(o->under_object, o->under_vol_id, &get_args, dxpl_id, NULL) < 0)
+            goto done;
+        space_id = get_args.args.get_space.space_id;
+        if (H5Sget_simple_extent_dims(space_id, dims, NULL) != zip->rank)
+            goto done;
+        if (file_space_id == H5S_ALL) {
+            for (i = 0; i < zip->rank; i++) {
+                batch->start[i] = 0;
+                batch->end[i]   = dims[i];
+            }
+        }
+        else if (!dset_split_select_box(file_space_id, zip->rank, batch->start, batch->end))
+            goto done;
+        for (i = 0; i < zip->rank; i++) {
+            if (batch->start[i] >= batch->end[i])
+                goto done;
+            if (batch->write && (batch->start[i] % zip->chunk_dims[i] != 0 ||
+                                 (batch->end[i] % zip->chunk_dims[i] != 0 && batch->end[i] != dims[i])))
+                goto done;
+            nelem *= batch->end[i] - batch->start[i];
+        }
+
+        /* The application buffer */
+        batch->buf = (unsigned char *)buf;
+        if (mem_space_id == H5S_ALL)
+            for (i = 0; i < zip->rank; i++) {
+                batch->mem_dims[i]   = dims[i];
+                batch->mem_origin[i] = batch->start[i];
+            }
+        else if (dset_split_select_box(mem_space_id, zip->rank, mem_start, mem_end)) {
+            H5Sget_simple_extent_dims(mem_space_id, batch->mem_dims, NULL);
+            for (i = 0; i < zip->rank; i++) {
+                if (mem_end[i] - mem_start[i] != batch->end[i] - batch->start[i])
+                    goto done;
+                batch->mem_origin[i] = mem_start[i];
+            }
+        }
+        else if (dset_split_select_contig(mem_space_id, &run_start, &run_nelem) && run_nelem == nelem) {
+            batch->buf += run_start * zip->type_size;
+            for (i = 0; i < zip->rank; i++) {
+                batch->mem_dims[i]   = batch->end[i] - batch->start[i];
+                batch->mem_origin[i] = 0;
+            }
+        }
+        else
+            goto done;
+
+        /* The chunks, in row-major order, at least two to keep the threads busy */
+        for (i = 0; i < zip->rank; i++) {
+            first[i] = batch->start[i] / zip->chunk_dims[i];
+            nper[i]  = (batch->end[i] - 1) / zip->chunk_dims[i] - first[i] + 1;
+            idx[i]   = 0;
+            nchunks *= nper[i];
+        }
+        if (nchunks < 2 ||
+            NULL == (batch->chunks = (H5VL_dset_split_zip_chunk_t *)calloc((size_t)nchunks,
+                                                                            sizeof(H5VL_dset_split_zip_chunk_t))))
+            goto done;
+        batch->nchunks = (size_t)nchunks;
+        for (u = 0; u < batch->nchunks; u++) {
+            for (i = 0; i < zip->rank; i++)
+                batch->chunks[u].offset[i] = (first[i] + idx[i]) * zip->chunk_dims[i];
+            for (i = zip->rank - 1; i >= 0; i--) {
+                if (++idx[i] < nper[i])
+                    break;
+                idx[i] = 0;
+            }
+        }
+
+        if (!batch->write)
+            for (u = 0; u < batch->nchunks; u++) {
+                hsize_t size = 0;
+
+                dset_opt_args.get_chunk_storage_size.offset = batch->chunks[u].offset;
+                dset_opt_args.get_chunk_storage_size.size   = &size;
+                opt_args.op_type                            = H5VL_NATIVE_DATASET_GET_CHUNK_STORAGE_SIZE;
+                opt_args.args                               = &dset_opt_args;
+                if (H5VLdataset_optional(o->under_object, o->under_vol_id, &opt_args, dxpl_id, NULL) < 0 ||
+                    size == 0)
+                    goto done;
+                batch->chunks[u].nbytes = (size_t)size;
+            }
+
+        ret_value = TRUE;
+
+done:
+        if (space_id >= 0)
+            H5Sclose(space_id);
+    }
+    H5E_END_TRY;
+
+    if (!ret_value) {
+        free(batch->chunks);
+        batch->chunks  = NULL;
+        batch->nchunks = 0;
+    }
+
+    return ret_value;
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    dset_split_zip_io
+ *
+ * Purpose:     Reads or writes a chunked, deflate-compressed dataset
+ *              through the chunk compression pipeline: 'compress_threads'
+ *              threads compress or expand the chunks while this thread
+ *              writes or reads them with direct chunk I/O.
+ *
+ * Return:      1 if the transfer was done, 0 if it has to go through the
+ *              library, -1 on failure
+ *
+ *-------------------------------------------------------------------------
+ */
+static int
+dset_split_zip_io(H5VL_dset_split_t *o, hid_t mem_type_id, hid_t mem_space_id, hid_t file_space_id,
+                  hid_t dxpl_id, void *buf, hbool_t write)
+{
+    H5VL_dset_split_file_ctx_t *        file_ctx = o->file_ctx;
+    H5VL_dset_split_zip_batch_t         batch;
+    H5VL_optional_args_t                opt_args;
+    H5VL_native_dataset_optional_args_t dset_opt_args;
+    size_t                              nthreads;
+    size_t                              u;
+    int                                 ret_value = 1;
+
+    if (!file_ctx || file_ctx->compress_threads == 0 || o->subfile)
+        return 0;
+#ifdef H5_HAVE_PARALLEL
+    /* Transfers may be collective */
+    if (file_ctx->comm != MPI_COMM_NULL)
+        return 0;
+#endif
+    if (dxpl_id == H5P_DEFAULT)
+        dxpl_id = H5P_DATASET_XFER_DEFAULT;
+    else if (H5Pget_data_transform(dxpl_id, NULL, 0) > 0)
+        return 0;
+
+    memset(&batch, 0, sizeof(batch));
+    batch.write = write;
+    if (NULL == (batch.zip = dset_split_zip_get(o)) || !batch.zip->usable ||
+        !dset_split_zip_plan(o, mem_type_id, mem_space_id, file_space_id, dxpl_id, buf, &batch))
+        return 0;
+
+    nthreads = file_ctx->compress_threads;
+    if (nthreads > batch.nchunks)
+        nthreads = batch.nchunks;
+    if (nthreads > H5VL_DSET_SPLIT_ZIP_THREADS_MAX)
+        nthreads = H5VL_DSET_SPLIT_ZIP_THREADS_MAX;
+    batch.window = nthreads * H5VL_DSET_SPLIT_ZIP_WINDOW;
+    pthread_mutex_init(&batch.mutex, NULL);
+    pthread_cond_init(&batch.cond, NULL);
+    for (u = 0; u < nthreads; u++) {
+        if (pthread_create(&batch.threads[batch.nthreads], NULL, dset_split_zip_worker, &batch) != 0)
+            break;
+        batch.nthreads++;
+    }
+
+    /* No thread could be started, leave the transfer to the library */
+    if (batch.nthreads == 0) {
+        ret_value = 0;
+        goto done;
+    }
+
+    opt_args.args = &dset_opt_args;
+    for (u = 0; u < batch.nchunks; u++) {
+        H5VL_dset_split_zip_chunk_t *chunk = &batch.chunks[u];
+
+        if (write) {
+            /* Write the chunks in order, as they are compressed */
+            pthread_mutex_lock(&batch.mutex);
+            while (chunk->status == 0)
+                pthread_cond_wait(&batch.cond, &batch.mutex);
+            pthread_mutex_unlock(&batch.mutex);
+            if (chunk->status < 0)
+                break;
+
+            dset_opt_args.chunk_write.offset  = chunk->offset;
+            dset_opt_args.chunk_write.filters = 0;
+            dset_opt_args.chunk_write.size    = (uint32_t)chunk->nbytes;
+            dset_opt_args.chunk_write.buf     = chunk->data;
+            opt_args.op_type                  = H5VL_NATIVE_DATASET_CHUNK_WRITE;
+            if (H5VLdataset_optional(o->under_object, o->under_vol_id, &opt_args, dxpl_id, NULL) < 0)
+                break;
+            free(chunk->data);
+            chunk->data = NULL;
+        }
+        else {
+            /* Read the chunks in order, at most 'window' ahead of their expansion */
+            pthread_mutex_lock(&batch.mutex);
+            while (!batch.abort && batch.nio - batch.nfiltered >= batch.window)
+                pthread_cond_wait(&batch.cond, &batch.mutex);
+            pthread_mutex_unlock(&batch.mutex);
+            if (batch.abort)
+                break;
+
+            if (NULL == (chunk->data = (unsigned char *)malloc(chunk->nbytes)))
+                break;
+            dset_opt_args.chunk_read.offset  = chunk->offset;
+            dset_opt_args.chunk_read.filters = 0;
+            dset_opt_args.chunk_read.buf     = chunk->data;
+            opt_args.op_type                 = H5VL_NATIVE_DATASET_CHUNK_READ;
+            if (H5VLdataset_optional(o->under_object, o->under_vol_id, &opt_args, dxpl_id, NULL) < 0)
+                break;
+            chunk->filters = dset_opt_args.chunk_read.filters;
+        }
+
+        pthread_mutex_lock(&batch.mutex);
+        batch.nio = u + 1;
+        pthread_cond_broadcast(&batch.cond);
+        pthread_mutex_unlock(&batch.mutex);
+    }
+
+    if (u < batch.nchunks) {
+        ret_value = -1;
+        pthread_mutex_lock(&batch.mutex);
+        batch.abort = TRUE;
+        pthread_cond_broadcast(&batch.cond);
+        pthread_mutex_unlock(&batch.mutex);
+    }
+
+done:
+    for (u = 0; u < batch.nthreads; u++)
+        pthread_join(batch.threads[u], NULL);
+    pthread_cond_destroy(&batch.cond);
+    pthread_mutex_destroy(&batch.mutex);
+    for (u = 0; u < batch.nchunks; u++) {
+        if (ret_value > 0 && batch.chunks[u].status < 0)
+            ret_value = -1;
+        free(batch.chunks[u].data);
+    }
+    free(batch.chunks);
+
+    return ret_value;
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    dset_split_lazy_find
+ *
+ * Purpose:     Looks for a dataset of the file whose creation is deferred
+ *
+ * Return:      The deferred creation of the dataset at 'path', or NULL
+ *
+ *-------------------------------------------------------------------------
+ */
+static H5VL_dset_split_lazy_t *
+dset_split_lazy_find(const H5VL_dset_split_file_ctx_t *file_ctx, const char *path)
+{
+    H5VL_dset_split_lazy_t *lazy;
+
+    for (lazy = file_ctx->lazy_head; lazy; lazy = lazy->next)
+        if (!strcmp(lazy->path, path))
+            return lazy;
+
+    return NULL;
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    dset_split_lazy_unlink
+ *
+ * Purpose:     Takes a deferred creation off the list of its file
+ *
+ *-------------------------------------------------------------------------
+ */
+static void
+dset_split_lazy_unlink(H5VL_dset_split_file_ctx_t *file_ctx, H5VL_dset_split_lazy_t *lazy)
+{
+    H5VL_dset_split_lazy_t **prev;
+
+    for (prev = &file_ctx->lazy_head; *prev; prev = &(*prev)->next)
+        if (*prev == lazy) {
+            *prev = lazy->next;
+            break;
+        }
+    lazy->next = NULL;
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    dset_split_lazy_free
+ *
+ * Purpose:     Drops the deferred creation of a dataset, releasing its
+ *              group
+ *
+ *-------------------------------------------------------------------------
+ */
+static void
+dset_split_lazy_free(H5VL_dset_split_t *o)
+{
+    H5VL_dset_split_lazy_t *lazy = o->lazy;
+
+    dset_split_lazy_unlink(o->file_ctx, lazy);
+    if (lazy->loc_under)
+        H5VLgroup_close(lazy->loc_under, o->under_vol_id, H5P_DATASET_XFER_DEFAULT, NULL);
+    if (lazy->lcpl_id >= 0)
+        H5Pclose(lazy->lcpl_id);
+    if (lazy->type_id >= 0)
+        H5Tclose(lazy->type_id);
+    if (lazy->space_id >= 0)
+        H5Sclose(lazy->space_id);
+    if (lazy->dcpl_id >= 0)
+        H5Pclose(lazy->dcpl_id);
+    if (lazy->dapl_id >= 0)
+        H5Pclose(lazy->dapl_id);
+    free(lazy->name);
+    free(lazy->path);
+    free(lazy);
+    o->lazy = NULL;
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    dset_split_lazy_new
+ *
+ * Purpose:     Defers the creation of a dataset to its first write. The
+ *              dataset returned has no split file and no link yet; its
+ *              group is held open meanwhile. Creations the connector
+ *              can't replay later, with a committed type or in a group
+ *              that doesn't exist yet, are not deferred.
+ *
+ * Return:      Success:    0, with the placeholder dataset in '*dset', or
+ *                          NULL if the dataset must be created now
+ *              Failure:    -1, the dataset already exists
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+dset_split_lazy_new(H5VL_dset_split_t *o, const H5VL_loc_params_t *loc_params, const char *group_path,
+                    const char *dset_path, const char *dsetname, hid_t lcpl_id, hid_t type_id, hid_t space_id,
+                    hid_t dcpl_id, hid_t dapl_id, hid_t dxpl_id, H5VL_dset_split_t **dset)
+{
+    H5VL_dset_split_file_ctx_t *file_ctx = o->file_ctx;
+    H5VL_dset_split_lazy_t *    lazy;
+    H5VL_link_specific_args_t   vol_cb_args;
+    H5VL_loc_params_t           group_loc_params;
+    H5VL_loc_params_t           link_loc_params;
+    hbool_t                     exists = FALSE;
+    herr_t                      status = -1;
+
+    *dset = NULL;
+#ifdef H5_HAVE_PARALLEL
+    /* The ranks create datasets collectively */
+    if (file_ctx->comm != MPI_COMM_NULL)
+        return 0;
+#endif
+    if (dset_split_lazy_find(file_ctx, dset_path))
+        return -1;
+    if (H5Tcommitted(type_id) != 0)
+        return 0;
+
+    if (NULL == (*dset = H5VL_dset_split_new_obj(NULL, o->under_vol_id)))
+        return 0;
+    (*dset)->type = H5I_DATASET;
+    dset_split_inherit_file_ctx(*dset, o);
+    if (!(*dset)->file_ctx ||
+        NULL == ((*dset)->lazy = lazy = (H5VL_dset_split_lazy_t *)calloc(1, sizeof(H5VL_dset_split_lazy_t)))) {
+        H5VL_dset_split_free_obj(*dset);
+        *dset = NULL;
+        return 0;
+    }
+    lazy->lcpl_id  = H5Pcopy(lcpl_id);
+    lazy->type_id  = H5Tcopy(type_id);
+    lazy->space_id = H5Scopy(space_id);
+    lazy->dcpl_id  = H5Pcopy(dcpl_id);
+    lazy->dapl_id  = H5Pcopy(dapl_id);
+    lazy->name     = strdup(dsetname);
+    lazy->path     = strdup(dset_path);
+    lazy->dset     = *dset;
+    if (lazy->lcpl_id < 0 || lazy->type_id < 0 || lazy->space_id < 0 || lazy->dcpl_id < 0 ||
+        lazy->dapl_id < 0 || !lazy->name || !lazy->path || H5Sselect_all(lazy->space_id) < 0)
+        goto fail;
+
+    /* Hold the group open, and check the name is free */
+    group_loc_params.type     = H5VL_OBJECT_BY_SELF;
+    group_loc_params.obj_type = loc_params->obj_type;
+    link_loc_params.type                         = H5VL_OBJECT_BY_NAME;
+    link_loc_params.loc_data.loc_by_name.name    = dsetname;
+    link_loc_params.loc_data.loc_by_name.lapl_id = H5P_LINK_ACCESS_DEFAULT;
+    link_loc_params.obj_type                     = H5I_GROUP;
+    vol_cb_args.op_type                          = H5VL_LINK_EXISTS;
+    vol_cb_args.args.exists.exists               = &exists;
+    H5E_BEGIN_TRY {
+        if (NULL != (lazy->loc_under = H5VLgroup_open(o->under_object, &group_loc_params, o->under_vol_id,
+                                                      group_path, H5P_GROUP_ACCESS_DEFAULT, dxpl_id, NULL)))
+            status = H5VLlink_specific(lazy->loc_under, &link_loc_params, o->under_vol_id, &vol_cb_args,
+                                       dxpl_id, NULL);
+    } H5E_END_TRY;
+    if (!lazy->loc_under || status < 0)
+        goto fail;
+    if (exists) {
+        H5VL_dset_split_free_obj(*dset);
+        *dset = NULL;
+        return -1;
+    }
+
+    lazy->next          = file_ctx->lazy_head;
+    file_ctx->lazy_head = lazy;
+
+    return 0;
+
+fail:
+    H5VL_dset_split_free_obj(*dset);
+    *dset = NULL;
+
+    return 0;
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    dset_split_lazy_create
+ *
+ * Purpose:     Creates a dataset whose creation was deferred, in place of
+ *              its placeholder: in its split file, or only in the main
+ *              file for a dataset closed before any write. Does nothing
+ *              for other datasets.
+ *
+ * Return:      Success:    0
+ *              Failure:    -1, the dataset stays deferred
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+dset_split_lazy_create(H5VL_dset_split_t *o, hbool_t split)
+{
+    H5VL_dset_split_lazy_t *lazy = o->lazy;
+    H5VL_dset_split_t *     loc;
+    H5VL_dset_split_t *     created = NULL;
+    H5VL_loc_params_t       loc_params;
+    void *                  under = NULL;
+
+    if (!lazy)
+        return 0;
+
+    loc_params.type     = H5VL_OBJECT_BY_SELF;
+    loc_params.obj_type = H5I_GROUP;
+    if (split) {
+        /* The regular creation, from the dataset's group. The deferred
+         * creation is off the list meanwhile, or its name would be taken */
+        if (NULL == (loc = H5VL_dset_split_new_obj(lazy->loc_under, o->under_vol_id)))
+            return -1;
+        loc->type = H5I_GROUP;
+        dset_split_inherit_file_ctx(loc, o);
+        dset_split_lazy_unlink(o->file_ctx, lazy);
+        created = (H5VL_dset_split_t *)dset_split_dataset_create(
+            loc, &loc_params, lazy->name, lazy->lcpl_id, lazy->type_id, lazy->space_id, lazy->dcpl_id,
+            lazy->dapl_id, H5P_DATASET_XFER_DEFAULT, NULL, H5VL_DSET_SPLIT_CREATE_QUEUE);
+        H5VL_dset_split_free_obj(loc);
+        if (!created) {
+            lazy->next             = o->file_ctx->lazy_head;
+            o->file_ctx->lazy_head = lazy;
+            return -1;
+        }
+    }
+    else if (NULL == (under = H5VLdataset_create(lazy->loc_under, &loc_params, o->under_vol_id, lazy->name,
+                                                 lazy->lcpl_id, lazy->type_id, lazy->space_id, lazy->dcpl_id,
+                                                 lazy->dapl_id, H5P_DATASET_XFER_DEFAULT, NULL)))
+        return -1;
+
+    dset_split_lazy_free(o);
+    if (created) {
+        /* Fill the placeholder the application holds in */
+        if (created->file_ctx)
+            dset_split_file_ctx_release(created->file_ctx);
+        created->file_ctx = o->file_ctx;
+        created->queue    = o->queue;
+        H5Idec_ref(created->under_vol_id);
+        *o = *created;
+        dset_split_user_moved(o);
+        free(created);
+    }
+    else
+        o->under_object = under;
+
+    return 0;
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    dset_split_lazy_sync
+ *
+ * Purpose:     Creates the deferred datasets an operation on the links
+ *              of the main file may look up: the one a name relative to
+ *              an object stands for, or all of the file's if 'name' is
+ *              NULL
+ *
+ * Return:      Success:    0
+ *              Failure:    -1
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+dset_split_lazy_sync(H5VL_dset_split_t *o, const H5VL_loc_params_t *loc_params, const char *name)
+{
+    H5VL_dset_split_lazy_t *lazy       = NULL;
+    char *                  group_path = NULL;
+    char *                  dset_path  = NULL;
+    char *                  temp_path;
+    char *                  dsetname;
+
+    if (!o->file_ctx || !o->file_ctx->lazy_head)
+        return 0;
+
+    if (!name) {
+        while (NULL != (lazy = o->file_ctx->lazy_head)) {
+            dset_split_async_sync(lazy->dset);
+            if (dset_split_lazy_create(lazy->dset, TRUE) < 0)
+                return -1;
+        }
+        return 0;
+    }
+
+    if (NULL == (temp_path = strdup(name)))
+        return -1;
+    if (NULL != (dsetname = get_dataset_name(temp_path)) &&
+        dset_split_get_dataset_path(o, loc_params, name, dsetname, &group_path, &dset_path) >= 0)
+        lazy = dset_split_lazy_find(o->file_ctx, dset_path);
+    free(group_path);
+    free(dset_path);
+    free(temp_path);
+
+    if (!lazy)
+        return 0;
+    dset_split_async_sync(lazy->dset);
+
+    return dset_split_lazy_create(lazy->dset, TRUE);
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    dset_split_lazy_get
+ *
+ * Purpose:     Answers a query on a dataset whose creation is deferred,
+ *              from its creation arguments
+ *
+ * Return:      Success:    0
+ *              Failure:    -1
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+dset_split_lazy_get(const H5VL_dset_split_lazy_t *lazy, H5VL_dataset_get_args_t *args)
+{
+    switch (args->op_type) {
+        case H5VL_DATASET_GET_DAPL:
+            return (args->args.get_dapl.dapl_id = H5Pcopy(lazy->dapl_id)) < 0 ? -1 : 0;
+
+        case H5VL_DATASET_GET_DCPL:
+            return (args->args.get_dcpl.dcpl_id = H5Pcopy(lazy->dcpl_id)) < 0 ? -1 : 0;
+
+        case H5VL_DATASET_GET_SPACE:
+            return (args->args.get_space.space_id = H5Scopy(lazy->space_id)) < 0 ? -1 : 0;
+
+        case H5VL_DATASET_GET_SPACE_STATUS:
+            *args->args.get_space_status.status = H5D_SPACE_STATUS_NOT_ALLOCATED;
+            return 0;
+
+        case H5VL_DATASET_GET_STORAGE_SIZE:
+            *args->args.get_storage_size.storage_size = 0;
+            return 0;
+
+        case H5VL_DATASET_GET_TYPE:
+            return (args->args.get_type.type_id = H5Tcopy(lazy->type_id)) < 0 ? -1 : 0;
+
+        default:
+            return -1;
+    }
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    dset_split_lazy_read
+ *
+ * Purpose:     Reads a dataset whose creation is deferred: it was never
+ *              written, the selection gets the fill value
+ *
+ * Return:      Success:    0
+ *              Failure:    -1
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+dset_split_lazy_read(const H5VL_dset_split_lazy_t *lazy, hid_t mem_type_id, hid_t mem_space_id,
+                     hid_t file_space_id, void *buf)
+{
+    H5D_fill_value_t defined = H5D_FILL_VALUE_UNDEFINED;
+    void *           fill;
+    size_t           type_size;
+    herr_t           ret_value = -1;
+
+    /* Memory is shaped like the file selection */
+    if (mem_space_id == H5S_ALL)
+        mem_space_id = file_space_id == H5S_ALL ? lazy->space_id : file_space_id;
+
+    if (0 == (type_size = H5Tget_size(mem_type_id)) || NULL == (fill = calloc(1, type_size)))
+        return -1;
+    if (H5Pfill_value_defined(lazy->dcpl_id, &defined) >= 0 && defined != H5D_FILL_VALUE_UNDEFINED &&
+        H5Pget_fill_value(lazy->dcpl_id, mem_type_id, fill) < 0)
+        goto done;
+    ret_value = H5Dfill(fill, mem_type_id, buf, mem_type_id, mem_space_id);
+
+done:
+    free(fill);
+
+    return ret_value;
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    dset_split_user_bind / dset_split_user_unbind
+ *
+ * Purpose:     Adds / removes a dataset to / from the datasets opened
+ *              from its split file, and its chunk cache to / from the
+ *              memory budget
+ *
+ *-------------------------------------------------------------------------
+ */
+static void
+dset_split_user_bind(H5VL_dset_split_t *o)
+{
+    H5VL_dset_split_gov_t *       gov   = &H5VL_dset_split_gov_g;
+    H5VL_dset_split_pool_entry_t *entry = o->split_file;
+    H5VL_dataset_get_args_t       get_args;
+    H5D_layout_t                  layout = H5D_LAYOUT_ERROR;
+    size_t                        nslots, nbytes = 0;
+    double                        w0;
+
+    o->user_prev = NULL;
+    o->user_next = entry->users;
+    if (entry->users)
+        entry->users->user_prev = o;
+    entry->users = o;
+
+    if (gov->budget == 0)
+        return;
+
+    /* Only chunked datasets have a chunk cache */
+    get_args.op_type = H5VL_DATASET_GET_DCPL;
+    if (H5VLdataset_get(o->under_object, o->under_vol_id, &get_args, H5P_DATASET_XFER_DEFAULT, NULL) >= 0) {
+        layout = H5Pget_layout(get_args.args.get_dcpl.dcpl_id);
+        H5Pclose(get_args.args.get_dcpl.dcpl_id);
+        get_args.op_type = H5VL_DATASET_GET_DAPL;
+        if (layout == H5D_CHUNKED &&
+            H5VLdataset_get(o->under_object, o->under_vol_id, &get_args, H5P_DATASET_XFER_DEFAULT, NULL) >= 0) {
+            if (H5Pget_chunk_cache(get_args.args.get_dapl.dapl_id, &nslots, &nbytes, &w0) < 0)
+                nbytes = 0;
+            H5Pclose(get_args.args.get_dapl.dapl_id);
+        }
+    }
+    if (layout != H5D_CHUNKED)
+        return;
+    o->cache_bytes  = nbytes;
+    o->cache_weight = 1 + entry->naccess;
+    gov->chunk_used += nbytes;
+    gov->weight += o->cache_weight;
+    gov->nusers++;
+}
+
+static void
+dset_split_user_unbind(H5VL_dset_split_t *o)
+{
+    H5VL_dset_split_gov_t *gov = &H5VL_dset_split_gov_g;
+
+    if (o->user_prev)
+        o->user_prev->user_next = o->user_next;
+    else if (o->split_file && o->split_file->users == o)
+        o->split_file->users = o->user_next;
+    if (o->user_next)
+        o->user_next->user_prev = o->user_prev;
+    o->user_prev = o->user_next = NULL;
+
+    if (o->cache_weight == 0)
+        return;
+    gov->chunk_used -= gov->chunk_used < o->cache_bytes ? gov->chunk_used : o->cache_bytes;
+    gov->weight -= gov->weight < o->cache_weight ? gov->weight : o->cache_weight;
+    gov->nusers--;
+    o->cache_bytes  = 0;
+    o->cache_weight = 0;
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    dset_split_user_moved
+ *
+ * Purpose:     Updates the datasets opened from a split file after the
+ *              object of one of them was copied to 'o', the placeholder
+ *              the application holds
+ *
+ *-------------------------------------------------------------------------
+ */
+static void
+dset_split_user_moved(H5VL_dset_split_t *o)
+{
+    if (!o->split_file)
+        return;
+
+    if (o->user_prev)
+        o->user_prev->user_next = o;
+    else
+        o->split_file->users = o;
+    if (o->user_next)
+        o->user_next->user_prev = o;
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    dset_split_detached_free
+ *
+ * Purpose:     Frees what a detached dataset needs to reopen its split
+ *              file
+ *
+ *-------------------------------------------------------------------------
+ */
+static void
+dset_split_detached_free(H5VL_dset_split_t *o)
+{
+    if (o->detached->dapl_id >= 0)
+        H5Pclose(o->detached->dapl_id);
+    free(o->detached->file_name);
+    free(o->detached->obj_path);
+    free(o->detached);
+    o->detached = NULL;
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    dset_split_detach
+ *
+ * Purpose:     Closes a dataset in its split file, keeping what is needed
+ *              to reopen it, and gives the split file back: the dataset's
+ *              buffered writes are written first. Datasets with
+ *              asynchronous tasks, or whose mapped bytes the application
+ *              may hold, stay open.
+ *
+ * Return:      Success:    0
+ *              Failure:    -1, the dataset stays open
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+dset_split_detach(H5VL_dset_split_t *o)
+{
+    H5VL_dset_split_pool_entry_t *entry = o->split_file;
+    H5VL_dset_split_detached_t *  detached;
+    H5VL_object_get_args_t        get_args;
+    H5VL_dataset_get_args_t       dset_args;
+    H5VL_loc_params_t             loc_params;
+    size_t                        name_len = 0;
+    size_t                        nslots, nbytes;
+    double                        w0;
+
+    if (!entry || o->subfile || o->lazy || o->task || (o->map && o->map->data) || !dset_split_async_idle(o))
+        return -1;
+    if (dset_split_wb_flush(o) < 0)
+        return -1;
+
+    if (NULL == (detached = (H5VL_dset_split_detached_t *)calloc(1, sizeof(H5VL_dset_split_detached_t))))
+        return -1;
+    detached->dapl_id = H5I_INVALID_HID;
+    detached->flags   = entry->flags;
+
+    /* The dataset's path in the split file, and its access properties */
+    loc_params.type                    = H5VL_OBJECT_BY_SELF;
+    loc_params.obj_type                = H5I_DATASET;
+    get_args.op_type                   = H5VL_OBJECT_GET_NAME;
+    get_args.args.get_name.buf_size    = 0;
+    get_args.args.get_name.buf         = NULL;
+    get_args.args.get_name.name_len    = &name_len;
+    if (H5VLobject_get(o->under_object, &loc_params, o->under_vol_id, &get_args, H5P_DATASET_XFER_DEFAULT,
+                       NULL) < 0 ||
+        name_len == 0 || NULL == (detached->obj_path = (char *)calloc(name_len + 1, 1)))
+        goto fail;
+    get_args.args.get_name.buf_size = name_len + 1;
+    get_args.args.get_name.buf      = detached->obj_path;
+    if (H5VLobject_get(o->under_object, &loc_params, o->under_vol_id, &get_args, H5P_DATASET_XFER_DEFAULT,
+                       NULL) < 0)
+        goto fail;
+    dset_args.op_type = H5VL_DATASET_GET_DAPL;
+    if (H5VLdataset_get(o->under_object, o->under_vol_id, &dset_args, H5P_DATASET_XFER_DEFAULT, NULL) < 0)
+        goto fail;
+    detached->dapl_id = dset_args.args.get_dapl.dapl_id;
+    if (NULL == (detached->file_name = strdup(entry->path)))
+        goto fail;
+
+    /* The chunk cache was the dataset's share of the memory budget, it gets a new share when reopened */
+    if (o->cache_bytes > 0 && H5Pget_chunk_cache(detached->dapl_id, &nslots, &nbytes, &w0) >= 0)
+        H5Pset_chunk_cache(detached->dapl_id, nslots, H5D_CHUNK_CACHE_NBYTES_DEFAULT, w0);
+
+    if (H5VLdataset_close(o->under_object, o->under_vol_id, H5P_DATASET_XFER_DEFAULT, NULL) < 0)
+        goto fail;
+    if (o->map)
+        dset_split_mapped_free(o);
+    dset_split_user_unbind(o);
+    entry->nrefs--;
+    o->under_object = NULL;
+    o->split_file   = NULL;
+    o->fid          = H5I_INVALID_HID;
+    o->detached     = detached;
+
+    return 0;
+
+fail:
+    o->detached = detached;
+    dset_split_detached_free(o);
+
+    return -1;
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    dset_split_rebind
+ *
+ * Purpose:     Reopens the split file of a detached dataset, and the
+ *              dataset in it. Marks the split file of other datasets as
+ *              just used, the ones least recently used are closed first.
+ *
+ * Return:      Success:    0
+ *              Failure:    -1, the dataset stays detached
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+dset_split_rebind(H5VL_dset_split_t *o)
+{
+    H5VL_dset_split_detached_t *  detached = o->detached;
+    H5VL_dset_split_pool_entry_t *entry;
+    H5VL_loc_params_t             loc_params;
+    hid_t                         dapl_id;
+    hid_t                         gov_dapl_id;
+    void *                        under;
+
+    /* A dataset of rank-local split files has no storage before its first collective write */
+    if (o->subfile && o->subfile->pending)
+        return -1;
+
+    if (!detached) {
+        if (o->split_file) {
+            o->split_file->naccess++;
+            if (H5VL_dset_split_pool_g.max_open > 0) {
+                dset_split_pool_lru_unlink(o->split_file);
+                dset_split_pool_lru_push(o->split_file);
+            }
+        }
+        return 0;
+    }
+
+    if (NULL == (entry = dset_split_pool_open(detached->file_name, detached->flags,
+                                              o->file_ctx ? o->file_ctx->fapl_id : H5P_FILE_ACCESS_DEFAULT)))
+        return -1;
+
+    /* Reopened with the dataset's share of the memory budget at the time */
+    loc_params.type     = H5VL_OBJECT_BY_SELF;
+    loc_params.obj_type = H5I_FILE;
+    dapl_id             = detached->dapl_id >= 0 ? detached->dapl_id : H5P_DATASET_ACCESS_DEFAULT;
+    gov_dapl_id         = dset_split_gov_dapl(entry, dapl_id);
+    under = H5VLdataset_open(H5VLobject(entry->fid), &loc_params, o->under_vol_id, detached->obj_path,
+                             gov_dapl_id >= 0 ? gov_dapl_id : dapl_id, H5P_DATASET_XFER_DEFAULT, NULL);
+    if (gov_dapl_id >= 0)
+        H5Pclose(gov_dapl_id);
+    if (!under) {
+        dset_split_pool_release(entry);
+        return -1;
+    }
+
+    dset_split_detached_free(o);
+    o->under_object = under;
+    o->split_file   = entry;
+    o->fid          = entry->fid;
+    dset_split_user_bind(o);
+
+    return 0;
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    dset_split_pool_trim
+ *
+ * Purpose:     Keeps the number of open split files within
+ *              'max_open_files': closes idle split files first, then the
+ *              least recently used split files whose datasets can all be
+ *              detached, to be reopened on their next access
+ *
+ *-------------------------------------------------------------------------
+ */
+static void
+dset_split_pool_trim(void)
+{
+    H5VL_dset_split_pool_t *      pool = &H5VL_dset_split_pool_g;
+    H5VL_dset_split_pool_entry_t *entry, *prev;
+    H5VL_dset_split_t *           user, *next;
+    size_t                        excess;
+    unsigned                      nusers;
+
+    if (pool->max_open == 0 || pool->nentries <= pool->max_open)
+        return;
+
+    excess = pool->nentries - pool->max_open;
+    dset_split_pool_evict(pool->nidle > excess ? pool->nidle - excess : 0);
+
+    for (entry = pool->tail; entry && pool->nentries > pool->max_open; entry = prev) {
+        prev = entry->prev;
+        if (entry->nrefs == 0)
+            continue;
+
+        /* All borrowers must be datasets */
+        for (nusers = 0, user = entry->users; user; user = user->user_next)
+            nusers++;
+        if (nusers != entry->nrefs)
+            continue;
+
+        for (user = entry->users; user; user = next) {
+            next = user->user_next;
+            dset_split_detach(user);
+        }
+        if (entry->nrefs == 0)
+            dset_split_pool_remove(entry);
+    }
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    dset_split_gov_mdc
+ *
+ * Purpose:     Sets the metadata cache size of an open split file
+ *
+ * Return:      Success:    0
+ *              Failure:    -1
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+dset_split_gov_mdc(hid_t fid, size_t size)
+{
+    H5AC_cache_config_t config;
+
+    config.version = H5AC__CURR_CACHE_CONFIG_VERSION;
+    if (H5Fget_mdc_config(fid, &config) < 0)
+        return -1;
+
+    config.set_initial_size = TRUE;
+    config.initial_size     = size;
+    config.max_size         = size;
+    if (config.min_size > size)
+        config.min_size = size;
+
+    return H5Fset_mdc_config(fid, &config);
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    dset_split_gov_files
+ *
+ * Purpose:     Shares the metadata cache part of the memory budget
+ *              between the open split files, after 'opened' was opened
+ *              or, if NULL, a split file was closed. The size moves by
+ *              powers of two, so that the split files already open are
+ *              only resized when their number about doubles or halves.
+ *
+ *-------------------------------------------------------------------------
+ */
+static void
+dset_split_gov_files(H5VL_dset_split_pool_entry_t *opened)
+{
+    H5VL_dset_split_gov_t *       gov  = &H5VL_dset_split_gov_g;
+    H5VL_dset_split_pool_t *      pool = &H5VL_dset_split_pool_g;
+    H5VL_dset_split_pool_entry_t *entry;
+    hsize_t                       target;
+    size_t                        size;
+
+    if (gov->budget == 0 || pool->nentries == 0)
+        return;
+
+    target = gov->budget / H5VL_DSET_SPLIT_GOV_MDC_SHARE / pool->nentries;
+    size   = gov->mdc_size ? gov->mdc_size : H5VL_DSET_SPLIT_GOV_MDC_MAX;
+    while (size > H5VL_DSET_SPLIT_GOV_MDC_MIN && size > target)
+        size /= 2;
+    while (size < H5VL_DSET_SPLIT_GOV_MDC_MAX && 2 * (hsize_t)size <= target)
+        size *= 2;
+
+    if (size != gov->mdc_size) {
+        gov->mdc_size = size;
+        for (entry = pool->head; entry; entry = entry->next)
+            dset_split_gov_mdc(entry->fid, size);
+    }
+    else if (opened)
+        dset_split_gov_mdc(opened->fid, size);
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    dset_split_gov_rebalance
+ *
+ * Purpose:     Makes room for 'needed' bytes in the chunk cache part of
+ *              the memory budget, for a dataset of weight 'weight': the
+ *              datasets holding more than their share are detached,
+ *              least recently used split files first, to be reopened
+ *              with a new share on their next access. The share of a
+ *              dataset follows the accesses to its split file.
+ *
+ *-------------------------------------------------------------------------
+ */
+static void
+dset_split_gov_rebalance(hsize_t chunk_budget, uint64_t weight, hsize_t needed)
+{
+    H5VL_dset_split_gov_t *       gov  = &H5VL_dset_split_gov_g;
+    H5VL_dset_split_pool_t *      pool = &H5VL_dset_split_pool_g;
+    H5VL_dset_split_pool_entry_t *entry;
+    H5VL_dset_split_t *           user, *next;
+    uint64_t                      total = weight;
+    double                        fair;
+
+    for (entry = pool->head; entry; entry = entry->next)
+        for (user = entry->users; user; user = user->user_next)
+            if (user->cache_weight > 0)
+                total += 1 + entry->naccess;
+
+    for (entry = pool->tail; entry && gov->chunk_used + needed > chunk_budget; entry = entry->prev) {
+        fair = (double)chunk_budget * (double)(1 + entry->naccess) / (double)total;
+        for (user = entry->users; user && gov->chunk_used + needed > chunk_budget; user = next) {
+            next = user->user_next;
+            if ((double)user->cache_bytes > fair && dset_split_detach(user) >= 0 && entry->nrefs == 0)
+                pool->nidle++;
+        }
+    }
+
+    dset_split_pool_evict(pool->capacity);
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    dset_split_gov_dapl
+ *
+ * Purpose:     Gives a dataset about to be opened or created in the split
+ *              file 'entry' its chunk cache from the memory budget: the
+ *              size asked by the application, or the split file's
+ *              default, scaled by the dataset's weight relative to the
+ *              open datasets, within its fair share of the budget
+ *
+ * Return:      Success:    Copy of 'dapl_id' with the chunk cache set,
+ *                          closed by the caller
+ *              Failure:    H5I_INVALID_HID, 'dapl_id' is used as is
+ *
+ *-------------------------------------------------------------------------
+ */
+static hid_t
+dset_split_gov_dapl(H5VL_dset_split_pool_entry_t *entry, hid_t dapl_id)
+{
+    H5VL_dset_split_gov_t *gov = &H5VL_dset_split_gov_g;
+    hsize_t                chunk_budget;
+    double                 share, fair;
+    uint64_t               weight;
+    size_t                 nslots, nbytes;
+    double                 w0;
+    int                    mdc_nelmts;
+    hid_t                  fapl_id;
+    hid_t                  gov_dapl_id;
+
+    if (gov->budget == 0)
+        return H5I_INVALID_HID;
+
+    if ((gov_dapl_id = H5Pcopy(dapl_id)) < 0)
+        return H5I_INVALID_HID;
+    if (H5Pget_chunk_cache(gov_dapl_id, &nslots, &nbytes, &w0) < 0)
+        goto fail;
+    if (nbytes == H5D_CHUNK_CACHE_NBYTES_DEFAULT) {
+        if ((fapl_id = H5Fget_access_plist(entry->fid)) < 0)
+            goto fail;
+        if (H5Pget_cache(fapl_id, &mdc_nelmts, NULL, &nbytes, NULL) < 0)
+            nbytes = 0;
+        H5Pclose(fapl_id);
+    }
+
+    chunk_budget = gov->budget - gov->budget / H5VL_DSET_SPLIT_GOV_MDC_SHARE;
+    weight       = 1 + entry->naccess;
+    share        = gov->nusers ? (double)nbytes * (double)weight * (double)gov->nusers / (double)gov->weight
+                               : (double)nbytes;
+    fair         = (double)chunk_budget * (double)weight / (double)(gov->weight + weight);
+    if (share > fair)
+        share = fair;
+    if ((double)gov->chunk_used + share > (double)chunk_budget)
+        dset_split_gov_rebalance(chunk_budget, weight, (hsize_t)share);
+    if ((double)gov->chunk_used + share > (double)chunk_budget)
+        share = chunk_budget > gov->chunk_used ? (double)(chunk_budget - gov->chunk_used) : 0;
+
+    if (H5Pset_chunk_cache(gov_dapl_id, nslots, (size_t)share, w0) < 0)
+        goto fail;
+
+    return gov_dapl_id;
+
+fail:
+    H5Pclose(gov_dapl_id);
+
+    return H5I_INVALID_HID;
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    dset_split_dataset_io_multi
+ *
+ * Purpose:     Reads or writes 'count' datasets. With the 'direct_io'
+ *              option, the transfers that only copy bytes between memory
+ *              and a contiguous dataset of a split file bypass the
+ *              library. They are grouped by split file and run in
+ *              parallel, one thread per split file, while the other
+ *              transfers go through H5Dread/H5Dwrite. The application
+ *              calls it outside of HDF5: the transfers are sorted out,
+ *              and the split files taken and given back, under the
+ *              library lock.
+ *
+ * Return:      Success:    0
+ *              Failure:    -1, if any of the transfers failed
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+dset_split_dataset_io_multi(size_t count, const hid_t dset_ids[], const hid_t mem_type_ids[],
+                            const hid_t mem_space_ids[], const hid_t file_space_ids[], hid_t dxpl_id,
+                            void *const bufs[], hbool_t write)
+{
+    FUNC_ENTER_VOL(herr_t, 0)
+    H5VL_dset_split_direct_batch_t batch;
+    hbool_t *direct = NULL;
+    hbool_t *busy = NULL;
+    hbool_t transform = FALSE;
+    size_t nfailed = 0;
+    size_t nplanned = 0;
+    size_t u;
+    int pass;
+#ifdef H5_HAVE_THREADSAFE
+    hbool_t locked = FALSE;
+#endif
+
+    memset(&batch, 0, sizeof(batch));
+    pthread_mutex_init(&batch.mutex, NULL);
+    batch.write = write;
+
+    if(count == 0)
+        HGOTO_DONE(0);
+    if(NULL == (batch.jobs = (H5VL_dset_split_direct_t *)malloc(count * sizeof(H5VL_dset_split_direct_t))) ||
+       NULL == (direct = (hbool_t *)calloc(count, sizeof(hbool_t))) ||
+       NULL == (busy = (hbool_t *)calloc(count, sizeof(hbool_t))))
+        HGOTO_ERROR(H5E_VOL, H5E_CANTALLOC, -1, "Memory allocation failed");
+
+    /*A data transform needs the library*/
+    if(dxpl_id != H5P_DEFAULT && H5Pget_data_transform(dxpl_id, NULL, 0) > 0)
+        transform = TRUE;
+
+#ifdef H5_HAVE_THREADSAFE
+    /*Outside of any HDF5 call: take the library lock, the asynchronous workers change the pool under it*/
+    dset_split_hdf5_lock(1);
+    locked = TRUE;
+#endif
+
+    /*Sort out the transfers that can bypass the library*/
+    for(u = 0; u < count && !transform; u++)
+        if((direct[u] = dset_split_direct_plan(dset_ids[u], mem_type_ids[u], mem_space_ids[u], file_space_ids[u],
+                                               bufs[u], write, &batch.jobs[batch.njobs])))
+            batch.njobs++;
+    nplanned = batch.njobs;
+    if(dset_split_direct_start(&batch) < 0)
+    {
+        memset(direct, 0, count * sizeof(hbool_t));
+        batch.njobs = 0;
+    }
+
+    /*The others go through the library meanwhile, those sharing a split file with the jobs once they are done*/
+    for(u = 0; u < count; u++)
+        if(!direct[u])
+            busy[u] = dset_split_direct_busy(&batch, dset_ids[u]);
+#ifdef H5_HAVE_THREADSAFE
+    dset_split_hdf5_unlock();
+    locked = FALSE;
+#endif
+    for(pass = 0; pass < 2; pass++)
+    {
+        if(pass == 1)
+            nfailed += dset_split_direct_finish(&batch);
+
+        for(u = 0; u < count; u++)
+        {
+            herr_t status;
+
+            if(direct[u] || busy[u] != (pass == 1))
+                continue;
+            if(write)
+                status = H5Dwrite(dset_ids[u], mem_type_ids[u], mem_space_ids[u], file_space_ids[u], dxpl_id, bufs[u]);
+            else
+                status = H5Dread(dset_ids[u], mem_type_ids[u], mem_space_ids[u], file_space_ids[u], dxpl_id, bufs[u]);
+            if(status < 0)
+                nfailed++;
+        }
+    }
+    if(nfailed > 0)
+        HGOTO_ERROR(H5E_VOL, write ? H5E_WRITEERROR : H5E_READERROR, -1, "%zu of %zu dataset %s failed", nfailed,
+                    count, write ? "writes" : "reads");
+
+    done:
+        /*The split files of the direct transfers may be closed now*/
+#ifdef H5_HAVE_THREADSAFE
+        if(!locked && nplanned > 0)
+        {
+            dset_split_hdf5_lock(1);
+            locked = TRUE;
+        }
+#endif
+        for(u = 0; u < nplanned; u++)
+            dset_split_pool_release(batch.jobs[u].split_file);
+#ifdef H5_HAVE_THREADSAFE
+        if(locked)
+            dset_split_hdf5_unlock();
+#endif
+        free(batch.jobs);
+        free(direct);
+        free(busy);
+        pthread_mutex_destroy(&batch.mutex);
+
+    FUNC_LEAVE_VOL
+} /* end dset_split_dataset_io_multi() */
+
+/*-------------------------------------------------------------------------
+ * Function:    H5VL__dset_split_new_obj
+ *
+ * Purpose:     Create a new dset_split object for an underlying object
+ *
+ * Return:      Success:    Pointer to the new dset_split object
+ *              Failure:    NULL
+ *
+ *-------------------------------------------------------------------------
+ */
+static H5VL_dset_split_t *
+H5VL_dset_split_new_dataset_obj(void *under_obj, hid_t under_vol_id, H5VL_dset_split_pool_entry_t *split_file)
+{
+    H5VL_dset_split_t *new_obj;
+
+    new_obj               = (H5VL_dset_split_t *)calloc(1, sizeof(H5VL_dset_split_t));
+    new_obj->under_object = under_obj;
+    new_obj->under_vol_id = under_vol_id;
+    new_obj->fid          = split_file->fid;
+    new_obj->type         = H5I_DATASET;
+    new_obj->set          = 1;
+    new_obj->split_file   = split_file;
+    H5Iinc_ref(new_obj->under_vol_id);
+    dset_split_user_bind(new_obj);
+
+    return new_obj;
+} /* end H5VL__dset_split_new_obj() */
+
+/*-------------------------------------------------------------------------
+ * Function:    H5VL__dset_split_new_obj
+ *
+ * Purpose:     Create a new dset_split object for an underlying object
+ *
+ * Return:      Success:    Pointer to the new dset_split object
+ *              Failure:    NULL
+ *
+ *-------------------------------------------------------------------------
+ */
+static H5VL_dset_split_t *
+H5VL_dset_split_new_obj(void *under_obj, hid_t under_vol_id)
+{
+    H5VL_dset_split_t *new_obj;
+
+    new_obj               = (H5VL_dset_split_t *)calloc(1, sizeof(H5VL_dset_split_t));
+    new_obj->under_object = under_obj;
+    new_obj->under_vol_id = under_vol_id;
+    H5Iinc_ref(new_obj->under_vol_id);
+
+    return new_obj;
+} /* end H5VL__dset_split_new_obj() */
+
+/*-------------------------------------------------------------------------
+ * Function:    H5VL__dset_split_free_obj
+ *
+ * Purpose:     Release a dset_split object
+ *
+ * Note:	Take care to preserve the current HDF5 error stack
+ *		when calling HDF5 API calls.
+ *
+ * Return:      Success:    0
+ *              Failure:    -1
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5VL_dset_split_free_obj(H5VL_dset_split_t *obj)
+{
+    hid_t err_id;
+
+    err_id = H5Eget_current_stack();
+
+    if (obj->lazy)
+        dset_split_lazy_free(obj);
+    if (obj->detached)
+        dset_split_detached_free(obj);
+    H5Idec_ref(obj->under_vol_id);
+    if (obj->wb)
+        dset_split_wb_free(obj);
+    if (obj->ra)
+        dset_split_ra_free(obj);
+    if (obj->map)
+        dset_split_mapped_free(obj);
+    if (obj->zip)
+        dset_split_zip_free(obj);
+    if (obj->file_ctx)
+        dset_split_file_ctx_release(obj->file_ctx);
+    if (obj->subfile)
+        dset_split_subfile_free(obj->subfile);
+    if (obj->queue)
+        dset_split_queue_release(obj->queue);
+
+    H5Eset_current_stack(err_id);
+
+    free(obj);
+
+    return 0;
+} /* end H5VL__dset_split_free_obj() */
+
+/*-------------------------------------------------------------------------
+ * Function:    H5VL_dset_split_register
+ *
+ * Purpose:     Register the dset_split VOL connector and retrieve an ID
+ *              for it.
+ *
+ * Return:      Success:    The ID for the dset_split VOL connector
+ *              Failure:    -1
+ *
+ *-------------------------------------------------------------------------
+ */
+hid_t
+H5VL_dset_split_register(void)
+{
+    /* Singleton register the dset_split VOL connector ID */
+    if (H5VL_DSET_SPLIT_g < 0)
+        H5VL_DSET_SPLIT_g = H5VLregister_connector(&H5VL_dset_split_g, H5P_DEFAULT);
+
+    return H5VL_DSET_SPLIT_g;
+} /* end H5VL_dset_split_register() */
+
+/*-------------------------------------------------------------------------
+ * Function:    H5VL_dset_split_dataset_read_multi
+ *
+ * Purpose:     Reads 'count' datasets, like as many H5Dread calls. See
+ *              dset_split_dataset_io_multi.
+ *
+ * Return:      Success:    0
+ *              Failure:    -1, if any of the reads failed
+ *
+ *-------------------------------------------------------------------------
+ */
+herr_t
+H5VL_dset_split_dataset_read_multi(size_t count, const hid_t dset_ids[], const hid_t mem_type_ids[],
+                                   const hid_t mem_space_ids[], const hid_t file_space_ids[], hid_t dxpl_id,
+                                   void *bufs[])
+{
+    return dset_split_dataset_io_multi(count, dset_ids, mem_type_ids, mem_space_ids, file_space_ids, dxpl_id,
+                                       bufs, FALSE);
+} /* end H5VL_dset_split_dataset_read_multi() */
+
+/*-------------------------------------------------------------------------
+ * Function:    H5VL_dset_split_dataset_write_multi
+ *
+ * Purpose:     Writes 'count' datasets, like as many H5Dwrite calls. See
+ *              dset_split_dataset_io_multi.
+ *
+ * Return:      Success:    0
+ *              Failure:    -1, if any of the writes failed
+ *
+ *-------------------------------------------------------------------------
+ */
+herr_t
+H5VL_dset_split_dataset_write_multi(size_t count, const hid_t dset_ids[], const hid_t mem_type_ids[],
+                                    const hid_t mem_space_ids[], const hid_t file_space_ids[], hid_t dxpl_id,
+                                    const void *bufs[])
+{
+    return dset_split_dataset_io_multi(count, dset_ids, mem_type_ids, mem_space_ids, file_space_ids, dxpl_id,
+                                       (void *const *)bufs, TRUE);
+} /* end H5VL_dset_split_dataset_write_multi() */
+
+/*-------------------------------------------------------------------------
+ * Function:    dset_split_dataset_obj
+ *
+ * Purpose:     Gets the object of a dataset opened through this connector
+ *
+ * Return:      Success:    The dataset's object
+ *              Failure:    NULL, if the dataset belongs to another connector
+ *
+ *-------------------------------------------------------------------------
+ */
+static H5VL_dset_split_t *
+dset_split_dataset_obj(hid_t dset_id)
+{
+    H5VL_class_value_t value = (H5VL_class_value_t)-1;
+    hid_t              vol_id;
+    herr_t             status;
+
+    if ((vol_id = H5VLget_connector_id(dset_id)) < 0)
+        return NULL;
+    status = H5VLget_value(vol_id, &value);
+    H5VLclose(vol_id);
+    if (status < 0 || value != (H5VL_class_value_t)H5VL_DSET_SPLIT_VALUE)
+        return NULL;
+
+    return (H5VL_dset_split_t *)H5VLobject(dset_id);
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    H5VL_dset_split_dataset_get_mapped
+ *
+ * Purpose:     Returns the bytes of a dataset mapped into memory with the
+ *              'mmap_read' option, stored as the dataset type. They stay
+ *              valid until the dataset is closed.
+ *
+ * Return:      Success:    0
+ *              Failure:    -1, if the dataset is not mapped
+ *
+ *-------------------------------------------------------------------------
+ */
+herr_t
+H5VL_dset_split_dataset_get_mapped(hid_t dset_id, const void **ptr, size_t *nbytes)
+{
+    FUNC_ENTER_VOL(herr_t, 0)
+    H5VL_dset_split_t *o;
+    H5VL_dset_split_mapped_t *map;
+
+    if(!ptr || !nbytes)
+        HGOTO_ERROR(H5E_ARGS, H5E_BADVALUE, -1, "Invalid pointer");
+    if(NULL == (o = dset_split_dataset_obj(dset_id)))
+        HGOTO_ERROR(H5E_VOL, H5E_BADTYPE, -1, "Not a dataset of the dset-split connector");
+
+    dset_split_async_sync(o);
+    if(o->lazy)
+        HGOTO_ERROR(H5E_VOL, H5E_UNSUPPORTED, -1, "Dataset was never written");
+    if(dset_split_rebind(o) < 0)
+        HGOTO_ERROR(H5E_VOL, H5E_CANTOPENOBJ, -1, "Can't reopen the dataset");
+    if(NULL == (map = dset_split_mapped_get(o)) || !map->data)
+        HGOTO_ERROR(H5E_VOL, H5E_UNSUPPORTED, -1, "Dataset can't be mapped");
+    *ptr = map->data;
+    *nbytes = map->nbytes;
+
+    done:
+    FUNC_LEAVE_VOL
+} /* end H5VL_dset_split_dataset_get_mapped() */
+
+/*-------------------------------------------------------------------------
+ * Function:    H5VL_dset_split_dataset_write_chunks
+ *
+ * Purpose:     Writes 'count' chunks of a dataset as they are, already
+ *              filtered, like as many H5Dwrite_chunk calls. The chunks go
+ *              straight to the connector below, once the buffered writes
+ *              of the dataset are written.
+ *
+ * Return:      Success:    0
+ *              Failure:    -1, the chunks before the failed one are
+ *                          written
+ *
+ *-------------------------------------------------------------------------
+ */
+herr_t
+H5VL_dset_split_dataset_write_chunks(hid_t dset_id, hid_t dxpl_id, size_t count,
+                                     const H5VL_dset_split_chunk_t chunks[])
+{
+    FUNC_ENTER_VOL(herr_t, 0)
+    H5VL_dset_split_t *o;
+    H5VL_optional_args_t opt_args;
+    H5VL_native_dataset_optional_args_t dset_opt_args;
+    hsize_t local_offset[H5S_MAX_RANK];
+    size_t u;
+
+    if(count > 0 && !chunks)
+        HGOTO_ERROR(H5E_ARGS, H5E_BADVALUE, -1, "Invalid pointer");
+    if(NULL == (o = dset_split_dataset_obj(dset_id)))
+        HGOTO_ERROR(H5E_VOL, H5E_BADTYPE, -1, "Not a dataset of the dset-split connector");
+    if(dxpl_id == H5P_DEFAULT)
+        dxpl_id = H5P_DATASET_XFER_DEFAULT;
+
+    dset_split_async_sync(o);
+    if(dset_split_lazy_create(o, TRUE) < 0)
+        HGOTO_ERROR(H5E_VOL, H5E_CANTCREATE, -1, "Can't create the dataset");
+    if(dset_split_rebind(o) < 0)
+        HGOTO_ERROR(H5E_VOL, H5E_CANTOPENOBJ, -1, "Can't reopen the dataset");
+    if(dset_split_wb_flush(o) < 0)
+        HGOTO_ERROR(H5E_VOL, H5E_WRITEERROR, -1, "Can't write the buffered writes");
+    dset_split_ra_invalidate(o);
+
+    opt_args.op_type = H5VL_NATIVE_DATASET_CHUNK_WRITE;
+    opt_args.args = &dset_opt_args;
+    for(u = 0; u < count; u++)
+    {
+        if(!chunks[u].offset || (!chunks[u].buf && chunks[u].size > 0) || chunks[u].size > UINT32_MAX)
+            HGOTO_ERROR(H5E_ARGS, H5E_BADVALUE, -1, "Invalid chunk %zu", u);
+        dset_opt_args.chunk_write.offset = chunks[u].offset;
+        if(o->subfile)
+        {
+            if(dset_split_subfile_chunk(o->subfile, chunks[u].offset, local_offset) < 0)
+                HGOTO_ERROR(H5E_ARGS, H5E_BADRANGE, -1, "Chunk %zu is outside the rank's block", u);
+            dset_opt_args.chunk_write.offset = local_offset;
+        }
+        dset_opt_args.chunk_write.filters = chunks[u].filters;
+        dset_opt_args.chunk_write.size = (uint32_t)chunks[u].size;
+        dset_opt_args.chunk_write.buf = chunks[u].buf;
+        if(H5VLdataset_optional(o->under_object, o->under_vol_id, &opt_args, dxpl_id, NULL) < 0)
+            HGOTO_ERROR(H5E_VOL, H5E_WRITEERROR, -1, "Can't write chunk %zu of %zu", u, count);
+    }
+
+    done:
+    FUNC_LEAVE_VOL
+} /* end H5VL_dset_split_dataset_write_chunks() */
+
+/*-------------------------------------------------------------------------
+ * Function:    H5VL_dset_split_init
+ *
+ * Purpose:     Initialize this VOL connector, performing any necessary
+ *              operations for the connector that will apply to all containers
+ *              accessed with the connector.
+ *
+ * Return:      Success:    0
+ *              Failure:    -1
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5VL_dset_split_init(hid_t vipl_id)
+{
+#ifdef DEBUG
+    printf("DSET-SPLIT VOL INIT\n");
+#endif
+
+    /* Shut compiler up about unused parameter */
+    (void)vipl_id;
+
+    /* Split files are pre-created in the background only if HDF5 can be called from another thread */
+    if (H5is_library_threadsafe(&H5VL_dset_split_precreate_g.threaded) < 0)
+        H5VL_dset_split_precreate_g.threaded = FALSE;
+    H5VL_dset_split_precreate_g.shutdown = FALSE;
+
+    return 0;
+} /* end H5VL_dset_split_init() */
+
+/*---------------------------------------------------------------------------
+ * Function:    H5VL_dset_split_term
+ *
+ * Purpose:     Terminate this VOL connector, performing any necessary
+ *              operations for the connector that release connector-wide
+ *              resources (usually created / initialized with the 'init'
+ *              callback).
+ *
+ * Return:      Success:    0
+ *              Failure:    (Can't fail)
+ *
+ *---------------------------------------------------------------------------
+ */
+static herr_t
+H5VL_dset_split_term(void)
+{
+#ifdef DEBUG
+    printf("DSET-SPLIT VOL TERM\n");
+#endif
+
+    /* Complete the asynchronous operations */
+    dset_split_async_stop();
+
+    /* Stop pre-creating split files, waiting for the worker, and delete the unused ones */
+    dset_split_reserve_stop();
+
+    /* Close whatever the split file pool still holds */
+    H5E_BEGIN_TRY {
+        dset_split_reserve_drain(NULL);
+        dset_split_pool_evict(0);
+    } H5E_END_TRY;
+    if (H5VL_dset_split_pool_g.nentries == 0 && H5VL_dset_split_pool_g.buckets) {
+        free(H5VL_dset_split_pool_g.buckets);
+        H5VL_dset_split_pool_g.buckets  = NULL;
+        H5VL_dset_split_pool_g.nbuckets = 0;
+    }
+
+    /* Reset VOL ID */
+    H5VL_DSET_SPLIT_g = H5I_INVALID_HID;
+
+    return 0;
+} /* end H5VL_dset_split_term() */
+
+/*---------------------------------------------------------------------------
+ * Function:    H5VL_dset_split_info_copy
+ *
+ * Purpose:     Duplicate the connector's info object.
+ *
+ * Returns:     Success:    New connector info object
+ *              Failure:    NULL
+ *
+ *---------------------------------------------------------------------------
+ */
+static void *
+H5VL_dset_split_info_copy(const void *_info)
+{
+    const H5VL_dset_split_info_t *info = (const H5VL_dset_split_info_t *)_info;
+    H5VL_dset_split_info_t *      new_info;
+
+#ifdef DEBUG
+    printf("DSET-SPLIT VOL INFO Copy\n");
+#endif
+
+    /* Allocate new VOL info struct for the dset_split connector */
+    new_info = (H5VL_dset_split_info_t *)calloc(1, sizeof(H5VL_dset_split_info_t));
+
+    /* Copy the connector options */
+    memcpy(new_info, info, sizeof(H5VL_dset_split_info_t));
+    new_info->under_vol_info = NULL;
+    if (info->split_policy)
+        new_info->split_policy = strdup(info->split_policy);
+
+    /* Increment reference count on underlying VOL ID, and copy the VOL info */
+    new_info->under_vol_id = info->under_vol_id;
+    H5Iinc_ref(new_info->under_vol_id);
+    if (info->under_vol_info)
+        H5VLcopy_connector_info(new_info->under_vol_id, &(new_info->under_vol_info), info->under_vol_info);
+
+    return new_info;
+} /* end H5VL_dset_split_info_copy() */
+
+/*---------------------------------------------------------------------------
+ * Function:    H5VL_dset_split_info_cmp
+ *
+ * Purpose:     Compare two of the connector's info objects, setting *cmp_value,
+ *              following the same rules as strcmp().
+ *
+ * Return:      Success:    0
+ *              Failure:    -1
+ *
+ *---------------------------------------------------------------------------
+ */
+static herr_t
+H5VL_dset_split_info_cmp(int *cmp_value, const void *_info1, const void *_info2)
+{
+    const H5VL_dset_split_info_t *info1 = (const H5VL_dset_split_info_t *)_info1;
+    const H5VL_dset_split_info_t *info2 = (const H5VL_dset_split_info_t *)_info2;
+
+#ifdef DEBUG 
+    printf("DSET-SPLIT VOL INFO Compare\n");
+#endif
+
+    /* Sanity checks */
+    assert(info1);
+    assert(info2);
+
+    /* Initialize comparison value */
+    *cmp_value = 0;
+
+    /* Compare under VOL connector classes */
+    H5VLcmp_connector_cls(cmp_value, info1->under_vol_id, info2->under_vol_id);
+    if (*cmp_value != 0)
+        return 0;
+
+    /* Compare under VOL connector info objects */
+    H5VLcmp_connector_info(cmp_value, info1->under_vol_id, info1->under_vol_info, info2->under_vol_info);
+    if (*cmp_value != 0)
+        return 0;
+
+    /* Compare connector options */
+    *cmp_value = (info1->pool_size > info2->pool_size) - (info1->pool_size < info2->pool_size);
+    if (*cmp_value != 0)
+        return 0;
+    *cmp_value = (info1->precreate > info2->precreate) - (info1->precreate < info2->precreate);
+    if (*cmp_value != 0)
+        return 0;
+    *cmp_value = (info1->split_threshold > info2->split_threshold) -
+                 (info1->split_threshold < info2->split_threshold);
+    if (*cmp_value != 0)
+        return 0;
+    *cmp_value = (int)info1->split_mode - (int)info2->split_mode;
+    if (*cmp_value != 0)
+        return 0;
+    *cmp_value = (info1->aggregators > info2->aggregators) - (info1->aggregators < info2->aggregators);
+    if (*cmp_value != 0)
+        return 0;
+    *cmp_value = (info1->subfiling > info2->subfiling) - (info1->subfiling < info2->subfiling);
+    if (*cmp_value != 0)
+        return 0;
+    *cmp_value = (info1->async_threads > info2->async_threads) - (info1->async_threads < info2->async_threads);
+    if (*cmp_value != 0)
+        return 0;
+    *cmp_value = (info1->direct_io > info2->direct_io) - (info1->direct_io < info2->direct_io);
+    if (*cmp_value != 0)
+        return 0;
+    *cmp_value = (info1->write_behind > info2->write_behind) - (info1->write_behind < info2->write_behind);
+    if (*cmp_value != 0)
+        return 0;
+    *cmp_value = (info1->write_behind_budget > info2->write_behind_budget) -
+                 (info1->write_behind_budget < info2->write_behind_budget);
+    if (*cmp_value != 0)
+        return 0;
+    *cmp_value = (info1->read_ahead > info2->read_ahead) - (info1->read_ahead < info2->read_ahead);
+    if (*cmp_value != 0)
+        return 0;
+    *cmp_value = (info1->mmap_read > info2->mmap_read) - (info1->mmap_read < info2->mmap_read);
+    if (*cmp_value != 0)
+        return 0;
+    *cmp_value = (info1->compress_threads > info2->compress_threads) -
+                 (info1->compress_threads < info2->compress_threads);
+    if (*cmp_value != 0)
+        return 0;
+    *cmp_value = (info1->lazy_create > info2->lazy_create) - (info1->lazy_create < info2->lazy_create);
+    if (*cmp_value != 0)
+        return 0;
+    *cmp_value = (info1->batch_links > info2->batch_links) - (info1->batch_links < info2->batch_links);
+    if (*cmp_value != 0)
+        return 0;
+    *cmp_value = (info1->eager_folder > info2->eager_folder) - (info1->eager_folder < info2->eager_folder);
+    if (*cmp_value != 0)
+        return 0;
+    *cmp_value = (info1->shard_levels > info2->shard_levels) - (info1->shard_levels < info2->shard_levels);
     if (*cmp_value != 0)
         return 0;
-
-    /* Compare under VOL connector info objects */
-    H5VLcmp_connector_info(cmp_value, info1->under_vol_id, info1->under_vol_info, info2->under_vol_info);
+    *cmp_value = (info1->mirror_groups > info2->mirror_groups) - (info1->mirror_groups < info2->mirror_groups);
+    if (*cmp_value != 0)
+        return 0;
+    *cmp_value = (info1->max_open_files > info2->max_open_files) - (info1->max_open_files < info2->max_open_files);
+    if (*cmp_value != 0)
+        return 0;
+    *cmp_value = (info1->mem_budget > info2->mem_budget) - (info1->mem_budget < info2->mem_budget);
+    if (*cmp_value != 0)
+        return 0;
+    *cmp_value = (info1->split_alignment > info2->split_alignment) -
+                 (info1->split_alignment < info2->split_alignment);
+    if (*cmp_value != 0)
+        return 0;
+    *cmp_value = (info1->split_align_threshold > info2->split_align_threshold) -
+                 (info1->split_align_threshold < info2->split_align_threshold);
+    if (*cmp_value != 0)
+        return 0;
+    *cmp_value = (info1->split_meta_block_size > info2->split_meta_block_size) -
+                 (info1->split_meta_block_size < info2->split_meta_block_size);
+    if (*cmp_value != 0)
+        return 0;
+    *cmp_value = (info1->split_sieve_buf_size > info2->split_sieve_buf_size) -
+                 (info1->split_sieve_buf_size < info2->split_sieve_buf_size);
+    if (*cmp_value != 0)
+        return 0;
+    *cmp_value = (info1->split_page_size > info2->split_page_size) -
+                 (info1->split_page_size < info2->split_page_size);
+    if (*cmp_value != 0)
+        return 0;
+    *cmp_value = (info1->split_libver_latest > info2->split_libver_latest) -
+                 (info1->split_libver_latest < info2->split_libver_latest);
+    if (*cmp_value != 0)
+        return 0;
+    *cmp_value = (int)info1->split_driver - (int)info2->split_driver;
+    if (*cmp_value != 0)
+        return 0;
+    *cmp_value = strcmp(info1->split_policy ? info1->split_policy : "", info2->split_policy ? info2->split_policy : "");
     if (*cmp_value != 0)
         return 0;
 
@@ -895,6 +8765,7 @@ H5VL_dset_split_info_free(void *_info)
     H5Eset_current_stack(err_id);
 
     /* Free dset_split info object itself */
+    free(info->split_policy);
     free(info);
 
     return 0;
@@ -931,7 +8802,8 @@ H5VL_dset_split_info_to_str(const void *_info, char **str)
         under_vol_str_len = strlen(under_vol_string);
 
     /* Allocate space for our info */
-    *str = (char *)H5allocate_memory(32 + under_vol_str_len, (hbool_t)0);
+    *str = (char *)H5allocate_memory(2048 + under_vol_str_len + (info->split_policy ? strlen(info->split_policy) + 9 : 0),
+                                     (hbool_t)0);
     assert(*str);
 
     /* Encode our info
@@ -939,12 +8811,220 @@ H5VL_dset_split_info_to_str(const void *_info, char **str)
      * call had problems on Windows until recently. So, to be as platform-independent
      * as we can, we're using sprintf() instead.
      */
-    sprintf(*str, "under_vol=%u;under_info={%s}", (unsigned)under_value,
-            (under_vol_string ? under_vol_string : ""));
+    sprintf(*str, "under_vol=%u;under_info={%s};pool_size=%u;precreate=%u;split_threshold=%llu;split_mode=%s;"
+            "aggregators=%u;subfiling=%u;async_threads=%u;direct_io=%u",
+            (unsigned)under_value, (under_vol_string ? under_vol_string : ""), info->pool_size, info->precreate,
+            (unsigned long long)info->split_threshold, dset_split_mode_to_str(info->split_mode), info->aggregators,
+            info->subfiling, info->async_threads, info->direct_io);
+    sprintf(*str + strlen(*str), ";split_alignment=%llu;split_align_threshold=%llu;split_meta_block_size=%llu;"
+            "split_sieve_buf_size=%llu;split_page_size=%llu;split_libver_latest=%u;split_driver=%s",
+            (unsigned long long)info->split_alignment, (unsigned long long)info->split_align_threshold,
+            (unsigned long long)info->split_meta_block_size, (unsigned long long)info->split_sieve_buf_size,
+            (unsigned long long)info->split_page_size, info->split_libver_latest,
+            dset_split_driver_to_str(info->split_driver));
+    sprintf(*str + strlen(*str),
+            ";write_behind=%llu;write_behind_budget=%llu;read_ahead=%u;mmap_read=%u;compress_threads=%u;"
+            "lazy_create=%u;batch_links=%u;eager_folder=%u;shard_levels=%u;mirror_groups=%u;"
+            "max_open_files=%u;mem_budget=%llu",
+            (unsigned long long)info->write_behind, (unsigned long long)info->write_behind_budget,
+            info->read_ahead, info->mmap_read, info->compress_threads, info->lazy_create,
+            info->batch_links, info->eager_folder, info->shard_levels, info->mirror_groups,
+            info->max_open_files, (unsigned long long)info->mem_budget);
+    if (info->split_policy)
+        sprintf(*str + strlen(*str), ";split={%s}", info->split_policy);
 
     return 0;
 } /* end H5VL_dset_split_info_to_str() */
 
+/*---------------------------------------------------------------------------
+ * Function:    dset_split_find_closing_brace
+ *
+ * Purpose:     Finds the '}' matching the '{' at 'start'
+ *
+ * Return:      Success:    Pointer to the matching '}'
+ *              Failure:    NULL
+ *
+ *---------------------------------------------------------------------------
+ */
+static const char *
+dset_split_find_closing_brace(const char *start)
+{
+    int depth = 0;
+
+    for (; *start; start++) {
+        if (*start == '{')
+            depth++;
+        else if (*start == '}' && --depth == 0)
+            return start;
+    }
+    return NULL;
+}
+
+/*---------------------------------------------------------------------------
+ * Function:    dset_split_str_to_size
+ *
+ * Purpose:     Parses a size in bytes, with an optional K, M or G suffix
+ *
+ * Return:      Size in bytes
+ *
+ *---------------------------------------------------------------------------
+ */
+static hsize_t
+dset_split_str_to_size(const char *str)
+{
+    char *  suffix;
+    hsize_t size = (hsize_t)strtoull(str, &suffix, 10);
+
+    switch (*suffix) {
+        case 'g':
+        case 'G':
+            size *= 1024;
+            /* FALLTHROUGH */
+        case 'm':
+        case 'M':
+            size *= 1024;
+            /* FALLTHROUGH */
+        case 'k':
+        case 'K':
+            size *= 1024;
+            break;
+        default:
+            break;
+    }
+
+    return size;
+} /* end dset_split_str_to_size() */
+
+/*---------------------------------------------------------------------------
+ * Function:    dset_split_str_to_opts
+ *
+ * Purpose:     Parses the connector options following the under VOL info,
+ *              ';' separated "key=value" pairs, into the info object.
+ *              Unknown keys are ignored. The split policy table is only
+ *              checked for syntax here, it is compiled per file.
+ *
+ * Return:      Success:    0
+ *              Failure:    -1
+ *
+ *---------------------------------------------------------------------------
+ */
+static herr_t
+dset_split_str_to_opts(const char *str, H5VL_dset_split_info_t *info)
+{
+    while (str && *str) {
+        const char *end;
+        const char *value;
+        size_t      key_len;
+
+        while (*str == ';' || *str == ' ')
+            str++;
+        if (!*str)
+            break;
+
+        if (NULL == (value = strchr(str, '=')))
+            return -1;
+        key_len = (size_t)(value - str);
+        value++;
+
+        /* Values may be enclosed in braces, to allow ';' inside them */
+        if (*value == '{') {
+            if (NULL == (end = dset_split_find_closing_brace(value)))
+                return -1;
+            end++;
+        }
+        else if (NULL == (end = strchr(value, ';')))
+            end = value + strlen(value);
+
+        /* Without braces, the policy table runs on over the following entries that are not options */
+        if (*value != '{' && key_len == strlen("split") && !strncmp(str, "split", key_len)) {
+            while (*end == ';') {
+                const char *next = end + 1 + strcspn(end + 1, ";");
+
+                if (memchr(end + 1, '=', (size_t)(next - end - 1)))
+                    break;
+                end = next;
+            }
+        }
+
+        if (key_len == strlen("pool_size") && !strncmp(str, "pool_size", key_len))
+            info->pool_size = (unsigned)strtoul(value, NULL, 10);
+        else if (key_len == strlen("precreate") && !strncmp(str, "precreate", key_len))
+            info->precreate = (unsigned)strtoul(value, NULL, 10);
+        else if (key_len == strlen("split_threshold") && !strncmp(str, "split_threshold", key_len))
+            info->split_threshold = dset_split_str_to_size(value);
+        else if (key_len == strlen("aggregators") && !strncmp(str, "aggregators", key_len))
+            info->aggregators = (unsigned)strtoul(value, NULL, 10);
+        else if (key_len == strlen("subfiling") && !strncmp(str, "subfiling", key_len))
+            info->subfiling = (unsigned)strtoul(value, NULL, 10);
+        else if (key_len == strlen("async_threads") && !strncmp(str, "async_threads", key_len))
+            info->async_threads = (unsigned)strtoul(value, NULL, 10);
+        else if (key_len == strlen("direct_io") && !strncmp(str, "direct_io", key_len))
+            info->direct_io = (unsigned)strtoul(value, NULL, 10);
+        else if (key_len == strlen("write_behind") && !strncmp(str, "write_behind", key_len))
+            info->write_behind = dset_split_str_to_size(value);
+        else if (key_len == strlen("write_behind_budget") && !strncmp(str, "write_behind_budget", key_len))
+            info->write_behind_budget = dset_split_str_to_size(value);
+        else if (key_len == strlen("read_ahead") && !strncmp(str, "read_ahead", key_len))
+            info->read_ahead = (unsigned)strtoul(value, NULL, 10);
+        else if (key_len == strlen("mmap_read") && !strncmp(str, "mmap_read", key_len))
+            info->mmap_read = (unsigned)strtoul(value, NULL, 10);
+        else if (key_len == strlen("compress_threads") && !strncmp(str, "compress_threads", key_len))
+            info->compress_threads = (unsigned)strtoul(value, NULL, 10);
+        else if (key_len == strlen("lazy_create") && !strncmp(str, "lazy_create", key_len))
+            info->lazy_create = (unsigned)strtoul(value, NULL, 10);
+        else if (key_len == strlen("batch_links") && !strncmp(str, "batch_links", key_len))
+            info->batch_links = (unsigned)strtoul(value, NULL, 10);
+        else if (key_len == strlen("eager_folder") && !strncmp(str, "eager_folder", key_len))
+            info->eager_folder = (unsigned)strtoul(value, NULL, 10);
+        else if (key_len == strlen("shard_levels") && !strncmp(str, "shard_levels", key_len))
+            info->shard_levels = (unsigned)strtoul(value, NULL, 10);
+        else if (key_len == strlen("mirror_groups") && !strncmp(str, "mirror_groups", key_len))
+            info->mirror_groups = (unsigned)strtoul(value, NULL, 10);
+        else if (key_len == strlen("max_open_files") && !strncmp(str, "max_open_files", key_len))
+            info->max_open_files = (unsigned)strtoul(value, NULL, 10);
+        else if (key_len == strlen("mem_budget") && !strncmp(str, "mem_budget", key_len))
+            info->mem_budget = dset_split_str_to_size(value);
+        else if (key_len == strlen("split_alignment") && !strncmp(str, "split_alignment", key_len))
+            info->split_alignment = dset_split_str_to_size(value);
+        else if (key_len == strlen("split_align_threshold") && !strncmp(str, "split_align_threshold", key_len))
+            info->split_align_threshold = dset_split_str_to_size(value);
+        else if (key_len == strlen("split_meta_block_size") && !strncmp(str, "split_meta_block_size", key_len))
+            info->split_meta_block_size = dset_split_str_to_size(value);
+        else if (key_len == strlen("split_sieve_buf_size") && !strncmp(str, "split_sieve_buf_size", key_len))
+            info->split_sieve_buf_size = dset_split_str_to_size(value);
+        else if (key_len == strlen("split_page_size") && !strncmp(str, "split_page_size", key_len))
+            info->split_page_size = dset_split_str_to_size(value);
+        else if (key_len == strlen("split_libver_latest") && !strncmp(str, "split_libver_latest", key_len))
+            info->split_libver_latest = (unsigned)strtoul(value, NULL, 10);
+        else if (key_len == strlen("split_driver") && !strncmp(str, "split_driver", key_len)) {
+            if (dset_split_str_to_driver(value, (size_t)(end - value), &info->split_driver) < 0)
+                return -1;
+        }
+        else if (key_len == strlen("split_mode") && !strncmp(str, "split_mode", key_len)) {
+            if (dset_split_str_to_mode(value, (size_t)(end - value), &info->split_mode) < 0)
+                return -1;
+        }
+        else if (key_len == strlen("split") && !strncmp(str, "split", key_len)) {
+            const char *start = value;
+            size_t      len   = (size_t)(end - value);
+
+            if (*value == '{') {
+                start++;
+                len -= 2;
+            }
+            free(info->split_policy);
+            if (NULL == (info->split_policy = (char *)malloc(len + 1)))
+                return -1;
+            memcpy(info->split_policy, start, len);
+            info->split_policy[len] = '\0';
+        }
+
+        str = end;
+    }
+
+    return 0;
+} /* end dset_split_str_to_opts() */
+
 /*---------------------------------------------------------------------------
  * Function:    H5VL_dset_split_str_to_info
  *
@@ -972,7 +9052,7 @@ H5VL_dset_split_str_to_info(const char *str, void **_info)
     sscanf(str, "under_vol=%u;", &under_vol_value);
     under_vol_id         = H5VLregister_connector_by_value((H5VL_class_value_t)under_vol_value, H5P_DEFAULT);
     under_vol_info_start = strchr(str, '{');
-    under_vol_info_end   = strrchr(str, '}');
+    under_vol_info_end   = under_vol_info_start ? dset_split_find_closing_brace(under_vol_info_start) : NULL;
     assert(under_vol_info_end > under_vol_info_start);
     if (under_vol_info_end != (under_vol_info_start + 1)) {
         char *under_vol_info_str;
@@ -992,6 +9072,22 @@ H5VL_dset_split_str_to_info(const char *str, void **_info)
     info->under_vol_id   = under_vol_id;
     info->under_vol_info = under_vol_info;
 
+    /* Retrieve the connector options */
+    info->pool_size = H5VL_DSET_SPLIT_POOL_SIZE_DEFAULT;
+    if (dset_split_str_to_opts(under_vol_info_end + 1, info) < 0) {
+        H5VL_dset_split_info_free(info);
+        return -1;
+    }
+    if (info->split_policy) {
+        H5VL_dset_split_policy_t *policy;
+
+        if (NULL == (policy = dset_split_policy_compile(info->split_policy))) {
+            H5VL_dset_split_info_free(info);
+            return -1;
+        }
+        dset_split_policy_free(policy);
+    }
+
     /* Set return value */
     *_info = info;
    
@@ -1017,6 +9113,10 @@ H5VL_dset_split_get_object(const void *obj)
     printf("DSET-SPLIT VOL Get object\n");
 #endif
 
+    dset_split_async_sync((H5VL_dset_split_t *)o);
+    if (dset_split_lazy_create((H5VL_dset_split_t *)o, TRUE) < 0 || dset_split_rebind((H5VL_dset_split_t *)o) < 0)
+        return NULL;
+
     return H5VLget_object(o->under_object, o->under_vol_id);
 } /* end H5VL_dset_split_get_object() */
 
@@ -1040,13 +9140,19 @@ H5VL_dset_split_get_wrap_ctx(const void *obj, void **wrap_ctx)
     printf("DSET-SPLIT VOL WRAP CTX Get\n");
 #endif
 
+    dset_split_async_sync((H5VL_dset_split_t *)o);
+
     /* Allocate new VOL object wrapping context for the dset_split connector */
     new_wrap_ctx = (H5VL_dset_split_wrap_ctx_t *)calloc(1, sizeof(H5VL_dset_split_wrap_ctx_t));
 
     /* Increment reference count on underlying VOL ID, and copy the VOL info */
     new_wrap_ctx->under_vol_id = o->under_vol_id;
     H5Iinc_ref(new_wrap_ctx->under_vol_id);
-    H5VLget_wrap_ctx(o->under_object, o->under_vol_id, &new_wrap_ctx->under_wrap_ctx);
+    /* Objects created from a dataset not created yet belong to its group */
+    H5VLget_wrap_ctx(o->lazy ? o->lazy->loc_under : o->under_object, o->under_vol_id,
+                     &new_wrap_ctx->under_wrap_ctx);
+    if (NULL != (new_wrap_ctx->file_ctx = o->file_ctx))
+        new_wrap_ctx->file_ctx->nrefs++;
 
     /* Set wrap context to return */
     *wrap_ctx = new_wrap_ctx;
@@ -1077,8 +9183,11 @@ H5VL_dset_split_wrap_object(void *obj, H5I_type_t obj_type, void *_wrap_ctx)
     /* Wrap the object with the underlying VOL */
     under = H5VLwrap_object(obj, obj_type, wrap_ctx->under_vol_id, wrap_ctx->under_wrap_ctx);
 
-    if (under)
+    if (under) {
         new_obj = H5VL_dset_split_new_obj(under, wrap_ctx->under_vol_id);
+        if (NULL != (new_obj->file_ctx = wrap_ctx->file_ctx))
+            new_obj->file_ctx->nrefs++;
+    }
     else
         new_obj = NULL;
 
@@ -1144,6 +9253,8 @@ H5VL_dset_split_free_wrap_ctx(void *_wrap_ctx)
     if (wrap_ctx->under_wrap_ctx)
         H5VLfree_wrap_ctx(wrap_ctx->under_wrap_ctx, wrap_ctx->under_vol_id);
     H5Idec_ref(wrap_ctx->under_vol_id);
+    if (wrap_ctx->file_ctx)
+        dset_split_file_ctx_release(wrap_ctx->file_ctx);
 
     H5Eset_current_stack(err_id);
 
@@ -1175,6 +9286,15 @@ H5VL_dset_split_attr_create(void *obj, const H5VL_loc_params_t *loc_params, cons
     printf("DSET-SPLIT VOL ATTRIBUTE Create\n");
 #endif
 
+    dset_split_async_sync(o);
+#ifdef H5_HAVE_PARALLEL
+    /* Creating an attribute is collective: a dataset of rank-local split files not written yet goes to a shared split file */
+    if (o->subfile && o->subfile->pending && dset_split_subfile_layout(o, H5I_INVALID_HID, dxpl_id) < 0)
+        return NULL;
+#endif
+    if (dset_split_lazy_create(o, TRUE) < 0 || dset_split_rebind(o) < 0)
+        return NULL;
+
     under = H5VLattr_create(o->under_object, loc_params, o->under_vol_id, name, type_id, space_id, acpl_id,
                             aapl_id, dxpl_id, req);
     if (under) {
@@ -1212,6 +9332,10 @@ H5VL_dset_split_attr_open(void *obj, const H5VL_loc_params_t *loc_params, const
     printf("DSET-SPLIT VOL ATTRIBUTE Open\n");
 #endif
 
+    dset_split_async_sync(o);
+    if (dset_split_lazy_create(o, TRUE) < 0 || dset_split_rebind(o) < 0)
+        return NULL;
+
     under = H5VLattr_open(o->under_object, loc_params, o->under_vol_id, name, aapl_id, dxpl_id, req);
     if (under) {
         attr = H5VL_dset_split_new_obj(under, o->under_vol_id);
@@ -1304,6 +9428,10 @@ H5VL_dset_split_attr_get(void *obj, H5VL_attr_get_args_t *args, hid_t dxpl_id, v
     printf("DSET-SPLIT VOL ATTRIBUTE Get\n");
 #endif
 
+    dset_split_async_sync(o);
+    if (dset_split_lazy_create(o, TRUE) < 0 || dset_split_rebind(o) < 0)
+        return -1;
+
     ret_value = H5VLattr_get(o->under_object, o->under_vol_id, args, dxpl_id, req);
 
     /* Check for async request */
@@ -1334,6 +9462,10 @@ H5VL_dset_split_attr_specific(void *obj, const H5VL_loc_params_t *loc_params,
     printf("DSET-SPLIT VOL ATTRIBUTE Specific\n");
 #endif
 
+    dset_split_async_sync(o);
+    if (dset_split_lazy_create(o, TRUE) < 0 || dset_split_rebind(o) < 0)
+        return -1;
+
     ret_value = H5VLattr_specific(o->under_object, loc_params, o->under_vol_id, args, dxpl_id, req);
     /* Check for async request */
     if (req && *req)
@@ -1362,6 +9494,10 @@ H5VL_dset_split_attr_optional(void *obj, H5VL_optional_args_t *args, hid_t dxpl_
     printf("DSET-SPLIT VOL ATTRIBUTE Optional\n");
 #endif
 
+    dset_split_async_sync(o);
+    if (dset_split_lazy_create(o, TRUE) < 0 || dset_split_rebind(o) < 0)
+        return -1;
+
     ret_value = H5VLattr_optional(o->under_object, o->under_vol_id, args, dxpl_id, req);
     /* Check for async request */
     if (req && *req)
@@ -1406,7 +9542,9 @@ H5VL_dset_split_attr_close(void *attr, hid_t dxpl_id, void **req)
 /*-------------------------------------------------------------------------
  * Function:    dset_get_normalized_name
  *
- * Purpose:     Removes ".h5"  from the parent name
+ * Purpose:     Removes the ".h5" extension from the parent name. Other
+ *              names are kept whole, so "run.h5.bak" does not share the
+ *              split folder of "run.h5".
  *
  * Return:      Success:    Removes ".h5" from the parent file name
  *        
@@ -1416,10 +9554,11 @@ H5VL_dset_split_attr_close(void *attr, hid_t dxpl_id, void **req)
 void
 dset_get_normalized_name (char* name)
 {
-    char* temp = strstr(name, ".h5");
-    if(temp)
+    size_t len = strlen(name);
+
+    if(len > 3 && !strcmp(name + len - 3, ".h5") && name[len - 4] != '/')
     {
-        *temp = '\0';
+        name[len - 3] = '\0';
     }
 }
 
@@ -1462,9 +9601,13 @@ dset_create_split_folder (char* name)
 }
 
 /*-------------------------------------------------------------------------
- * Function:    H5VL_dset_split_dataset_create
+ * Function:    dset_split_dataset_create
  *
- * Purpose:     Creates a dataset in a container
+ * Purpose:     Creates a dataset in a container. 'flags' tell what may be
+ *              put off: H5VL_DSET_SPLIT_CREATE_LAZY defers the creation of
+ *              a split dataset to its first write, and
+ *              H5VL_DSET_SPLIT_CREATE_QUEUE queues its external link. Only
+ *              the application's thread may put work off.
  *
  * Return:      Success:    Pointer to a dataset object
  *              Failure:    NULL
@@ -1472,50 +9615,50 @@ dset_create_split_folder (char* name)
  *-------------------------------------------------------------------------
  */
 static void *
-H5VL_dset_split_dataset_create(void *obj, const H5VL_loc_params_t *loc_params, const char *name,
-                                 hid_t lcpl_id, hid_t type_id, hid_t space_id, hid_t dcpl_id, hid_t dapl_id,
-                                 hid_t dxpl_id, void **req)
+dset_split_dataset_create(void *obj, const H5VL_loc_params_t *loc_params, const char *name, hid_t lcpl_id,
+                          hid_t type_id, hid_t space_id, hid_t dcpl_id, hid_t dapl_id, hid_t dxpl_id, void **req,
+                          unsigned flags)
 {
     FUNC_ENTER_VOL(void*, NULL)
     H5VL_dset_split_t *dset;
     H5VL_dset_split_t *o = (H5VL_dset_split_t *)obj;
+    H5VL_dset_split_pool_entry_t *split_file = NULL;
+    H5VL_dset_split_file_ctx_t *file_ctx;
+    H5VL_dset_split_mode_t placement;
+    H5VL_dset_split_subfile_t *subfile = NULL;
+    hid_t direct_dcpl_id = H5I_INVALID_HID;
+    hid_t gov_dapl_id = H5I_INVALID_HID;
+    char* group_path = NULL;
+    char* dset_path = NULL;
     void *file_under;
     void *under;
-    void *dset_under;
+    void *dset_under = NULL;
     char* dsetname = NULL;;
     hid_t file_id;
     char file_name[1000] = {'\0'};
-    char* split_folder_name = NULL;
     herr_t status;
     char* temp_path = NULL;
-    char* parent_name = NULL;
     H5VL_loc_params_t file_loc_params;
+    hbool_t queued = FALSE;
     herr_t ret;
-    size_t size;
 
 #ifdef DEBUG
     printf("DSET-SPLIT VOL DATASET Create\n");
 #endif
 
-    /*Get the parent Name*/
-    size = get_file_name(o->under_object, o->under_vol_id, loc_params->obj_type, NULL,  0);
-    if(size > 0)
-    {
-        parent_name = (char*)calloc(size + 1, sizeof(char));
-        get_file_name(o->under_object, o->under_vol_id, loc_params->obj_type, parent_name,  size+1);
-        dset_get_normalized_name(parent_name);	
-        split_folder_name = (char*)calloc(size + 7, sizeof(char));
-        sprintf(split_folder_name , "%s-%s", parent_name, "split" );
-    }
-    else
+    /*Get the split folder Name and splitfile properties, computed once per file*/
+    if(NULL == (file_ctx = dset_split_file_ctx_get(o, loc_params->obj_type)))
+        HGOTO_ERROR(H5E_VOL, H5E_CANTGET, NULL, "Can't get the parent file information");
+
+    /*Create the dataset in the background, the application gets a placeholder right away*/
+    if(loc_params->type == H5VL_OBJECT_BY_SELF && dset_split_async_enabled(o, req))
     {
-        split_folder_name = (char*)calloc(7, sizeof(char));
-        strcpy(split_folder_name, "split");
+        if(NULL == (dset = dset_split_async_dataset_create(o, loc_params->obj_type, name, lcpl_id, type_id, space_id,
+                           dcpl_id, dapl_id, dxpl_id, req)))
+            HGOTO_ERROR(H5E_VOL, H5E_CANTCREATE, NULL, "Can't queue the dataset creation");
+        HGOTO_DONE(dset);
     }
 
-    if (dset_create_split_folder(split_folder_name) < 0 )
-        HGOTO_ERROR(H5E_VOL, H5E_INTERNAL, NULL, "Folder creation failed");
-
     temp_path = (char*)calloc((strlen(name)+1), sizeof(char));
     if(!temp_path)
         HGOTO_ERROR(H5E_VOL, H5E_INTERNAL, NULL, "Memory allocation failed");
@@ -1527,24 +9670,146 @@ H5VL_dset_split_dataset_create(void *obj, const H5VL_loc_params_t *loc_params, c
     if(!dsetname)
         HGOTO_ERROR(H5E_VOL, H5E_INTERNAL, NULL, "Dataset name - get_dataset_name returned null value");
 
-    sprintf(file_name , "%s/%s-%ld%s", split_folder_name, dsetname, (time(NULL) + rand()), FILE_EXTENTION);
+    /*A dataset whose creation is deferred, or whose link is queued, holds its name already*/
+    if(flags && (file_ctx->lazy_head || file_ctx->link_head))
+    {
+        if(dset_split_get_dataset_path(o, loc_params, name, dsetname, &group_path, &dset_path) < 0)
+            HGOTO_ERROR(H5E_VOL, H5E_CANTGET, NULL, "Can't get the dataset path");
+        if(dset_split_lazy_find(file_ctx, dset_path) || dset_split_link_find(file_ctx, dset_path))
+            HGOTO_ERROR(H5E_VOL, H5E_EXISTS, NULL, "Dataset already exists");
+    }
+
+    /*Choose where the dataset goes, from its path when there is a policy table*/
+    placement = file_ctx->split_mode;
+    if(file_ctx->policy)
+    {
+        if(!dset_path && dset_split_get_dataset_path(o, loc_params, name, dsetname, &group_path, &dset_path) < 0)
+            HGOTO_ERROR(H5E_VOL, H5E_CANTGET, NULL, "Can't get the dataset path");
+        placement = dset_split_policy_match(file_ctx->policy, dset_path, placement);
+    }
+
+    /*Small datasets are not worth a splitfile, create them in the main file*/
+    if(placement == H5VL_DSET_SPLIT_MODE_INLINE ||
+       (file_ctx->split_threshold > 0 && dset_split_dataset_is_small(type_id, space_id, file_ctx->split_threshold)))
+    {
+        if(NULL == (under = H5VLdataset_create(o->under_object, loc_params, o->under_vol_id, name, lcpl_id, type_id, space_id,
+                                 dcpl_id, dapl_id, dxpl_id, req)))
+            HGOTO_ERROR(H5E_VOL, H5E_CANTCREATE, NULL, "Dataset creation failed");
+
+        dset = H5VL_dset_split_new_obj(under, o->under_vol_id);
+        dset_split_inherit_file_ctx(dset, o);
 
-    if((file_id = dset_split_file_create(file_name, o->under_object, loc_params->obj_type, o->under_vol_id)) < 0 )
-        HGOTO_ERROR(H5E_VOL, H5E_INTERNAL, NULL, "Dataset Splitfile creation failed");
+        /* Check for async request */
+        if (req && *req)
+            *req = H5VL_dset_split_new_obj(*req, o->under_vol_id);
 
-    file_under = H5VLobject(file_id);
+        HGOTO_DONE(dset);
+    }
 
-    if((status = dset_split_create_attribute(file_id)) < 0 )
-        HGOTO_ERROR(H5E_VOL, H5E_INTERNAL, NULL, "Attribute creation failed");
+    /*Splitfiles are named after the dataset path, the same on every run*/
+    if(!dset_path && dset_split_get_dataset_path(o, loc_params, name, dsetname, &group_path, &dset_path) < 0)
+        HGOTO_ERROR(H5E_VOL, H5E_CANTGET, NULL, "Can't get the dataset path");
 
-    file_loc_params.type = H5VL_OBJECT_BY_SELF;
-    file_loc_params.obj_type = H5I_FILE;
+    /*Create the splitfile on the first write, datasets never written don't get one*/
+    if((flags & H5VL_DSET_SPLIT_CREATE_LAZY) && file_ctx->lazy_create && !req && loc_params->type == H5VL_OBJECT_BY_SELF)
+    {
+        if(dset_split_lazy_new(o, loc_params, group_path, dset_path, dsetname, lcpl_id, type_id, space_id, dcpl_id,
+                               dapl_id, dxpl_id, &dset) < 0)
+            HGOTO_ERROR(H5E_VOL, H5E_EXISTS, NULL, "Dataset already exists");
+        if(dset)
+            HGOTO_DONE(dset);
+    }
+
+    if(placement == H5VL_DSET_SPLIT_MODE_GROUP)
+    {
+        /*The datasets of a group share one splitfile*/
+        if(NULL == (split_file = dset_split_bundle_open(group_path, file_ctx, file_name, sizeof(file_name))))
+            HGOTO_ERROR(H5E_VOL, H5E_CANTOPENFILE, NULL, "Group splitfile creation failed");
+    }
+    else
+    {
+        if(dset_split_get_file_name(file_ctx, dsetname, dset_path, file_name, sizeof(file_name)) < 0)
+            HGOTO_ERROR(H5E_VOL, H5E_INTERNAL, NULL, "Splitfile name too long");
+
+#ifdef H5_HAVE_PARALLEL
+        /*Each rank writes its block of the dataset to a splitfile of its own, laid out on the first write*/
+        if(dset_split_subfile_eligible(file_ctx, space_id))
+        {
+            if(NULL == (subfile = dset_split_subfile_new(file_ctx, file_name, sizeof(file_name), dsetname, lcpl_id,
+                                  type_id, space_id, dcpl_id, dapl_id)))
+                HGOTO_ERROR(H5E_VOL, H5E_CANTCREATE, NULL, "Rank-local splitfile setup failed");
+        }
+        else
+#endif
+        /*Use a pre-created splitfile if one is ready, moved into its subfolder*/
+        if(H5VL_dset_split_precreate_g.target > 0 &&
+           ((!file_ctx->shard_levels && !file_ctx->mirror_groups) || dset_split_prepare_folder(file_ctx, file_name, sizeof(file_name)) >= 0))
+            split_file = dset_split_reserve_take(file_ctx, file_name);
+    }
+
+    if(!split_file && !subfile)
+    {
+        if (dset_split_prepare_folder(file_ctx, file_name, sizeof(file_name)) < 0 )
+            HGOTO_ERROR(H5E_VOL, H5E_INTERNAL, NULL, "Folder creation failed");
+
+        /*A splitfile left by an earlier run, or by a deleted dataset, is overwritten*/
+        H5E_BEGIN_TRY {
+            file_id = dset_split_file_create(file_name, file_ctx, H5F_ACC_EXCL);
+        } H5E_END_TRY;
+        if(file_id < 0)
+        {
+            if((ret = dset_split_reclaim_stale(o, loc_params, name, file_ctx, file_name)) < 0)
+                HGOTO_ERROR(H5E_VOL, H5E_CANTCREATE, NULL, "Splitfile belongs to another file, the dataset may already exist");
+
+            /*A splitfile still in use is kept, the new one takes another name*/
+            if(ret > 0 && dset_split_fresh_file_name(file_name, sizeof(file_name)) < 0)
+                HGOTO_ERROR(H5E_VOL, H5E_INTERNAL, NULL, "Splitfile name too long");
+            if((file_id = dset_split_file_create(file_name, file_ctx, ret > 0 ? H5F_ACC_EXCL : H5F_ACC_TRUNC)) < 0 )
+                HGOTO_ERROR(H5E_VOL, H5E_INTERNAL, NULL, "Dataset Splitfile creation failed");
+        }
+
+        if(NULL == (split_file = dset_split_pool_insert(file_name, file_id, H5F_ACC_RDWR)))
+        {
+            H5Fclose(file_id);
+            HGOTO_ERROR(H5E_VOL, H5E_CANTINSERT, NULL, "Can't add the splitfile to the pool");
+        }
+
+        if((status = dset_split_create_attribute(file_id, file_ctx->owner)) < 0 )
+            HGOTO_ERROR(H5E_VOL, H5E_INTERNAL, NULL, "Attribute creation failed");
+    }
+    /*Queue the link, the main file gets the links of the new datasets together. The name is checked
+      before the dataset is created in its splitfile*/
+    ret = 1;
+    if((flags & H5VL_DSET_SPLIT_CREATE_QUEUE) && file_ctx->batch_links && loc_params->type == H5VL_OBJECT_BY_SELF)
+    {
+        if((ret = dset_split_link_queue(o, loc_params, name, dset_path, file_name, dsetname)) < 0)
+            HGOTO_ERROR(H5E_VOL, H5E_EXISTS, NULL, "Dataset already exists");
+        queued = (ret == 0);
+    }
+
+    if(!dset_under && !subfile)
+    {
+        file_id = split_file->fid;
 
-    if(NULL == (dset_under = H5VLdataset_create(file_under, &file_loc_params, o->under_vol_id, dsetname, lcpl_id, type_id, space_id,
-                             dcpl_id, dapl_id, dxpl_id, req)))
-        HGOTO_ERROR(H5E_VOL, H5E_INTERNAL, NULL, "Dataset creation failed");
+        file_under = H5VLobject(file_id);
 
-    if((ret = dset_split_extlink_create(file_name, dsetname, name, loc_params, o->under_object, o->under_vol_id, H5P_LINK_CREATE_DEFAULT, H5P_LINK_CREATE_DEFAULT, H5P_DATASET_XFER_DEFAULT, NULL)) < 0)
+        file_loc_params.type = H5VL_OBJECT_BY_SELF;
+        file_loc_params.obj_type = H5I_FILE;
+
+        /*Direct I/O needs the storage of contiguous datasets allocated up front*/
+        if(file_ctx->direct_io && (direct_dcpl_id = dset_split_direct_dcpl(dcpl_id)) >= 0)
+            dcpl_id = direct_dcpl_id;
+
+        /*The dataset's chunk cache is its share of the memory budget*/
+        if((gov_dapl_id = dset_split_gov_dapl(split_file, dapl_id)) >= 0)
+            dapl_id = gov_dapl_id;
+
+        if(NULL == (dset_under = H5VLdataset_create(file_under, &file_loc_params, o->under_vol_id, dsetname, lcpl_id, type_id, space_id,
+                                 dcpl_id, dapl_id, dxpl_id, req)))
+            HGOTO_ERROR(H5E_VOL, H5E_INTERNAL, NULL, "Dataset creation failed");
+    }
+
+    if(ret > 0 && (ret = dset_split_extlink_create(file_name, dsetname, name, loc_params, o->under_object, o->under_vol_id, H5P_LINK_CREATE_DEFAULT, H5P_LINK_CREATE_DEFAULT, H5P_DATASET_XFER_DEFAULT, NULL)) < 0)
         HGOTO_ERROR(H5E_VOL, H5E_INTERNAL, NULL, "Link creation failed");
 
     under = dset_under;
@@ -1552,37 +9817,77 @@ H5VL_dset_split_dataset_create(void *obj, const H5VL_loc_params_t *loc_params, c
     if(temp_path)
         free(temp_path);
     temp_path = NULL;
-    if(parent_name)
-        free(parent_name);
-    parent_name = NULL;
-    if(split_folder_name)
-        free(split_folder_name);
-    split_folder_name = NULL;
 
     if (under)
     {
-        dset = H5VL_dset_split_new_dataset_obj(under, o->under_vol_id, file_id, H5I_DATASET);
+        dset = H5VL_dset_split_new_dataset_obj(under, o->under_vol_id, split_file);
+        dset_split_inherit_file_ctx(dset, o);
 
         /* Check for async request */
         if (req && *req)
-            *req = H5VL_dset_split_new_dataset_obj(*req, o->under_vol_id, file_id, H5I_DATASET);
+            *req = H5VL_dset_split_new_obj(*req, o->under_vol_id);
     } /* end if */
+    else if (subfile)
+    {
+        /*No splitfile yet, the placeholder holds the layout until the first write*/
+        dset = H5VL_dset_split_new_obj(NULL, o->under_vol_id);
+        dset->type = H5I_DATASET;
+        dset_split_inherit_file_ctx(dset, o);
+        dset->subfile = subfile;
+        subfile = NULL;
+    }
     else
         dset = NULL;
 
     FUNC_RETURN_SET(dset);
 
     done:
+        if(FUNC_ERRORED && queued)
+            dset_split_link_drop(file_ctx, dset_path);
+
+        if(FUNC_ERRORED && dset_under)
+            H5VLdataset_close(dset_under, o->under_vol_id, dxpl_id, NULL);
+
+        if(FUNC_ERRORED && split_file)
+            dset_split_pool_release(split_file);
+
         if(temp_path)
             free(temp_path);
 
-        if(parent_name)
-            free(parent_name);
+        if(group_path)
+            free(group_path);
+
+        if(dset_path)
+            free(dset_path);
 
-        if(split_folder_name)
-            free(split_folder_name);
+        if(subfile)
+            dset_split_subfile_free(subfile);
+
+        if(direct_dcpl_id >= 0)
+            H5Pclose(direct_dcpl_id);
+        if(gov_dapl_id >= 0)
+            H5Pclose(gov_dapl_id);
 
     FUNC_LEAVE_VOL
+} /* end dset_split_dataset_create() */
+
+/*-------------------------------------------------------------------------
+ * Function:    H5VL_dset_split_dataset_create
+ *
+ * Purpose:     Creates a dataset in a container
+ *
+ * Return:      Success:    Pointer to a dataset object
+ *              Failure:    NULL
+ *
+ *-------------------------------------------------------------------------
+ */
+static void *
+H5VL_dset_split_dataset_create(void *obj, const H5VL_loc_params_t *loc_params, const char *name,
+                                 hid_t lcpl_id, hid_t type_id, hid_t space_id, hid_t dcpl_id, hid_t dapl_id,
+                                 hid_t dxpl_id, void **req)
+{
+    return dset_split_dataset_create(obj, loc_params, name, lcpl_id, type_id, space_id, dcpl_id, dapl_id, dxpl_id,
+                                     req, H5VL_DSET_SPLIT_CREATE_LAZY | H5VL_DSET_SPLIT_CREATE_QUEUE);
 } /* end H5VL_dset_split_dataset_create() */
 
 /*-------------------------------------------------------------------------
@@ -1601,15 +9906,33 @@ H5VL_dset_split_dataset_open(void *obj, const H5VL_loc_params_t *loc_params, con
 {
     H5VL_dset_split_t *dset;
     H5VL_dset_split_t *o = (H5VL_dset_split_t *)obj;
-    void *               under;
+    H5VL_dset_split_pool_entry_t *split_file = NULL;
+    void *               under = NULL;
 
 #ifdef DEBUG
     printf("DSET-SPLIT VOL DATASET Open\n");
 #endif
 
-    under = H5VLdataset_open(o->under_object, loc_params, o->under_vol_id, name, dapl_id, dxpl_id, req);
+    /* A dataset whose creation is deferred is created, the application opens it by name */
+    if (dset_split_lazy_sync(o, loc_params, name) < 0)
+        return NULL;
+
+    /* A dataset whose external link is queued is opened from its split file */
+    under = dset_split_dataset_open_queued(o, loc_params, name, dapl_id, dxpl_id, req, &split_file);
+
+    /* Borrow the split file from the pool, instead of reopening it through the external link */
+    if (!under && (H5VL_dset_split_pool_g.capacity > 0 || H5VL_dset_split_pool_g.max_open > 0 ||
+                   H5VL_dset_split_gov_g.budget > 0))
+        under = dset_split_dataset_open_pooled(o, loc_params, name, dapl_id, dxpl_id, req, &split_file);
+
+    if (!under)
+        under = H5VLdataset_open(o->under_object, loc_params, o->under_vol_id, name, dapl_id, dxpl_id, req);
     if (under) {
-        dset = H5VL_dset_split_new_obj(under, o->under_vol_id);
+        if (split_file)
+            dset = H5VL_dset_split_new_dataset_obj(under, o->under_vol_id, split_file);
+        else
+            dset = H5VL_dset_split_new_obj(under, o->under_vol_id);
+        dset_split_inherit_file_ctx(dset, o);
 
         /* Check for async request */
         if (req && *req)
@@ -1636,15 +9959,64 @@ H5VL_dset_split_dataset_read(void *dset, hid_t mem_type_id, hid_t mem_space_id,
                                hid_t plist_id, void *buf, void **req)
 {
     H5VL_dset_split_t *o = (H5VL_dset_split_t *)dset;
+    hid_t                local_space_id = H5S_ALL;
+    hid_t                global_mem_space_id = H5S_ALL;
+    int                  done;
     herr_t               ret_value;
 
 #ifdef DEBUG
     printf("DSET-SPLIT VOL DATASET Read\n");
 #endif
 
+    if (dset_split_async_enabled(o, req))
+        return dset_split_async_dataset_op(H5VL_DSET_SPLIT_TASK_READ, o, mem_type_id, mem_space_id, file_space_id,
+                                           buf, H5I_INVALID_HID, plist_id, req);
+    dset_split_async_sync(o);
+
+    /* A dataset not created yet, or not laid out yet, was never written */
+    if (o->lazy)
+        return dset_split_lazy_read(o->lazy, mem_type_id, mem_space_id, file_space_id, buf);
+    if (o->subfile && o->subfile->pending)
+        return dset_split_lazy_read(o->subfile->pending, mem_type_id, mem_space_id, file_space_id, buf);
+
+    /* A dataset whose split file was closed meanwhile is reopened */
+    if (dset_split_rebind(o) < 0)
+        return -1;
+
+    /* Buffered writes must reach the file first */
+    if (dset_split_wb_flush(o) < 0)
+        return -1;
+
+    /* Reads of a mapped dataset are a memcpy */
+    if (dset_split_mapped_read(o, mem_type_id, mem_space_id, file_space_id, buf))
+        return 0;
+
+    /* Chunks of deflated datasets are expanded in parallel */
+    if ((done = dset_split_zip_io(o, mem_type_id, mem_space_id, file_space_id, plist_id, buf, FALSE)) != 0)
+        return done < 0 ? -1 : 0;
+
+    /* Sequential reads are served from the read-ahead window */
+    if ((done = dset_split_ra_read(o, mem_type_id, mem_space_id, file_space_id, plist_id, buf)) != 0)
+        return done < 0 ? -1 : 0;
+
+    /* A dataset in rank-local split files only holds the rank's block */
+    if (o->subfile) {
+        if ((local_space_id = dset_split_subfile_space(o->subfile, file_space_id,
+                                                       mem_space_id == H5S_ALL ? &global_mem_space_id : NULL)) < 0)
+            return -1;
+        file_space_id = local_space_id;
+        if (mem_space_id == H5S_ALL)
+            mem_space_id = global_mem_space_id;
+    }
+
     ret_value = H5VLdataset_read(o->under_object, o->under_vol_id, mem_type_id, mem_space_id, file_space_id,
                                  plist_id, buf, req);
 
+    if (local_space_id != H5S_ALL)
+        H5Sclose(local_space_id);
+    if (global_mem_space_id != H5S_ALL)
+        H5Sclose(global_mem_space_id);
+
     /* Check for async request */
     if (req && *req)
         *req = H5VL_dset_split_new_obj(*req, o->under_vol_id);
@@ -1667,15 +10039,65 @@ H5VL_dset_split_dataset_write(void *dset, hid_t mem_type_id, hid_t mem_space_id,
                                 hid_t plist_id, const void *buf, void **req)
 {
     H5VL_dset_split_t *o = (H5VL_dset_split_t *)dset;
+    hid_t                local_space_id = H5S_ALL;
+    hid_t                global_mem_space_id = H5S_ALL;
+    int                  buffered;
+    int                  done;
     herr_t               ret_value;
 
 #ifdef DEBUG
     printf("DSET-SPLIT VOL DATASET Write\n");
 #endif
 
+    if (dset_split_async_enabled(o, req))
+        return dset_split_async_dataset_op(H5VL_DSET_SPLIT_TASK_WRITE, o, mem_type_id, mem_space_id, file_space_id,
+                                           (void *)buf, H5I_INVALID_HID, plist_id, req);
+    dset_split_async_sync(o);
+    dset_split_ra_invalidate(o);
+
+#ifdef H5_HAVE_PARALLEL
+    /* The first write lays a dataset of rank-local split files out, from the selections of all ranks */
+    if (o->subfile && o->subfile->pending) {
+        H5FD_mpio_xfer_t xfer_mode = H5FD_MPIO_INDEPENDENT;
+
+        if (H5Pget_dxpl_mpio(plist_id, &xfer_mode) < 0 || xfer_mode != H5FD_MPIO_COLLECTIVE ||
+            dset_split_subfile_layout(o, file_space_id, plist_id) < 0)
+            return -1;
+    }
+#endif
+
+    /* The first write creates a deferred dataset */
+    if (dset_split_lazy_create(o, TRUE) < 0 || dset_split_rebind(o) < 0)
+        return -1;
+
+    /* Hold small writes back, others are written after the buffered ones */
+    if ((buffered = dset_split_wb_write(o, mem_type_id, mem_space_id, file_space_id, plist_id, buf)) != 0)
+        return buffered < 0 ? -1 : 0;
+    if (dset_split_wb_flush(o) < 0)
+        return -1;
+
+    /* Chunks of deflated datasets are compressed in parallel */
+    if ((done = dset_split_zip_io(o, mem_type_id, mem_space_id, file_space_id, plist_id, (void *)buf, TRUE)) != 0)
+        return done < 0 ? -1 : 0;
+
+    /* A dataset in rank-local split files only holds the rank's block */
+    if (o->subfile) {
+        if ((local_space_id = dset_split_subfile_space(o->subfile, file_space_id,
+                                                       mem_space_id == H5S_ALL ? &global_mem_space_id : NULL)) < 0)
+            return -1;
+        file_space_id = local_space_id;
+        if (mem_space_id == H5S_ALL)
+            mem_space_id = global_mem_space_id;
+    }
+
     ret_value = H5VLdataset_write(o->under_object, o->under_vol_id, mem_type_id, mem_space_id, file_space_id,
                                   plist_id, buf, req);
 
+    if (local_space_id != H5S_ALL)
+        H5Sclose(local_space_id);
+    if (global_mem_space_id != H5S_ALL)
+        H5Sclose(global_mem_space_id);
+
     /* Check for async request */
     if (req && *req)
         *req = H5VL_dset_split_new_obj(*req, o->under_vol_id);
@@ -1703,6 +10125,22 @@ H5VL_dset_split_dataset_get(void *dset, H5VL_dataset_get_args_t *args, hid_t dxp
     printf("DSET-SPLIT VOL DATASET Get\n");
 #endif
 
+    dset_split_async_sync(o);
+
+    /* A dataset not created yet, or not laid out yet, is described by its creation arguments */
+    if (o->lazy)
+        return dset_split_lazy_get(o->lazy, args);
+    if (o->subfile && o->subfile->pending)
+        return dset_split_lazy_get(o->subfile->pending, args);
+    if (dset_split_rebind(o) < 0)
+        return -1;
+
+    /* The rank-local split file only has the rank's block, report the whole dataset */
+    if (o->subfile && args->op_type == H5VL_DATASET_GET_SPACE) {
+        args->args.get_space.space_id = H5Scopy(o->subfile->space_id);
+        return args->args.get_space.space_id < 0 ? -1 : 0;
+    }
+
     ret_value = H5VLdataset_get(o->under_object, o->under_vol_id, args, dxpl_id, req);
 
     /* Check for async request */
@@ -1733,6 +10171,24 @@ H5VL_dset_split_dataset_specific(void *obj, H5VL_dataset_specific_args_t *args,
     printf("DSET-SPLIT VOL H5Dspecific\n");
 #endif
 
+    if (args->op_type == H5VL_DATASET_FLUSH && dset_split_async_enabled(o, req))
+        return dset_split_async_dataset_op(H5VL_DSET_SPLIT_TASK_FLUSH, o, H5I_INVALID_HID, H5I_INVALID_HID,
+                                           H5I_INVALID_HID, NULL, args->args.flush.dset_id, dxpl_id, req);
+    dset_split_async_sync(o);
+
+    /* A dataset not created or laid out yet has nothing to flush or refresh, an extent change creates it */
+    if ((o->lazy || (o->subfile && o->subfile->pending)) &&
+        (args->op_type == H5VL_DATASET_FLUSH || args->op_type == H5VL_DATASET_REFRESH))
+        return 0;
+    if (dset_split_lazy_create(o, TRUE) < 0 || dset_split_rebind(o) < 0)
+        return -1;
+
+    /* Flushes, extent changes and refreshes apply to the buffered writes too */
+    if (dset_split_wb_flush(o) < 0)
+        return -1;
+    if (args->op_type != H5VL_DATASET_FLUSH)
+        dset_split_ra_invalidate(o);
+
     under_vol_id = o->under_vol_id;
 
     ret_value = H5VLdataset_specific(o->under_object, o->under_vol_id, args, dxpl_id, req);
@@ -1758,14 +10214,84 @@ static herr_t
 H5VL_dset_split_dataset_optional(void *obj, H5VL_optional_args_t *args, hid_t dxpl_id, void **req)
 {
     H5VL_dset_split_t *o = (H5VL_dset_split_t *)obj;
+    H5VL_native_dataset_optional_args_t *dset_args = (H5VL_native_dataset_optional_args_t *)args->args;
+    const hsize_t **     offset = NULL;
+    const hsize_t *      global_offset = NULL;
+    hsize_t              local_offset[H5S_MAX_RANK];
+    hid_t *              space = NULL;
+    hid_t                global_space_id = H5I_INVALID_HID;
     herr_t               ret_value;
 
 #ifdef DEBUG
     printf("DSET-SPLIT VOL DATASET Optional\n");
 #endif
 
+    dset_split_async_sync(o);
+    if (dset_split_lazy_create(o, TRUE) < 0 || dset_split_rebind(o) < 0)
+        return -1;
+
+    /* Native operations such as chunk I/O see the file */
+    if (dset_split_wb_flush(o) < 0)
+        return -1;
+    dset_split_ra_invalidate(o);
+
+    /* Chunks of a dataset in rank-local split files are addressed in the whole dataset */
+    if (o->subfile) {
+        switch (args->op_type) {
+            case H5VL_NATIVE_DATASET_GET_CHUNK_STORAGE_SIZE:
+                offset = &dset_args->get_chunk_storage_size.offset;
+                break;
+            case H5VL_NATIVE_DATASET_GET_CHUNK_INFO_BY_COORD:
+                offset = &dset_args->get_chunk_info_by_coord.offset;
+                break;
+            case H5VL_NATIVE_DATASET_CHUNK_READ:
+                offset = &dset_args->chunk_read.offset;
+                break;
+            case H5VL_NATIVE_DATASET_CHUNK_WRITE:
+                offset = &dset_args->chunk_write.offset;
+                break;
+            case H5VL_NATIVE_DATASET_GET_NUM_CHUNKS:
+                space = &dset_args->get_num_chunks.space_id;
+                break;
+            case H5VL_NATIVE_DATASET_GET_CHUNK_INFO_BY_IDX:
+                space = &dset_args->get_chunk_info_by_idx.space_id;
+                break;
+            default:
+                break;
+        }
+        if (offset) {
+            if (dset_split_subfile_chunk(o->subfile, *offset, local_offset) < 0)
+                return -1;
+            global_offset = *offset;
+            *offset       = local_offset;
+        }
+        if (space && *space != H5S_ALL) {
+            global_space_id = *space;
+            if ((*space = dset_split_subfile_space(o->subfile, global_space_id, NULL)) < 0) {
+                *space = global_space_id;
+                return -1;
+            }
+        }
+    }
+
     ret_value = H5VLdataset_optional(o->under_object, o->under_vol_id, args, dxpl_id, req);
 
+    /* Give the caller's arguments back, chunk offsets in the whole dataset */
+    if (offset)
+        *offset = global_offset;
+    if (global_space_id >= 0) {
+        H5Sclose(*space);
+        *space = global_space_id;
+    }
+    if (o->subfile && args->op_type == H5VL_NATIVE_DATASET_GET_CHUNK_INFO_BY_IDX && ret_value >= 0 &&
+        dset_args->get_chunk_info_by_idx.offset) {
+        int ndims = H5Sget_simple_extent_ndims(o->subfile->space_id);
+        int i;
+
+        for (i = 0; i < ndims; i++)
+            dset_args->get_chunk_info_by_idx.offset[i] += o->subfile->start[i];
+    }
+
     /* Check for async request */
     if (req && *req)
         *req = H5VL_dset_split_new_obj(*req, o->under_vol_id);
@@ -1793,11 +10319,40 @@ H5VL_dset_split_dataset_close(void *dset, hid_t dxpl_id, void **req)
     printf("DSET-SPLIT VOL DATASET Close\n");
 #endif
 
+    if (dset_split_async_enabled(o, req))
+        return dset_split_async_dataset_op(H5VL_DSET_SPLIT_TASK_CLOSE, o, H5I_INVALID_HID, H5I_INVALID_HID,
+                                           H5I_INVALID_HID, NULL, H5I_INVALID_HID, dxpl_id, req);
+    dset_split_async_sync(o);
+
+    /* A dataset closed before any write only goes in the main file */
+    if (dset_split_lazy_create(o, FALSE) < 0)
+        return -1;
+
+#ifdef H5_HAVE_PARALLEL
+    /* Closing is collective: a dataset of rank-local split files never written goes to a shared split file */
+    if (o->subfile && o->subfile->pending && dset_split_subfile_layout(o, H5I_INVALID_HID, dxpl_id) < 0)
+        return -1;
+#endif
+
+    /* A detached dataset is already closed in its split file */
+    if (o->detached)
+        return H5VL_dset_split_free_obj(o);
+
+    /* Write the buffered writes, the dataset stays open if that fails */
+    if (dset_split_wb_flush(o) < 0)
+        return -1;
+
     ret_value = H5VLdataset_close(o->under_object, o->under_vol_id, dxpl_id, req);
 
-    if(o->set)
+    /* Return the split file to the pool, it stays open until evicted */
+    if(ret_value >= 0 && o->set)
     {
-       ret_value = H5Fclose(o->fid);
+       dset_split_user_unbind(o);
+       ret_value = dset_split_pool_release(o->split_file);
+
+       /* Without a background worker, top the reserves up here rather than on dataset creation */
+       if(H5VL_dset_split_precreate_g.target > 0 && !H5VL_dset_split_precreate_g.threaded)
+           dset_split_reserve_refill();
     }
 
     /* Check for async request */
@@ -2040,6 +10595,14 @@ H5VL_dset_split_file_create(const char *name, unsigned flags, hid_t fcpl_id, hid
     if (!info)
         return NULL;
 
+    /* Size the split file pool for the largest of the open main files */
+    if (info->pool_size > H5VL_dset_split_pool_g.capacity)
+        H5VL_dset_split_pool_g.capacity = info->pool_size;
+    H5VL_dset_split_pool_g.max_open = info->max_open_files;
+    H5VL_dset_split_gov_g.budget    = info->mem_budget;
+    H5VL_dset_split_precreate_g.target = info->precreate;
+    H5VL_dset_split_async_g.nthreads   = info->async_threads;
+
     /* Copy the FAPL */
     under_fapl_id = H5Pcopy(fapl_id);
 
@@ -2051,6 +10614,15 @@ H5VL_dset_split_file_create(const char *name, unsigned flags, hid_t fcpl_id, hid
     if (under) {
 
         file = H5VL_dset_split_new_obj(under, info->under_vol_id);
+
+        /* Gather what dataset creation needs from the main file once, retried on first use if this fails */
+        file->main_file = dset_split_main_add(name, info);
+        file->file_ctx = dset_split_file_ctx_new(under, H5I_FILE, info->under_vol_id, info);
+
+        /* Create the split folder now, dataset creation retries if this fails */
+        if (file->file_ctx && info->eager_folder)
+            dset_split_prepare_folder(file->file_ctx, NULL, 0);
+
         /* Check for async request */
         if (req && *req)
             *req = H5VL_dset_split_new_obj(*req, info->under_vol_id);
@@ -2095,6 +10667,14 @@ H5VL_dset_split_file_open(const char *name, unsigned flags, hid_t fapl_id, hid_t
     if (!info)
         return NULL;
 
+    /* Size the split file pool for the largest of the open main files */
+    if (info->pool_size > H5VL_dset_split_pool_g.capacity)
+        H5VL_dset_split_pool_g.capacity = info->pool_size;
+    H5VL_dset_split_pool_g.max_open = info->max_open_files;
+    H5VL_dset_split_gov_g.budget    = info->mem_budget;
+    H5VL_dset_split_precreate_g.target = info->precreate;
+    H5VL_dset_split_async_g.nthreads   = info->async_threads;
+
     /* Copy the FAPL */
     under_fapl_id = H5Pcopy(fapl_id);
 
@@ -2106,6 +10686,10 @@ H5VL_dset_split_file_open(const char *name, unsigned flags, hid_t fapl_id, hid_t
     if (under) {
         file = H5VL_dset_split_new_obj(under, info->under_vol_id);
 
+        /* Gather what dataset creation needs from the main file once, retried on first use if this fails */
+        file->main_file = dset_split_main_add(name, info);
+        file->file_ctx = dset_split_file_ctx_new(under, H5I_FILE, info->under_vol_id, info);
+
         /* Check for async request */
         if (req && *req)
             *req = H5VL_dset_split_new_obj(*req, info->under_vol_id);
@@ -2230,6 +10814,14 @@ H5VL_dset_split_file_specific(void *file, H5VL_file_specific_args_t *args, hid_t
         new_o = NULL;
     } /* end else-if */
     else {
+        /* H5Fflush writes the buffered dataset writes of the file */
+        if (args->op_type == H5VL_FILE_FLUSH && o->file_ctx && dset_split_wb_flush_file(o->file_ctx) < 0)
+            return -1;
+
+        /* and inserts the queued external links */
+        if (args->op_type == H5VL_FILE_FLUSH && dset_split_link_sync(o) < 0)
+            return -1;
+
         /* Keep the correct underlying VOL ID for later */
         under_vol_id = o->under_vol_id;
 
@@ -2263,8 +10855,15 @@ H5VL_dset_split_file_specific(void *file, H5VL_file_specific_args_t *args, hid_t
     } /* end else-if */
     else if (args->op_type == H5VL_FILE_REOPEN) {
         /* Wrap file struct pointer for 'reopen' operation, if we reopened one */
-        if (ret_value >= 0 && *args->args.reopen.file)
-            *args->args.reopen.file = H5VL_dset_split_new_obj(*args->args.reopen.file, under_vol_id);
+        if (ret_value >= 0 && *args->args.reopen.file) {
+            H5VL_dset_split_t *new_file = H5VL_dset_split_new_obj(*args->args.reopen.file, under_vol_id);
+
+            /* The reopened file shares the connector options and metadata of the main file */
+            if (NULL != (new_file->main_file = o->main_file))
+                new_file->main_file->nopens++;
+            dset_split_inherit_file_ctx(new_file, o);
+            *args->args.reopen.file = new_file;
+        }
     } /* end else */
 
 
@@ -2313,12 +10912,25 @@ static herr_t
 H5VL_dset_split_file_close(void *file, hid_t dxpl_id, void **req)
 {
     H5VL_dset_split_t *o = (H5VL_dset_split_t *)file;
+    char *               split_folder_name = NULL;
     herr_t               ret_value;
 
 #ifdef DEBUG
     printf("DSET-SPLIT VOL FILE Close\n");
 #endif
 
+    /* Queued dataset operations may use the file */
+    dset_split_async_drain();
+
+    /* The main file gets the queued external links, it stays open if that fails */
+    if (dset_split_link_sync(o) < 0)
+        return -1;
+
+    /* Keep the split folder name past the wrapper, to drop its pre-created and idle split files
+     * once the main file is not open anymore */
+    if (o->file_ctx && (!o->main_file || o->main_file->nopens == 1))
+        split_folder_name = strdup(o->file_ctx->split_folder);
+
     ret_value = H5VLfile_close(o->under_object, o->under_vol_id, dxpl_id, req);
 
     /* Check for async request */
@@ -2326,9 +10938,23 @@ H5VL_dset_split_file_close(void *file, hid_t dxpl_id, void **req)
         *req = H5VL_dset_split_new_obj(*req, o->under_vol_id);
 
     /* Release our wrapper, if underlying file was closed */
-    if (ret_value >= 0)
+    if (ret_value >= 0) {
+        if (o->main_file)
+            dset_split_main_release(o->main_file);
         H5VL_dset_split_free_obj(o);
 
+        /* Close the idle split files of the main file, it is done with them */
+        if (split_folder_name) {
+            if (H5VL_dset_split_precreate_g.head)
+                dset_split_reserve_drain(split_folder_name);
+            if (dset_split_pool_evict_folder(split_folder_name) < 0)
+                ret_value = -1;
+        }
+        if (dset_split_pool_resize() < 0)
+            ret_value = -1;
+    }
+    free(split_folder_name);
+
     return ret_value;
 } /* end H5VL_dset_split_file_close() */
 
@@ -2359,6 +10985,7 @@ H5VL_dset_split_group_create(void *obj, const H5VL_loc_params_t *loc_params, con
 
     if (under) {
         group = H5VL_dset_split_new_obj(under, o->under_vol_id);
+        dset_split_inherit_file_ctx(group, o);
 
         /* Check for async request */
         if (req && *req)
@@ -2396,6 +11023,7 @@ H5VL_dset_split_group_open(void *obj, const H5VL_loc_params_t *loc_params, const
     under = H5VLgroup_open(o->under_object, loc_params, o->under_vol_id, name, gapl_id, dxpl_id, req);
     if (under) {
         group = H5VL_dset_split_new_obj(under, o->under_vol_id);
+        dset_split_inherit_file_ctx(group, o);
 
         /* Check for async request */
         if (req && *req)
@@ -2426,6 +11054,10 @@ H5VL_dset_split_group_get(void *obj, H5VL_group_get_args_t *args, hid_t dxpl_id,
     printf("DSET-SPLIT VOL GROUP Get\n");
 #endif
 
+    /* The operation may see the links of new datasets */
+    if (dset_split_link_sync(o) < 0)
+        return -1;
+
     ret_value = H5VLgroup_get(o->under_object, o->under_vol_id, args, dxpl_id, req);
     /* Check for async request */
     if (req && *req)
@@ -2530,6 +11162,9 @@ H5VL_dset_split_group_close(void *grp, hid_t dxpl_id, void **req)
 #ifdef DEBUG
     printf("DSET-SPLIT VOL H5Gclose\n");
 #endif
+
+    /* Queued dataset creations may use the group */
+    dset_split_async_drain();
     {
         ret_value = H5VLgroup_close(o->under_object, o->under_vol_id, dxpl_id, req);
     }
@@ -2568,6 +11203,10 @@ H5VL_dset_split_link_create(H5VL_link_create_args_t *args, void *obj, const H5VL
 #ifdef DEBUG
     printf("DSET-SPLIT VOL LINK Create\n");
 #endif
+
+    /* The operation may see the links of new datasets */
+    if (dset_split_link_sync(o) < 0)
+        return -1;
     /* Try to retrieve the under VOL id */
     if (o)
         under_vol_id = o->under_vol_id;
@@ -2624,6 +11263,10 @@ H5VL_dset_split_link_copy(void *src_obj, const H5VL_loc_params_t *loc_params1, v
     printf("DSET-SPLIT VOL LINK Copy\n");
 #endif
 
+    /* The operation may see the links of new datasets */
+    if (dset_split_link_sync(o_src) < 0 || dset_split_link_sync(o_dst) < 0)
+        return -1;
+
     /* Retrieve the under VOL id */
     if (o_src)
         under_vol_id = o_src->under_vol_id;
@@ -2664,13 +11307,43 @@ H5VL_dset_split_link_move(void *src_obj, const H5VL_loc_params_t *loc_params1, v
 {
     H5VL_dset_split_t *o_src        = (H5VL_dset_split_t *)src_obj;
     H5VL_dset_split_t *o_dst        = (H5VL_dset_split_t *)dst_obj;
+    H5VL_dset_split_t *o_loc        = o_dst ? o_dst : o_src;
     hid_t                under_vol_id = -1;
+    char *               old_path     = NULL;
+    char *               new_path     = NULL;
+    char *               group_path;
     herr_t               ret_value;
 
 #ifdef DEBUG
     printf("DSET-SPLIT VOL LINK Move\n");
 #endif
 
+    /* The operation may see the links of new datasets */
+    if (dset_split_link_sync(o_src) < 0 || dset_split_link_sync(o_dst) < 0)
+        return -1;
+
+    /* The split files of a mirrored layout follow the link, see where it goes */
+    if (o_loc && o_loc->file_ctx && o_loc->file_ctx->mirror_groups && !req &&
+        loc_params1->type == H5VL_OBJECT_BY_NAME && loc_params2->type == H5VL_OBJECT_BY_NAME
+#ifdef H5_HAVE_PARALLEL
+        && o_loc->file_ctx->comm == MPI_COMM_NULL
+#endif
+    ) {
+        const char *name1 = loc_params1->loc_data.loc_by_name.name;
+        const char *name2 = loc_params2->loc_data.loc_by_name.name;
+        const char *last1 = strrchr(name1, '/') ? strrchr(name1, '/') + 1 : name1;
+        const char *last2 = strrchr(name2, '/') ? strrchr(name2, '/') + 1 : name2;
+
+        if (*last1 && *last2 && strcmp(last1, ".") != 0 && strcmp(last2, ".") != 0) {
+            group_path = NULL;
+            dset_split_get_dataset_path(o_src ? o_src : o_dst, loc_params1, name1, last1, &group_path, &old_path);
+            free(group_path);
+            group_path = NULL;
+            dset_split_get_dataset_path(o_loc, loc_params2, name2, last2, &group_path, &new_path);
+            free(group_path);
+        }
+    }
+
     /* Retrieve the under VOL id */
     if (o_src)
         under_vol_id = o_src->under_vol_id;
@@ -2686,6 +11359,14 @@ H5VL_dset_split_link_move(void *src_obj, const H5VL_loc_params_t *loc_params1, v
     if (req && *req)
         *req = H5VL_dset_split_new_obj(*req, under_vol_id);
 
+    if (ret_value >= 0 && old_path && new_path && strcmp(old_path, new_path) != 0) {
+        /* No asynchronous operation may use the split files meanwhile */
+        dset_split_async_drain();
+        dset_split_mirror_rename(o_loc, loc_params2->obj_type, old_path, new_path);
+    }
+    free(old_path);
+    free(new_path);
+
     return ret_value;
 } /* end H5VL_dset_split_link_move() */
 
@@ -2710,6 +11391,12 @@ H5VL_dset_split_link_get(void *obj, const H5VL_loc_params_t *loc_params, H5VL_li
     printf("DSET-SPLIT VOL LINK Get\n");
 #endif
 
+    /* The operation may see the links of new datasets */
+    if ((loc_params->type == H5VL_OBJECT_BY_NAME &&
+         dset_split_lazy_sync(o, loc_params, loc_params->loc_data.loc_by_name.name) < 0) ||
+        dset_split_link_sync(o) < 0)
+        return -1;
+
     ret_value = H5VLlink_get(o->under_object, loc_params, o->under_vol_id, args, dxpl_id, req);
 
     /* Check for async request */
@@ -2740,6 +11427,24 @@ H5VL_dset_split_link_specific(void *obj, const H5VL_loc_params_t *loc_params,
     printf("DSET-SPLIT VOL LINK Specific\n");
 #endif
 
+    /* Datasets whose creation is deferred are created, the operation sees them */
+    if (args->op_type == H5VL_LINK_ITER) {
+        if (dset_split_lazy_sync(o, NULL, NULL) < 0)
+            return -1;
+    }
+    else if (loc_params->type == H5VL_OBJECT_BY_NAME &&
+             dset_split_lazy_sync(o, loc_params, loc_params->loc_data.loc_by_name.name) < 0)
+        return -1;
+
+    /* Whether a link exists is answered from the queue too, other operations see the queued links */
+    if (args->op_type == H5VL_LINK_EXISTS && loc_params->type == H5VL_OBJECT_BY_NAME &&
+        dset_split_link_resolve(o, loc_params, loc_params->loc_data.loc_by_name.name)) {
+        *args->args.exists.exists = TRUE;
+        return 0;
+    }
+    if (dset_split_link_sync(o) < 0)
+        return -1;
+
     ret_value = H5VLlink_specific(o->under_object, loc_params, o->under_vol_id, args, dxpl_id, req);
 
     /* Check for async request */
@@ -2770,6 +11475,10 @@ H5VL_dset_split_link_optional(void *obj, const H5VL_loc_params_t *loc_params, H5
     printf("DSET-SPLIT VOL LINK Optional\n");
 #endif
 
+    /* The operation may see the links of new datasets */
+    if (dset_split_link_sync(o) < 0)
+        return -1;
+
     ret_value = H5VLlink_optional(o->under_object, loc_params, o->under_vol_id, args, dxpl_id, req);
 
     /* Check for async request */
@@ -2801,9 +11510,20 @@ H5VL_dset_split_object_open(void *obj, const H5VL_loc_params_t *loc_params, H5I_
     printf("DSET-SPLIT VOL OBJECT Open\n");
 #endif
 
+    /* The operation may see the links of new datasets, and the datasets whose creation is deferred */
+    if ((loc_params->type == H5VL_OBJECT_BY_NAME &&
+         dset_split_lazy_sync(o, loc_params, loc_params->loc_data.loc_by_name.name) < 0) ||
+        dset_split_link_sync(o) < 0)
+        return NULL;
+
+    dset_split_async_sync(o);
+    if (dset_split_lazy_create(o, TRUE) < 0 || dset_split_rebind(o) < 0)
+        return NULL;
+
     under = H5VLobject_open(o->under_object, loc_params, o->under_vol_id, opened_type, dxpl_id, req);
     if (under) {
         new_obj = H5VL_dset_split_new_obj(under, o->under_vol_id);
+        dset_split_inherit_file_ctx(new_obj, o);
 
         /* Check for async request */
         if (req && *req)
@@ -2838,6 +11558,10 @@ H5VL_dset_split_object_copy(void *src_obj, const H5VL_loc_params_t *src_loc_para
     printf("DSET-SPLIT VOL OBJECT Copy\n");
 #endif
 
+    /* The operation may see the links of new datasets */
+    if (dset_split_link_sync(o_src) < 0 || dset_split_link_sync(o_dst) < 0)
+        return -1;
+
     ret_value =
         H5VLobject_copy(o_src->under_object, src_loc_params, src_name, o_dst->under_object, dst_loc_params,
                         dst_name, o_src->under_vol_id, ocpypl_id, lcpl_id, dxpl_id, req);
@@ -2870,6 +11594,16 @@ H5VL_dset_split_object_get(void *obj, const H5VL_loc_params_t *loc_params, H5VL_
     printf("DSET-SPLIT VOL OBJECT Get\n");
 #endif
 
+    /* The operation may see the links of new datasets, and the datasets whose creation is deferred */
+    if ((loc_params->type == H5VL_OBJECT_BY_NAME &&
+         dset_split_lazy_sync(o, loc_params, loc_params->loc_data.loc_by_name.name) < 0) ||
+        dset_split_link_sync(o) < 0)
+        return -1;
+
+    dset_split_async_sync(o);
+    if (dset_split_lazy_create(o, TRUE) < 0 || dset_split_rebind(o) < 0)
+        return -1;
+
     ret_value = H5VLobject_get(o->under_object, loc_params, o->under_vol_id, args, dxpl_id, req);
     /* Check for async request */
     if (req && *req)
@@ -2900,6 +11634,17 @@ H5VL_dset_split_object_specific(void *obj, const H5VL_loc_params_t *loc_params,
     printf("DSET-SPLIT VOL OBJECT Specific\n");
 #endif
 
+    /* The operation may see the links of new datasets, and the datasets whose creation is deferred */
+    if ((args->op_type == H5VL_OBJECT_VISIT && dset_split_lazy_sync(o, NULL, NULL) < 0) ||
+        (loc_params->type == H5VL_OBJECT_BY_NAME &&
+         dset_split_lazy_sync(o, loc_params, loc_params->loc_data.loc_by_name.name) < 0) ||
+        dset_split_link_sync(o) < 0)
+        return -1;
+
+    dset_split_async_sync(o);
+    if (dset_split_lazy_create(o, TRUE) < 0 || dset_split_rebind(o) < 0)
+        return -1;
+
     under_vol_id = o->under_vol_id;
 
     ret_value = H5VLobject_specific(o->under_object, loc_params, o->under_vol_id, args, dxpl_id, req);
@@ -2932,6 +11677,14 @@ H5VL_dset_split_object_optional(void *obj, const H5VL_loc_params_t *loc_params,
     printf("DSET-SPLIT VOL OBJECT Optional\n");
 #endif
 
+    /* The operation may see the links of new datasets */
+    if (dset_split_link_sync(o) < 0)
+        return -1;
+
+    dset_split_async_sync(o);
+    if (dset_split_lazy_create(o, TRUE) < 0 || dset_split_rebind(o) < 0)
+        return -1;
+
     ret_value = H5VLobject_optional(o->under_object, loc_params, o->under_vol_id, args, dxpl_id, req);
 
     /* Check for async request */
@@ -3051,6 +11804,18 @@ H5VL_dset_split_request_wait(void *obj, uint64_t timeout, H5VL_request_status_t
     printf("DSET-SPLIT VOL REQUEST Wait\n");
 #endif
 
+#ifdef H5_HAVE_THREADSAFE
+    /* Operation run by our own engine */
+    if (o->task) {
+        dset_split_task_wait(o->task, timeout, status);
+        if (*status != H5VL_REQUEST_STATUS_IN_PROGRESS) {
+            dset_split_task_release(o->task);
+            H5VL_dset_split_free_obj(o);
+        }
+        return 0;
+    }
+#endif
+
     ret_value = H5VLrequest_wait(o->under_object, o->under_vol_id, timeout, status);
 
     if (ret_value >= 0 && *status != H5VL_REQUEST_STATUS_IN_PROGRESS)
@@ -3082,6 +11847,27 @@ H5VL_dset_split_request_notify(void *obj, H5VL_request_notify_t cb, void *ctx)
     printf("DSET-SPLIT VOL REQUEST Notify\n");
 #endif
 
+#ifdef H5_HAVE_THREADSAFE
+    /* Operation run by our own engine, the worker calls 'cb' on completion */
+    if (o->task) {
+        H5VL_request_status_t status;
+
+        pthread_mutex_lock(&H5VL_dset_split_async_g.mutex);
+        status = o->task->status;
+        if (status == H5VL_REQUEST_STATUS_IN_PROGRESS) {
+            o->task->notify_cb  = cb;
+            o->task->notify_ctx = ctx;
+        }
+        pthread_mutex_unlock(&H5VL_dset_split_async_g.mutex);
+        if (status != H5VL_REQUEST_STATUS_IN_PROGRESS)
+            cb(ctx, status);
+
+        dset_split_task_release(o->task);
+        H5VL_dset_split_free_obj(o);
+        return 0;
+    }
+#endif
+
     ret_value = H5VLrequest_notify(o->under_object, o->under_vol_id, cb, ctx);
 
     if (ret_value >= 0)
@@ -3112,6 +11898,16 @@ H5VL_dset_split_request_cancel(void *obj, H5VL_request_status_t *status)
     printf("DSET-SPLIT VOL REQUEST Cancel\n");
 #endif
 
+#ifdef H5_HAVE_THREADSAFE
+    /* Operation run by our own engine */
+    if (o->task) {
+        dset_split_task_cancel(o->task, status);
+        dset_split_task_release(o->task);
+        H5VL_dset_split_free_obj(o);
+        return 0;
+    }
+#endif
+
     ret_value = H5VLrequest_cancel(o->under_object, o->under_vol_id, status);
 
     if (ret_value >= 0)
@@ -3140,6 +11936,30 @@ H5VL_dset_split_request_specific(void *obj, H5VL_request_specific_args_t *args)
 #endif
     herr_t               ret_value = -1;
 
+#ifdef H5_HAVE_THREADSAFE
+    /* Operation run by our own engine */
+    if (o->task) {
+        switch (args->op_type) {
+            case H5VL_REQUEST_GET_ERR_STACK:
+                /* The error stack goes to the caller */
+                if (o->task->err_stack_id >= 0) {
+                    args->args.get_err_stack.err_stack_id = o->task->err_stack_id;
+                    o->task->err_stack_id                 = H5I_INVALID_HID;
+                }
+                else
+                    args->args.get_err_stack.err_stack_id = H5Ecreate_stack();
+                return args->args.get_err_stack.err_stack_id < 0 ? -1 : 0;
+
+            case H5VL_REQUEST_GET_EXEC_TIME:
+                *args->args.get_exec_time.exec_ts   = o->task->exec_ts;
+                *args->args.get_exec_time.exec_time = o->task->exec_time;
+                return 0;
+
+            default:
+                return -1;
+        }
+    }
+#endif
 
     ret_value = H5VLrequest_specific(o->under_object, o->under_vol_id, args);
 
@@ -3167,6 +11987,10 @@ H5VL_dset_split_request_optional(void *obj, H5VL_optional_args_t *args)
     printf("DSET-SPLIT VOL REQUEST Optional\n");
 #endif
 
+    /* No optional operations on requests of our own engine */
+    if (o->task)
+        return -1;
+
     ret_value = H5VLrequest_optional(o->under_object, o->under_vol_id, args);
     return ret_value;
 } /* end H5VL_dset_split_request_optional() */
@@ -3192,6 +12016,15 @@ H5VL_dset_split_request_free(void *obj)
     printf("DSET-SPLIT VOL REQUEST Free\n");
 #endif
 
+#ifdef H5_HAVE_THREADSAFE
+    /* Operation run by our own engine, it completes without the request */
+    if (o->task) {
+        dset_split_task_release(o->task);
+        H5VL_dset_split_free_obj(o);
+        return 0;
+    }
+#endif
+
     ret_value = H5VLrequest_free(o->under_object, o->under_vol_id);
 
     if (ret_value >= 0)
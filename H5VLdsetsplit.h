@@ -20,17 +20,77 @@
 #define H5VL_DSET_SPLIT_VALUE   909 /* VOL connector ID */
 #define H5VL_DSET_SPLIT_VERSION 0
 
+/* Where the datasets of a file are stored */
+typedef enum H5VL_dset_split_mode_t {
+    H5VL_DSET_SPLIT_MODE_DATASET = 0, /* One split file per dataset */
+    H5VL_DSET_SPLIT_MODE_GROUP,       /* One split file per group, shared by its datasets */
+    H5VL_DSET_SPLIT_MODE_INLINE       /* No split file, datasets stay in the main file */
+} H5VL_dset_split_mode_t;
+
+/* File driver of split files */
+typedef enum H5VL_dset_split_driver_t {
+    H5VL_DSET_SPLIT_DRIVER_INHERIT = 0, /* The main file's driver */
+    H5VL_DSET_SPLIT_DRIVER_SEC2,        /* POSIX I/O */
+    H5VL_DSET_SPLIT_DRIVER_CORE         /* In memory, written to disk on close */
+} H5VL_dset_split_driver_t;
+
 /* Pass-through VOL connector info */
 typedef struct H5VL_dset_split_info_t {
     hid_t under_vol_id;   /* VOL ID for under VOL */
     void *under_vol_info; /* VOL info for under VOL */
+    unsigned pool_size;   /* Max. number of idle split files kept open (0 disables the pool) */
+    unsigned precreate;   /* Number of empty split files created ahead per split folder (0 disables it) */
+    hsize_t split_threshold; /* Datasets up to this size in bytes stay in the main file (0 splits all) */
+    H5VL_dset_split_mode_t split_mode; /* Placement of datasets no policy rule matches */
+    char *split_policy;   /* Policy table, "pattern:placement" rules (NULL for none) */
+    unsigned aggregators; /* MPI-IO aggregators (cb_nodes) for split files of parallel files (0 keeps the default) */
+    unsigned subfiling;   /* Non-zero to write datasets of parallel files to rank-local split files */
+    unsigned async_threads; /* Threads running asynchronous dataset operations (0 runs them synchronously) */
+    unsigned direct_io;   /* Non-zero to let multi-dataset reads and writes bypass the library */
+    hsize_t write_behind;        /* Dataset writes up to this size in bytes are buffered (0 disables) */
+    hsize_t write_behind_budget; /* Memory for the buffered writes of a file, in bytes (0 for 64M) */
+    unsigned read_ahead;  /* Number of sequential dataset reads prefetched (0 disables) */
+    unsigned mmap_read;   /* Non-zero to read contiguous datasets of read-only split files through mmap */
+    unsigned compress_threads; /* Threads compressing the chunks of deflated datasets (0 leaves it to the library) */
+    unsigned lazy_create; /* Non-zero to create split files on the first write of their dataset */
+    unsigned batch_links; /* Non-zero to insert the external links of new datasets when the file is flushed */
+    unsigned eager_folder; /* Non-zero to create the split folder with the main file */
+    unsigned shard_levels; /* Levels of hash-prefix subfolders of the split folder, up to 3 (0 for none) */
+    unsigned mirror_groups; /* Non-zero to lay split files out in subfolders mirroring the group hierarchy */
+    unsigned max_open_files; /* Max. number of split files open at once, datasets reopen theirs as needed (0 for no limit) */
+    hsize_t mem_budget;      /* Memory of the caches of split files and split datasets, in bytes (0 for no limit) */
+    /* Properties of split files that override the main file's ones (0 keeps the main file's) */
+    hsize_t split_alignment;       /* Alignment of file objects, in bytes */
+    hsize_t split_align_threshold; /* Objects at least this size are aligned (0 for 1) */
+    hsize_t split_meta_block_size; /* Size of metadata blocks */
+    hsize_t split_sieve_buf_size;  /* Size of the data sieve buffer */
+    hsize_t split_page_size;       /* Page size, non-zero for the paged file space strategy */
+    unsigned split_libver_latest;  /* Non-zero to write split files with the latest format */
+    H5VL_dset_split_driver_t split_driver; /* File driver */
 } H5VL_dset_split_info_t;
 
+/* A chunk written as is, already filtered, by H5VL_dset_split_dataset_write_chunks() */
+typedef struct H5VL_dset_split_chunk_t {
+    const hsize_t *offset; /* Logical position of the chunk's first element in the dataset */
+    uint32_t filters;      /* Mask of the filters not applied to the chunk */
+    size_t size;           /* Size of the chunk as stored, in bytes */
+    const void *buf;       /* The chunk as stored */
+} H5VL_dset_split_chunk_t;
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
 H5_DLL hid_t H5VL_dset_split_register(void);
+H5_DLL herr_t H5VL_dset_split_dataset_read_multi(size_t count, const hid_t dset_ids[],
+                                                 const hid_t mem_type_ids[], const hid_t mem_space_ids[],
+                                                 const hid_t file_space_ids[], hid_t dxpl_id, void *bufs[]);
+H5_DLL herr_t H5VL_dset_split_dataset_write_multi(size_t count, const hid_t dset_ids[],
+                                                  const hid_t mem_type_ids[], const hid_t mem_space_ids[],
+                                                  const hid_t file_space_ids[], hid_t dxpl_id, const void *bufs[]);
+H5_DLL herr_t H5VL_dset_split_dataset_get_mapped(hid_t dset_id, const void **ptr, size_t *nbytes);
+H5_DLL herr_t H5VL_dset_split_dataset_write_chunks(hid_t dset_id, hid_t dxpl_id, size_t count,
+                                                   const H5VL_dset_split_chunk_t chunks[]);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,108 @@
+/*Copyright 2021 Hewlett Packard Enterprise Development LP.*/
+/*
+ *  This example checks the asynchronous engine.
+ *  It creates, writes, reads and closes NDSETS datasets with the event
+ *  set calls, waits for them, then reopens the file and checks the data.
+ *
+ *  Run it with connector threads, on a thread-safe HDF5 library:
+ *    HDF5_VOL_CONNECTOR="dset-split under_vol=0;under_info={};async_threads=4" ./h5_async
+ */
+
+#include "hdf5.h"
+
+#include <stdio.h>
+
+#define H5FILE_NAME "async.h5"
+#define DATASETNAME "IntArray"
+#define NDSETS      8 /* number of datasets */
+#define NX          64 /* dataset dimensions */
+#define NY          64
+#define RANK        2
+
+static int data[NDSETS][NX][NY];      /* data to write */
+static int read_data[NDSETS][NX][NY]; /* data read back */
+
+static int
+check(const int buf[NX][NY], int id)
+{
+    int i, j;
+
+    for (j = 0; j < NX; j++)
+        for (i = 0; i < NY; i++)
+            if (buf[j][i] != id * 10000 + j * NY + i)
+                return -1;
+    return 0;
+}
+
+int
+main(void)
+{
+    hid_t   file;              /* file handle */
+    hid_t   dataspace;         /* handles */
+    hid_t   dataset;
+    hid_t   datasets[NDSETS];
+    hid_t   es;                /* event set */
+    hsize_t dimsf[2];          /* dataset dimensions */
+    size_t  num_in_progress;
+    hbool_t op_failed = 0;
+    char    dsname[100];
+    int     nerrors = 0;
+    int     i, j, k;
+
+    for (k = 0; k < NDSETS; k++)
+        for (j = 0; j < NX; j++)
+            for (i = 0; i < NY; i++)
+                data[k][j][i] = k * 10000 + j * NY + i;
+
+    /*
+     * Create, write, read back and close the datasets asynchronously.
+     */
+    es        = H5EScreate();
+    file      = H5Fcreate(H5FILE_NAME, H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT);
+    dimsf[0]  = NX;
+    dimsf[1]  = NY;
+    dataspace = H5Screate_simple(RANK, dimsf, NULL);
+    for (k = 0; k < NDSETS; k++) {
+        sprintf(dsname, "%s-%d", DATASETNAME, k);
+        datasets[k] = H5Dcreate_async(file, dsname, H5T_NATIVE_INT, dataspace, H5P_DEFAULT, H5P_DEFAULT,
+                                      H5P_DEFAULT, es);
+        H5Dwrite_async(datasets[k], H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, data[k], es);
+    }
+    for (k = 0; k < NDSETS; k++) {
+        H5Dread_async(datasets[k], H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, read_data[k], es);
+        H5Dclose_async(datasets[k], es);
+    }
+    if (H5ESwait(es, H5ES_WAIT_FOREVER, &num_in_progress, &op_failed) < 0 || op_failed) {
+        printf("Asynchronous operations failed\n");
+        nerrors++;
+    }
+    for (k = 0; k < NDSETS; k++)
+        if (check(read_data[k], k) < 0) {
+            printf("Wrong data read asynchronously from dataset %d\n", k);
+            nerrors++;
+        }
+    H5Sclose(dataspace);
+    H5Fclose(file);
+    H5ESclose(es);
+
+    /*
+     * Reopen the file and check the datasets.
+     */
+    file = H5Fopen(H5FILE_NAME, H5F_ACC_RDONLY, H5P_DEFAULT);
+    for (k = 0; k < NDSETS; k++) {
+        sprintf(dsname, "%s-%d", DATASETNAME, k);
+        if ((dataset = H5Dopen2(file, dsname, H5P_DEFAULT)) < 0 ||
+            H5Dread(dataset, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, read_data[k]) < 0 ||
+            check(read_data[k], k) < 0) {
+            printf("Wrong data in %s after reopening\n", dsname);
+            nerrors++;
+        }
+        if (dataset >= 0)
+            H5Dclose(dataset);
+    }
+    H5Fclose(file);
+
+    printf("%s\n", nerrors ? "FAILED" : "PASSED");
+
+    return nerrors ? 1 : 0;
+}
@@ -0,0 +1,71 @@
+/*Copyright 2021 Hewlett Packard Enterprise Development LP.*/
+/*
+ *  This example measures the dataset create rate.
+ *  It creates NDSETS small datasets in one file, each getting its own
+ *  split file, and reports how many are created per second.
+ *
+ *  Run it with the split folder created with the main file to keep the
+ *  folder check off the per-dataset path, e.g. under strace -c to count
+ *  the mkdir and stat calls:
+ *    HDF5_VOL_CONNECTOR="dset-split under_vol=0;under_info={}"                ./h5_create_bench
+ *    HDF5_VOL_CONNECTOR="dset-split under_vol=0;under_info={};eager_folder=1" ./h5_create_bench
+ */
+
+#include "hdf5.h"
+
+#include <stdio.h>
+#include <sys/time.h>
+
+#define H5FILE_NAME "create-bench.h5"
+#define DATASETNAME "IntArray"
+#define NDSETS      10000 /* number of datasets */
+#define NX          16 /* dataset dimensions */
+#define NY          16
+#define RANK        2
+
+static double
+get_time_usec(void)
+{
+    struct timeval tp;
+
+    gettimeofday(&tp, NULL);
+    return (double)tp.tv_sec * 1000000.0 + (double)tp.tv_usec;
+}
+
+int
+main(void)
+{
+    hid_t   file, dataset;     /* file and dataset handles */
+    hid_t   dataspace;         /* handles */
+    hsize_t dimsf[2];          /* dataset dimensions */
+    char    dsname[100];
+    double  start, elapsed;
+    int     i;
+
+    file      = H5Fcreate(H5FILE_NAME, H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT);
+    dimsf[0]  = NX;
+    dimsf[1]  = NY;
+    dataspace = H5Screate_simple(RANK, dimsf, NULL);
+
+    /*
+     * Create and close NDSETS datasets.
+     */
+    start = get_time_usec();
+    for (i = 0; i < NDSETS; i++) {
+        sprintf(dsname, "%s-%d", DATASETNAME, i);
+        dataset = H5Dcreate2(file, dsname, H5T_NATIVE_INT, dataspace, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+        if (dataset < 0) {
+            printf("Failed to create %s\n", dsname);
+            return 1;
+        }
+        H5Dclose(dataset);
+    }
+    elapsed = get_time_usec() - start;
+
+    H5Sclose(dataspace);
+    H5Fclose(file);
+
+    printf("%d creates, %.0f datasets/s\n", NDSETS, NDSETS / (elapsed / 1000000.0));
+
+    return 0;
+}
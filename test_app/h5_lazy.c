@@ -0,0 +1,138 @@
+/*Copyright 2021 Hewlett Packard Enterprise Development LP.*/
+/*
+ *  This example checks the deferred creation of datasets.
+ *  It creates three datasets: the first is looked up by name and written,
+ *  the second is opened by name through a second handle before any write
+ *  and written through it, the third is closed without being written.
+ *  All three must be visible to H5Lexists and H5Literate right after their
+ *  creation. It then reopens the file and checks the data, the third
+ *  dataset reading as its fill value.
+ *
+ *  Run it with deferred creation enabled:
+ *    HDF5_VOL_CONNECTOR="dset-split under_vol=0;under_info={};lazy_create=1" ./h5_lazy
+ */
+
+#include "hdf5.h"
+
+#include <stdio.h>
+
+#define H5FILE_NAME "lazy.h5"
+#define DATASETNAME "IntArray"
+#define NDSETS      3 /* number of datasets */
+#define NX          10 /* dataset dimensions */
+#define NY          12
+#define FILL        42 /* fill value */
+#define RANK        2
+
+static herr_t
+count_links(hid_t group, const char *name, const H5L_info2_t *info, void *op_data)
+{
+    (*(int *)op_data)++;
+    return 0;
+}
+
+static int
+check(hid_t file, const char *dsname, int id)
+{
+    int   data[NX][NY];
+    hid_t dataset;
+    int   ret_value = 0;
+    int   i, j;
+
+    if ((dataset = H5Dopen2(file, dsname, H5P_DEFAULT)) < 0)
+        return -1;
+    if (H5Dread(dataset, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, data) < 0)
+        ret_value = -1;
+    for (j = 0; j < NX && !ret_value; j++)
+        for (i = 0; i < NY; i++)
+            if (data[j][i] != (id < 0 ? FILL : id * 1000 + j * NY + i)) {
+                ret_value = -1;
+                break;
+            }
+    H5Dclose(dataset);
+
+    return ret_value;
+}
+
+int
+main(void)
+{
+    hid_t   file;              /* file handle */
+    hid_t   dataspace, dcpl;   /* handles */
+    hid_t   datasets[NDSETS];  /* dataset handles */
+    hid_t   dataset;
+    hsize_t dimsf[2];          /* dataset dimensions */
+    int     data[NX][NY];      /* data to write */
+    int     fill    = FILL;
+    int     nlinks  = 0;
+    int     nerrors = 0;
+    char    dsname[100];
+    int     i, j, k;
+
+    file      = H5Fcreate(H5FILE_NAME, H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT);
+    dimsf[0]  = NX;
+    dimsf[1]  = NY;
+    dataspace = H5Screate_simple(RANK, dimsf, NULL);
+    dcpl      = H5Pcreate(H5P_DATASET_CREATE);
+    H5Pset_fill_value(dcpl, H5T_NATIVE_INT, &fill);
+    for (k = 0; k < NDSETS; k++) {
+        sprintf(dsname, "%s-%d", DATASETNAME, k);
+        if ((datasets[k] = H5Dcreate2(file, dsname, H5T_NATIVE_INT, dataspace, H5P_DEFAULT, dcpl,
+                                      H5P_DEFAULT)) < 0) {
+            printf("Failed to create %s\n", dsname);
+            return 1;
+        }
+    }
+    H5Pclose(dcpl);
+    H5Sclose(dataspace);
+
+    /*
+     * The datasets are visible before their first write.
+     */
+    if (H5Lexists(file, DATASETNAME "-0", H5P_DEFAULT) <= 0) {
+        printf("%s-0 does not exist before its first write\n", DATASETNAME);
+        nerrors++;
+    }
+    if (H5Literate2(file, H5_INDEX_NAME, H5_ITER_INC, NULL, count_links, &nlinks) < 0 || nlinks != NDSETS) {
+        printf("Iteration found %d of %d datasets\n", nlinks, NDSETS);
+        nerrors++;
+    }
+
+    /*
+     * Write the first dataset through its handle, the second through a
+     * handle opened by name, and close the third unwritten.
+     */
+    for (k = 0; k < 2; k++) {
+        for (j = 0; j < NX; j++)
+            for (i = 0; i < NY; i++)
+                data[j][i] = k * 1000 + j * NY + i;
+        sprintf(dsname, "%s-%d", DATASETNAME, k);
+        dataset = k == 0 ? datasets[k] : H5Dopen2(file, dsname, H5P_DEFAULT);
+        if (dataset < 0 || H5Dwrite(dataset, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, data) < 0) {
+            printf("Failed to write %s\n", dsname);
+            nerrors++;
+        }
+        if (dataset >= 0 && dataset != datasets[k])
+            H5Dclose(dataset);
+    }
+    for (k = 0; k < NDSETS; k++)
+        H5Dclose(datasets[k]);
+    H5Fclose(file);
+
+    /*
+     * Reopen the file and check the datasets.
+     */
+    file = H5Fopen(H5FILE_NAME, H5F_ACC_RDONLY, H5P_DEFAULT);
+    for (k = 0; k < NDSETS; k++) {
+        sprintf(dsname, "%s-%d", DATASETNAME, k);
+        if (check(file, dsname, k < 2 ? k : -1) < 0) {
+            printf("Wrong data in %s after reopening\n", dsname);
+            nerrors++;
+        }
+    }
+    H5Fclose(file);
+
+    printf("%s\n", nerrors ? "FAILED" : "PASSED");
+
+    return nerrors ? 1 : 0;
+}
@@ -0,0 +1,123 @@
+/*Copyright 2021 Hewlett Packard Enterprise Development LP.*/
+/*
+ *  This example checks deferred creation together with queued links.
+ *  It creates NDSETS datasets and writes every other one: the first write
+ *  creates the dataset, whose external link is queued. The written
+ *  datasets must be found by name before the file is flushed. It then
+ *  reopens the file and checks the data, the datasets never written
+ *  reading as their fill value.
+ *
+ *  Run it with deferred creation and queued links enabled:
+ *    HDF5_VOL_CONNECTOR="dset-split under_vol=0;under_info={};lazy_create=1;batch_links=1" ./h5_lazy_links
+ */
+
+#include "hdf5.h"
+
+#include <stdio.h>
+
+#define H5FILE_NAME "lazy-links.h5"
+#define DATASETNAME "IntArray"
+#define NDSETS      8 /* number of datasets */
+#define NX          10 /* dataset dimensions */
+#define NY          12
+#define FILL        42 /* fill value */
+#define RANK        2
+
+static int
+check(hid_t file, const char *dsname, int id)
+{
+    int   data[NX][NY];
+    hid_t dataset;
+    int   ret_value = 0;
+    int   i, j;
+
+    if ((dataset = H5Dopen2(file, dsname, H5P_DEFAULT)) < 0)
+        return -1;
+    if (H5Dread(dataset, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, data) < 0)
+        ret_value = -1;
+    for (j = 0; j < NX && !ret_value; j++)
+        for (i = 0; i < NY; i++)
+            if (data[j][i] != (id < 0 ? FILL : id * 1000 + j * NY + i)) {
+                ret_value = -1;
+                break;
+            }
+    H5Dclose(dataset);
+
+    return ret_value;
+}
+
+int
+main(void)
+{
+    hid_t   file;              /* file handle */
+    hid_t   dataspace, dcpl;   /* handles */
+    hid_t   datasets[NDSETS];  /* dataset handles */
+    hsize_t dimsf[2];          /* dataset dimensions */
+    int     data[NX][NY];      /* data to write */
+    int     fill    = FILL;
+    int     nerrors = 0;
+    char    dsname[100];
+    int     i, j, k;
+
+    file      = H5Fcreate(H5FILE_NAME, H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT);
+    dimsf[0]  = NX;
+    dimsf[1]  = NY;
+    dataspace = H5Screate_simple(RANK, dimsf, NULL);
+    dcpl      = H5Pcreate(H5P_DATASET_CREATE);
+    H5Pset_fill_value(dcpl, H5T_NATIVE_INT, &fill);
+    for (k = 0; k < NDSETS; k++) {
+        sprintf(dsname, "%s-%d", DATASETNAME, k);
+        if ((datasets[k] = H5Dcreate2(file, dsname, H5T_NATIVE_INT, dataspace, H5P_DEFAULT, dcpl,
+                                      H5P_DEFAULT)) < 0) {
+            printf("Failed to create %s\n", dsname);
+            return 1;
+        }
+    }
+    H5Pclose(dcpl);
+    H5Sclose(dataspace);
+
+    /*
+     * The first write creates the dataset and queues its link.
+     */
+    for (k = 0; k < NDSETS; k += 2) {
+        for (j = 0; j < NX; j++)
+            for (i = 0; i < NY; i++)
+                data[j][i] = k * 1000 + j * NY + i;
+        if (H5Dwrite(datasets[k], H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, data) < 0) {
+            printf("Failed to write %s-%d\n", DATASETNAME, k);
+            nerrors++;
+        }
+    }
+
+    /*
+     * The queued links resolve before the flush.
+     */
+    for (k = 0; k < NDSETS; k += 2) {
+        sprintf(dsname, "%s-%d", DATASETNAME, k);
+        if (H5Lexists(file, dsname, H5P_DEFAULT) <= 0) {
+            printf("%s does not exist before the flush\n", dsname);
+            nerrors++;
+        }
+    }
+    H5Fflush(file, H5F_SCOPE_GLOBAL);
+    for (k = 0; k < NDSETS; k++)
+        H5Dclose(datasets[k]);
+    H5Fclose(file);
+
+    /*
+     * Reopen the file and check the datasets.
+     */
+    file = H5Fopen(H5FILE_NAME, H5F_ACC_RDONLY, H5P_DEFAULT);
+    for (k = 0; k < NDSETS; k++) {
+        sprintf(dsname, "%s-%d", DATASETNAME, k);
+        if (check(file, dsname, k % 2 ? -1 : k) < 0) {
+            printf("Wrong data in %s after reopening\n", dsname);
+            nerrors++;
+        }
+    }
+    H5Fclose(file);
+
+    printf("%s\n", nerrors ? "FAILED" : "PASSED");
+
+    return nerrors ? 1 : 0;
+}
@@ -0,0 +1,125 @@
+/*Copyright 2021 Hewlett Packard Enterprise Development LP.*/
+/*
+ *  This example measures the write and read bandwidth of many datasets,
+ *  one split file each, transferred with a loop of H5Dwrite/H5Dread and
+ *  with one H5VL_dset_split_dataset_write_multi/_read_multi call.
+ *
+ *  Run it with direct I/O enabled:
+ *    HDF5_VOL_CONNECTOR="dset-split under_vol=0;under_info={};direct_io=1" ./h5_multi_write
+ */
+
+#include "hdf5.h"
+#include "H5VLdsetsplit.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/time.h>
+
+#define H5FILE_NAME "multi-write.h5"
+#define DATASETNAME "FloatArray"
+#define NDSETS      8 /* number of datasets */
+#define NX          (4 * 1024 * 1024) /* dataset dimension */
+#define RANK        1
+
+static double
+get_time_usec(void)
+{
+    struct timeval tp;
+
+    gettimeofday(&tp, NULL);
+    return (double)tp.tv_sec * 1000000.0 + (double)tp.tv_usec;
+}
+
+int
+main(void)
+{
+    hid_t       file;                /* file handle */
+    hid_t       dataspace;           /* handles */
+    hid_t       dsets[NDSETS];       /* dataset handles */
+    hid_t       mem_types[NDSETS];
+    hid_t       mem_spaces[NDSETS];
+    hid_t       file_spaces[NDSETS];
+    const void *bufs[NDSETS];
+    void *      read_bufs[NDSETS];
+    hsize_t     dimsf[1];            /* dataset dimensions */
+    float *     data;                /* data to write */
+    char        dsname[100];
+    double      start, loop_time, multi_time, read_loop_time, read_multi_time;
+    double      mbytes = (double)NDSETS * NX * sizeof(float) / (1024.0 * 1024.0);
+    int         i;
+
+    if (NULL == (data = (float *)malloc((size_t)NDSETS * NX * sizeof(float)))) {
+        printf("Failed to allocate the data\n");
+        return 1;
+    }
+    for (i = 0; i < NDSETS * NX; i++)
+        data[i] = (float)i;
+
+    /*
+     * Create the datasets.
+     */
+    file      = H5Fcreate(H5FILE_NAME, H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT);
+    dimsf[0]  = NX;
+    dataspace = H5Screate_simple(RANK, dimsf, NULL);
+    for (i = 0; i < NDSETS; i++) {
+        sprintf(dsname, "%s-%d", DATASETNAME, i);
+        dsets[i]       = H5Dcreate2(file, dsname, H5T_NATIVE_FLOAT, dataspace, H5P_DEFAULT, H5P_DEFAULT,
+                              H5P_DEFAULT);
+        mem_types[i]   = H5T_NATIVE_FLOAT;
+        mem_spaces[i]  = H5S_ALL;
+        file_spaces[i] = H5S_ALL;
+        bufs[i]        = data + (size_t)i * NX;
+        read_bufs[i]   = data + (size_t)i * NX;
+    }
+
+    /*
+     * Write them one after the other, then all at once.
+     */
+    start = get_time_usec();
+    for (i = 0; i < NDSETS; i++)
+        if (H5Dwrite(dsets[i], H5T_NATIVE_FLOAT, H5S_ALL, H5S_ALL, H5P_DEFAULT, bufs[i]) < 0) {
+            printf("Failed to write %s-%d\n", DATASETNAME, i);
+            return 1;
+        }
+    loop_time = get_time_usec() - start;
+
+    start = get_time_usec();
+    if (H5VL_dset_split_dataset_write_multi(NDSETS, dsets, mem_types, mem_spaces, file_spaces, H5P_DEFAULT,
+                                            bufs) < 0) {
+        printf("Failed to write the datasets\n");
+        return 1;
+    }
+    multi_time = get_time_usec() - start;
+
+    /*
+     * Read them back the same two ways.
+     */
+    start = get_time_usec();
+    for (i = 0; i < NDSETS; i++)
+        if (H5Dread(dsets[i], H5T_NATIVE_FLOAT, H5S_ALL, H5S_ALL, H5P_DEFAULT, read_bufs[i]) < 0) {
+            printf("Failed to read %s-%d\n", DATASETNAME, i);
+            return 1;
+        }
+    read_loop_time = get_time_usec() - start;
+
+    start = get_time_usec();
+    if (H5VL_dset_split_dataset_read_multi(NDSETS, dsets, mem_types, mem_spaces, file_spaces, H5P_DEFAULT,
+                                           read_bufs) < 0) {
+        printf("Failed to read the datasets\n");
+        return 1;
+    }
+    read_multi_time = get_time_usec() - start;
+
+    for (i = 0; i < NDSETS; i++)
+        H5Dclose(dsets[i]);
+    H5Sclose(dataspace);
+    H5Fclose(file);
+    free(data);
+
+    printf("H5Dwrite loop: %.2f MB/s\n", mbytes / (loop_time / 1000000.0));
+    printf("write_multi:   %.2f MB/s\n", mbytes / (multi_time / 1000000.0));
+    printf("H5Dread loop:  %.2f MB/s\n", mbytes / (read_loop_time / 1000000.0));
+    printf("read_multi:    %.2f MB/s\n", mbytes / (read_multi_time / 1000000.0));
+
+    return 0;
+}
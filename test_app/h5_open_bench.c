@@ -0,0 +1,90 @@
+/*Copyright 2021 Hewlett Packard Enterprise Development LP.*/
+/*
+ *  This example measures the dataset open latency.
+ *  It creates NDSETS datasets and then opens and closes each of them
+ *  NLOOPS times, the way time-stepping and analysis codes revisit datasets.
+ *
+ *  Run it once with the split file pool disabled and once with it enabled
+ *  to compare:
+ *    HDF5_VOL_CONNECTOR="dset-split under_vol=0;under_info={};pool_size=0"  ./h5_open_bench
+ *    HDF5_VOL_CONNECTOR="dset-split under_vol=0;under_info={};pool_size=64" ./h5_open_bench
+ */
+
+#include "hdf5.h"
+
+#include <stdio.h>
+#include <sys/time.h>
+
+#define H5FILE_NAME "open-bench.h5"
+#define DATASETNAME "IntArray"
+#define NDSETS      32 /* number of datasets */
+#define NLOOPS      100 /* number of open/close rounds */
+#define NX          64 /* dataset dimensions */
+#define NY          64
+#define RANK        2
+
+static double
+get_time_usec(void)
+{
+    struct timeval tp;
+
+    gettimeofday(&tp, NULL);
+    return (double)tp.tv_sec * 1000000.0 + (double)tp.tv_usec;
+}
+
+int
+main(void)
+{
+    hid_t   file, dataset;     /* file and dataset handles */
+    hid_t   dataspace;         /* handles */
+    hsize_t dimsf[2];          /* dataset dimensions */
+    int     data[NX][NY];      /* data to write */
+    char    dsname[100];
+    double  start, elapsed;
+    int     i, j;
+
+    for (j = 0; j < NX; j++)
+        for (i = 0; i < NY; i++)
+            data[j][i] = i + j;
+
+    /*
+     * Create the datasets.
+     */
+    file      = H5Fcreate(H5FILE_NAME, H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT);
+    dimsf[0]  = NX;
+    dimsf[1]  = NY;
+    dataspace = H5Screate_simple(RANK, dimsf, NULL);
+    for (i = 0; i < NDSETS; i++) {
+        sprintf(dsname, "%s-%d", DATASETNAME, i);
+        dataset = H5Dcreate2(file, dsname, H5T_NATIVE_INT, dataspace, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+        H5Dwrite(dataset, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, data);
+        H5Dclose(dataset);
+    }
+    H5Sclose(dataspace);
+    H5Fclose(file);
+
+    /*
+     * Open and close every dataset NLOOPS times.
+     */
+    file    = H5Fopen(H5FILE_NAME, H5F_ACC_RDONLY, H5P_DEFAULT);
+    elapsed = 0.0;
+    for (j = 0; j < NLOOPS; j++) {
+        for (i = 0; i < NDSETS; i++) {
+            sprintf(dsname, "%s-%d", DATASETNAME, i);
+            start   = get_time_usec();
+            dataset = H5Dopen2(file, dsname, H5P_DEFAULT);
+            elapsed += get_time_usec() - start;
+            if (dataset < 0) {
+                printf("Failed to open %s\n", dsname);
+                return 1;
+            }
+            H5Dread(dataset, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, data);
+            H5Dclose(dataset);
+        }
+    }
+    H5Fclose(file);
+
+    printf("%d opens, average open latency %.2f us\n", NDSETS * NLOOPS, elapsed / (NDSETS * NLOOPS));
+
+    return 0;
+}
@@ -0,0 +1,113 @@
+/*Copyright 2021 Hewlett Packard Enterprise Development LP.*/
+/*
+ *  This example checks the open split file budget.
+ *  It keeps NDSETS datasets open at once, more than max_open_files split
+ *  files, writes and reads them in turns so that their split files are
+ *  closed and reopened behind the handles, then reopens the file and
+ *  checks the data.
+ *
+ *  Run it with a budget smaller than NDSETS:
+ *    HDF5_VOL_CONNECTOR="dset-split under_vol=0;under_info={};max_open_files=2" ./h5_open_files
+ */
+
+#include "hdf5.h"
+
+#include <stdio.h>
+
+#define H5FILE_NAME "open-files.h5"
+#define DATASETNAME "IntArray"
+#define NDSETS      8 /* number of datasets, all open at once */
+#define NX          16 /* dataset dimensions */
+#define NY          16
+#define RANK        2
+
+static int
+check(hid_t dataset, int id)
+{
+    int data[NX][NY];
+    int i, j;
+
+    if (H5Dread(dataset, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, data) < 0)
+        return -1;
+    for (j = 0; j < NX; j++)
+        for (i = 0; i < NY; i++)
+            if (data[j][i] != id * 1000 + j * NY + i)
+                return -1;
+    return 0;
+}
+
+int
+main(void)
+{
+    hid_t   file;              /* file handle */
+    hid_t   dataspace;         /* handles */
+    hid_t   datasets[NDSETS];  /* dataset handles */
+    hsize_t dimsf[2];          /* dataset dimensions */
+    int     data[NX][NY];      /* data to write */
+    char    dsname[100];
+    int     nerrors = 0;
+    int     i, j, k;
+
+    /*
+     * Create all the datasets and keep them open.
+     */
+    file      = H5Fcreate(H5FILE_NAME, H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT);
+    dimsf[0]  = NX;
+    dimsf[1]  = NY;
+    dataspace = H5Screate_simple(RANK, dimsf, NULL);
+    for (k = 0; k < NDSETS; k++) {
+        sprintf(dsname, "%s-%d", DATASETNAME, k);
+        datasets[k] = H5Dcreate2(file, dsname, H5T_NATIVE_INT, dataspace, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+        if (datasets[k] < 0) {
+            printf("Failed to create %s\n", dsname);
+            return 1;
+        }
+    }
+    H5Sclose(dataspace);
+
+    /*
+     * Write them in turns, then read them back in reverse order,
+     * each access reopening a split file closed for another one.
+     */
+    for (k = 0; k < NDSETS; k++) {
+        for (j = 0; j < NX; j++)
+            for (i = 0; i < NY; i++)
+                data[j][i] = k * 1000 + j * NY + i;
+        if (H5Dwrite(datasets[k], H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, data) < 0) {
+            printf("Failed to write dataset %d\n", k);
+            nerrors++;
+        }
+    }
+    for (k = NDSETS - 1; k >= 0; k--)
+        if (check(datasets[k], k) < 0) {
+            printf("Wrong data in dataset %d while open\n", k);
+            nerrors++;
+        }
+    for (k = 0; k < NDSETS; k++)
+        H5Dclose(datasets[k]);
+    H5Fclose(file);
+
+    /*
+     * Reopen the file and all the datasets at once, and check them.
+     */
+    file = H5Fopen(H5FILE_NAME, H5F_ACC_RDONLY, H5P_DEFAULT);
+    for (k = 0; k < NDSETS; k++) {
+        sprintf(dsname, "%s-%d", DATASETNAME, k);
+        if ((datasets[k] = H5Dopen2(file, dsname, H5P_DEFAULT)) < 0) {
+            printf("Failed to open %s\n", dsname);
+            return 1;
+        }
+    }
+    for (k = 0; k < NDSETS; k++)
+        if (check(datasets[k], k) < 0) {
+            printf("Wrong data in dataset %d after reopening\n", k);
+            nerrors++;
+        }
+    for (k = 0; k < NDSETS; k++)
+        H5Dclose(datasets[k]);
+    H5Fclose(file);
+
+    printf("%s\n", nerrors ? "FAILED" : "PASSED");
+
+    return nerrors ? 1 : 0;
+}
@@ -0,0 +1,126 @@
+/*Copyright 2021 Hewlett Packard Enterprise Development LP.*/
+/*
+ *  This example checks the read-ahead window.
+ *  It writes a dataset, reopens it and scans it in blocks of NBLOCK rows.
+ *  Halfway through the scan it overwrites a block ahead of the scan, one
+ *  already prefetched, through the same handle: the rest of the scan must
+ *  see the new values. It then reopens the file and checks the data.
+ *
+ *  Run it with read-ahead enabled:
+ *    HDF5_VOL_CONNECTOR="dset-split under_vol=0;under_info={};read_ahead=4" ./h5_read_ahead
+ */
+
+#include "hdf5.h"
+
+#include <stdio.h>
+
+#define H5FILE_NAME "read-ahead.h5"
+#define DATASETNAME "IntArray"
+#define NX          256 /* dataset dimensions */
+#define NY          32
+#define NBLOCK      8 /* rows per read */
+#define RANK        2
+
+static int data[NX][NY];      /* expected content */
+static int read_data[NX][NY]; /* data read back */
+
+static int
+block_io(hid_t dataset, hsize_t row, hbool_t write)
+{
+    hsize_t start[2] = {row, 0};
+    hsize_t count[2] = {NBLOCK, NY};
+    hid_t   filespace, memspace;
+    herr_t  status;
+
+    filespace = H5Dget_space(dataset);
+    memspace  = H5Screate_simple(RANK, count, NULL);
+    H5Sselect_hyperslab(filespace, H5S_SELECT_SET, start, NULL, count, NULL);
+    if (write)
+        status = H5Dwrite(dataset, H5T_NATIVE_INT, memspace, filespace, H5P_DEFAULT, data[row]);
+    else
+        status = H5Dread(dataset, H5T_NATIVE_INT, memspace, filespace, H5P_DEFAULT, read_data[row]);
+    H5Sclose(memspace);
+    H5Sclose(filespace);
+
+    return status < 0 ? -1 : 0;
+}
+
+static int
+check(hsize_t first, hsize_t last)
+{
+    hsize_t i, j;
+
+    for (j = first; j < last; j++)
+        for (i = 0; i < NY; i++)
+            if (read_data[j][i] != data[j][i])
+                return -1;
+    return 0;
+}
+
+int
+main(void)
+{
+    hid_t   file, dataset;     /* file and dataset handles */
+    hid_t   dataspace;         /* handles */
+    hsize_t dimsf[2];          /* dataset dimensions */
+    hsize_t row;
+    int     nerrors = 0;
+    int     i, j;
+
+    for (j = 0; j < NX; j++)
+        for (i = 0; i < NY; i++)
+            data[j][i] = j * NY + i;
+
+    file      = H5Fcreate(H5FILE_NAME, H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT);
+    dimsf[0]  = NX;
+    dimsf[1]  = NY;
+    dataspace = H5Screate_simple(RANK, dimsf, NULL);
+    dataset   = H5Dcreate2(file, DATASETNAME, H5T_NATIVE_INT, dataspace, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+    H5Dwrite(dataset, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, data);
+    H5Sclose(dataspace);
+    H5Dclose(dataset);
+    H5Fclose(file);
+
+    /*
+     * Scan the dataset block by block, overwriting the block two reads
+     * ahead halfway through.
+     */
+    file    = H5Fopen(H5FILE_NAME, H5F_ACC_RDWR, H5P_DEFAULT);
+    dataset = H5Dopen2(file, DATASETNAME, H5P_DEFAULT);
+    for (row = 0; row < NX; row += NBLOCK) {
+        if (row == NX / 2) {
+            for (j = (int)row + 2 * NBLOCK; j < (int)row + 3 * NBLOCK; j++)
+                for (i = 0; i < NY; i++)
+                    data[j][i] = -data[j][i];
+            if (block_io(dataset, row + 2 * NBLOCK, 1) < 0) {
+                printf("Failed to write rows %llu\n", (unsigned long long)(row + 2 * NBLOCK));
+                nerrors++;
+            }
+        }
+        if (block_io(dataset, row, 0) < 0 || check(row, row + NBLOCK) < 0) {
+            printf("Wrong data in rows %llu to %llu\n", (unsigned long long)row,
+                   (unsigned long long)(row + NBLOCK - 1));
+            nerrors++;
+        }
+    }
+    H5Dclose(dataset);
+    H5Fclose(file);
+
+    /*
+     * Reopen the file and check the dataset.
+     */
+    file    = H5Fopen(H5FILE_NAME, H5F_ACC_RDONLY, H5P_DEFAULT);
+    dataset = H5Dopen2(file, DATASETNAME, H5P_DEFAULT);
+    if (dataset < 0 || H5Dread(dataset, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, read_data) < 0 ||
+        check(0, NX) < 0) {
+        printf("Wrong data after reopening\n");
+        nerrors++;
+    }
+    if (dataset >= 0)
+        H5Dclose(dataset);
+    H5Fclose(file);
+
+    printf("%s\n", nerrors ? "FAILED" : "PASSED");
+
+    return nerrors ? 1 : 0;
+}
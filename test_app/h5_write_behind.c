@@ -0,0 +1,119 @@
+/*Copyright 2021 Hewlett Packard Enterprise Development LP.*/
+/*
+ *  This example checks the write-behind buffers.
+ *  It writes a dataset in small runs of NRUN elements, out of order so
+ *  that buffered runs are merged, reads it back through the same handle
+ *  while runs are buffered, then reopens the file and checks the data.
+ *
+ *  Run it with write-behind enabled:
+ *    HDF5_VOL_CONNECTOR="dset-split under_vol=0;under_info={};write_behind=64K" ./h5_write_behind
+ */
+
+#include "hdf5.h"
+
+#include <stdio.h>
+
+#define H5FILE_NAME "write-behind.h5"
+#define DATASETNAME "IntArray"
+#define NX          4096 /* dataset dimension */
+#define NRUN        64   /* elements per write */
+#define RANK        1
+
+static int data[NX];      /* data to write */
+static int read_data[NX]; /* data read back */
+
+static int
+write_run(hid_t dataset, hid_t dataspace, hsize_t start)
+{
+    hsize_t count = NRUN;
+    hid_t   memspace;
+    herr_t  status;
+
+    memspace = H5Screate_simple(RANK, &count, NULL);
+    H5Sselect_hyperslab(dataspace, H5S_SELECT_SET, &start, NULL, &count, NULL);
+    status = H5Dwrite(dataset, H5T_NATIVE_INT, memspace, dataspace, H5P_DEFAULT, data + start);
+    H5Sclose(memspace);
+
+    return status < 0 ? -1 : 0;
+}
+
+static int
+check(hid_t dataset, hsize_t nelem)
+{
+    hsize_t i;
+
+    if (H5Dread(dataset, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, read_data) < 0)
+        return -1;
+    for (i = 0; i < nelem; i++)
+        if (read_data[i] != data[i])
+            return -1;
+    return 0;
+}
+
+int
+main(void)
+{
+    hid_t   file, dataset;     /* file and dataset handles */
+    hid_t   dataspace, dcpl;   /* handles */
+    hsize_t dimsf[1];          /* dataset dimensions */
+    hsize_t start;
+    int     fill    = 0;
+    int     nerrors = 0;
+    int     i;
+
+    for (i = 0; i < NX; i++)
+        data[i] = 3 * i + 1;
+
+    file      = H5Fcreate(H5FILE_NAME, H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT);
+    dimsf[0]  = NX;
+    dataspace = H5Screate_simple(RANK, dimsf, NULL);
+    dcpl      = H5Pcreate(H5P_DATASET_CREATE);
+    H5Pset_fill_value(dcpl, H5T_NATIVE_INT, &fill);
+    dataset = H5Dcreate2(file, DATASETNAME, H5T_NATIVE_INT, dataspace, H5P_DEFAULT, dcpl, H5P_DEFAULT);
+
+    /*
+     * Write the first half backwards, run by run, and read it back
+     * through the same handle while the runs are buffered.
+     */
+    for (start = NX / 2; start > 0; start -= NRUN)
+        if (write_run(dataset, dataspace, start - NRUN) < 0)
+            nerrors++;
+    if (check(dataset, NX / 2) < 0) {
+        printf("Wrong data read through the writing handle\n");
+        nerrors++;
+    }
+
+    /*
+     * Write the second half, every other run first, and leave it buffered
+     * until the dataset is closed.
+     */
+    for (start = NX / 2; start < NX; start += 2 * NRUN)
+        if (write_run(dataset, dataspace, start) < 0)
+            nerrors++;
+    for (start = NX / 2 + NRUN; start < NX; start += 2 * NRUN)
+        if (write_run(dataset, dataspace, start) < 0)
+            nerrors++;
+    if (nerrors)
+        printf("Failed to write the dataset\n");
+    H5Pclose(dcpl);
+    H5Sclose(dataspace);
+    H5Dclose(dataset);
+    H5Fclose(file);
+
+    /*
+     * Reopen the file and check the dataset.
+     */
+    file    = H5Fopen(H5FILE_NAME, H5F_ACC_RDONLY, H5P_DEFAULT);
+    dataset = H5Dopen2(file, DATASETNAME, H5P_DEFAULT);
+    if (dataset < 0 || check(dataset, NX) < 0) {
+        printf("Wrong data after reopening\n");
+        nerrors++;
+    }
+    if (dataset >= 0)
+        H5Dclose(dataset);
+    H5Fclose(file);
+
+    printf("%s\n", nerrors ? "FAILED" : "PASSED");
+
+    return nerrors ? 1 : 0;
+}
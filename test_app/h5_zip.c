@@ -0,0 +1,151 @@
+/*Copyright 2021 Hewlett Packard Enterprise Development LP.*/
+/*
+ *  This example checks the parallel deflate pipeline.
+ *  It writes a deflated dataset whose size is not a multiple of its chunk
+ *  size in two blocks of whole chunks, the second one reaching the end
+ *  of the dataset, and reads it back by blocks. It then extends the
+ *  dataset: the elements past the old end, in the padding of the edge
+ *  chunks, must read as the fill value. It finally reopens the file and
+ *  checks the data.
+ *
+ *  Run it with compression threads:
+ *    HDF5_VOL_CONNECTOR="dset-split under_vol=0;under_info={};compress_threads=4" ./h5_zip
+ */
+
+#include "hdf5.h"
+
+#include <stdio.h>
+
+#define H5FILE_NAME "zip.h5"
+#define DATASETNAME "IntArray"
+#define NX          100 /* dataset dimensions */
+#define NY          50
+#define NX_EXT      128 /* dimensions after the extension */
+#define NY_EXT      64
+#define CX          32 /* chunk dimensions */
+#define CY          16
+#define FILL        -7 /* fill value */
+#define RANK        2
+
+static int data[NX][NY];              /* data to write */
+static int block_data[NX][NY];        /* data read back by blocks */
+static int read_data[NX_EXT][NY_EXT]; /* data read back whole */
+
+static int
+block_io(hid_t dataset, hsize_t row, hsize_t nrows, hbool_t write)
+{
+    hsize_t start[2] = {row, 0};
+    hsize_t count[2] = {nrows, NY};
+    hid_t   filespace, memspace;
+    herr_t  status;
+
+    filespace = H5Dget_space(dataset);
+    memspace  = H5Screate_simple(RANK, count, NULL);
+    H5Sselect_hyperslab(filespace, H5S_SELECT_SET, start, NULL, count, NULL);
+    if (write)
+        status = H5Dwrite(dataset, H5T_NATIVE_INT, memspace, filespace, H5P_DEFAULT, data[row]);
+    else
+        status = H5Dread(dataset, H5T_NATIVE_INT, memspace, filespace, H5P_DEFAULT, block_data[row]);
+    H5Sclose(memspace);
+    H5Sclose(filespace);
+
+    return status < 0 ? -1 : 0;
+}
+
+static int
+check(void)
+{
+    int i, j;
+
+    for (j = 0; j < NX; j++)
+        for (i = 0; i < NY; i++)
+            if (block_data[j][i] != data[j][i])
+                return -1;
+    return 0;
+}
+
+int
+main(void)
+{
+    hid_t   file, dataset;     /* file and dataset handles */
+    hid_t   dataspace, dcpl;   /* handles */
+    hsize_t dimsf[2]   = {NX, NY};
+    hsize_t maxdims[2] = {H5S_UNLIMITED, H5S_UNLIMITED};
+    hsize_t dimsext[2] = {NX_EXT, NY_EXT};
+    hsize_t chunk[2]   = {CX, CY};
+    int     fill       = FILL;
+    int     nerrors    = 0;
+    int     i, j;
+
+    for (j = 0; j < NX; j++)
+        for (i = 0; i < NY; i++)
+            data[j][i] = (j * NY + i) % 97;
+
+    file      = H5Fcreate(H5FILE_NAME, H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT);
+    dataspace = H5Screate_simple(RANK, dimsf, maxdims);
+    dcpl      = H5Pcreate(H5P_DATASET_CREATE);
+    H5Pset_chunk(dcpl, RANK, chunk);
+    H5Pset_deflate(dcpl, 6);
+    H5Pset_fill_value(dcpl, H5T_NATIVE_INT, &fill);
+    dataset = H5Dcreate2(file, DATASETNAME, H5T_NATIVE_INT, dataspace, H5P_DEFAULT, dcpl, H5P_DEFAULT);
+
+    /*
+     * Two rows of whole chunks, then the rest up to the end.
+     */
+    if (block_io(dataset, 0, 2 * CX, 1) < 0 || block_io(dataset, 2 * CX, NX - 2 * CX, 1) < 0) {
+        printf("Failed to write the dataset\n");
+        nerrors++;
+    }
+    if (block_io(dataset, 0, 2 * CX, 0) < 0 || block_io(dataset, 2 * CX, NX - 2 * CX, 0) < 0 || check() < 0) {
+        printf("Wrong data read by blocks\n");
+        nerrors++;
+    }
+
+    /*
+     * Past the old end, the edge chunks were padded with the fill value.
+     */
+    if (H5Dset_extent(dataset, dimsext) < 0 ||
+        H5Dread(dataset, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, read_data) < 0) {
+        printf("Failed to extend the dataset\n");
+        nerrors++;
+    }
+    else
+        for (j = 0; j < NX_EXT; j++)
+            for (i = 0; i < NY_EXT; i++)
+                if (read_data[j][i] != (j < NX && i < NY ? data[j][i] : FILL)) {
+                    printf("Wrong value %d at (%d, %d) after the extension\n", read_data[j][i], j, i);
+                    nerrors++;
+                    j = NX_EXT;
+                    break;
+                }
+    H5Pclose(dcpl);
+    H5Sclose(dataspace);
+    H5Dclose(dataset);
+    H5Fclose(file);
+
+    /*
+     * Reopen the file and check the dataset.
+     */
+    file    = H5Fopen(H5FILE_NAME, H5F_ACC_RDONLY, H5P_DEFAULT);
+    dataset = H5Dopen2(file, DATASETNAME, H5P_DEFAULT);
+    if (dataset < 0 || H5Dread(dataset, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, read_data) < 0) {
+        printf("Failed to read the dataset after reopening\n");
+        nerrors++;
+    }
+    else
+        for (j = 0; j < NX; j++)
+            for (i = 0; i < NY; i++)
+                if (read_data[j][i] != data[j][i]) {
+                    printf("Wrong value %d at (%d, %d) after reopening\n", read_data[j][i], j, i);
+                    nerrors++;
+                    j = NX;
+                    break;
+                }
+    if (dataset >= 0)
+        H5Dclose(dataset);
+    H5Fclose(file);
+
+    printf("%s\n", nerrors ? "FAILED" : "PASSED");
+
+    return nerrors ? 1 : 0;
+}
@@ -4,6 +4,7 @@
 #include "H5VLdsetsplit.h"
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <math.h>
 #include <unistd.h>
 #include <sys/time.h>
@@ -129,6 +130,36 @@ void init_particles ()
 }
 
 // Create HDF5 file and write data
+// Create the 8 datasets, then time their writes: 8 H5Dwrite calls, or one
+// H5VL_dset_split_dataset_write_multi call
+void create_and_write_synthetic_h5_data_timed(int rank, hid_t loc, hid_t *dset_ids, hid_t filespace, hid_t memspace, hid_t plist_id,
+                                              int multi, unsigned long *write_usec)
+{
+    const char *names[8] = {"x", "y", "z", "id1", "id2", "px", "py", "pz"};
+    const void *bufs[8] = {x, y, z, id1, id2, px, py, pz};
+    hid_t mem_types[8], mem_spaces[8], file_spaces[8];
+    unsigned long t;
+    int i;
+
+    for (i = 0; i < 8; i++) {
+        mem_types[i] = (i == 3 || i == 4) ? H5T_NATIVE_INT : H5T_NATIVE_FLOAT;
+        mem_spaces[i] = memspace;
+        file_spaces[i] = filespace;
+        dset_ids[i] = H5Dcreate(loc, names[i], mem_types[i], filespace, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+    }
+
+    t = get_time_usec();
+    if (multi)
+        ierr = H5VL_dset_split_dataset_write_multi(8, dset_ids, mem_types, mem_spaces, file_spaces, plist_id, bufs);
+    else
+        for (i = 0, ierr = 0; i < 8 && ierr >= 0; i++)
+            ierr = H5Dwrite(dset_ids[i], mem_types[i], memspace, filespace, plist_id, bufs[i]);
+    *write_usec += get_time_usec() - t;
+
+    if (ierr < 0) printf ("  Failed to write the 8 variables \n");
+    if (rank == 0) printf ("  Finished written 8 variables \n");
+}
+
 void create_and_write_synthetic_h5_data(int rank, hid_t loc, hid_t *dset_ids, hid_t filespace, hid_t memspace, hid_t plist_id)
 {
     // Note: printf statements are inserted basically
@@ -170,7 +201,10 @@ void create_and_write_synthetic_h5_data(int rank, hid_t loc, hid_t *dset_ids, hi
 
 void print_usage(char *name)
 {
-    printf("Usage: %s filename #timestep sleep_sec \n", name);
+    printf("Usage: %s filename #timestep sleep_sec [loop|multi]\n", name);
+    printf("  loop or multi writes the 8 variables with 8 H5Dwrite calls or one\n");
+    printf("  H5VL_dset_split_dataset_write_multi call and reports the write bandwidth.\n");
+    printf("  On a single process the file then uses the POSIX driver, which direct_io=1 needs.\n");
 }
 
 hid_t fileaccess_mod(){
@@ -179,6 +213,8 @@ hid_t fileaccess_mod(){
     H5VL_dset_split_info_t dset_split_vol_info;
     //void *vol_info = NULL;
 
+    memset(&dset_split_vol_info, 0, sizeof(dset_split_vol_info));
+
     hid_t under_vol_id;
     void *under_vol_info;
     herr_t status;
@@ -258,6 +294,8 @@ int main (int argc, char* argv[])
 
     hid_t file_id, filespace, memspace, plist_id, *grp_ids, fapl, **dset_ids;
     char grp_name[128];
+    int timed = 0, multi = 0;
+    unsigned long write_usec = 0;
 
     if (argc < 4) {
         print_usage(argv[0]);
@@ -275,6 +313,15 @@ int main (int argc, char* argv[])
         print_usage(argv[0]);
         return 0;
     }
+
+    if (argc > 4) {
+        if (strcmp(argv[4], "loop") != 0 && strcmp(argv[4], "multi") != 0) {
+            print_usage(argv[0]);
+            return 0;
+        }
+        timed = 1;
+        multi = !strcmp(argv[4], "multi");
+    }
      numparticles = 8*1024*1024;
 
     if (my_rank == 0) {
@@ -310,7 +357,8 @@ int main (int argc, char* argv[])
     //fapl = H5Pcreate(H5P_FILE_ACCESS);
     fapl = fileaccess_mod();
 
-    H5Pset_fapl_mpio(fapl, comm, info);
+    if (!timed || num_procs > 1)
+        H5Pset_fapl_mpio(fapl, comm, info);
 
     file_id = H5Fcreate(file_name, H5F_ACC_TRUNC, H5P_DEFAULT, fapl);
     H5Pclose(fapl);
@@ -340,7 +388,11 @@ int main (int argc, char* argv[])
             printf ("Writing %s ... \n", grp_name);
 
         dset_ids[i] = (hid_t*)calloc(8, sizeof(hid_t));
-        create_and_write_synthetic_h5_data(my_rank, grp_ids[i], dset_ids[i], filespace, memspace, plist_id);
+        if (timed)
+            create_and_write_synthetic_h5_data_timed(my_rank, grp_ids[i], dset_ids[i], filespace, memspace, plist_id,
+                                                     multi, &write_usec);
+        else
+            create_and_write_synthetic_h5_data(my_rank, grp_ids[i], dset_ids[i], filespace, memspace, plist_id);
 
         if (i != nts - 1) {
             if (my_rank == 0) printf ("  sleep for %ds\n", sleep_time);
@@ -376,6 +428,10 @@ int main (int argc, char* argv[])
         //timer_msg (0, "total running");//opening, writing, closing file
         //printf ("\n");
 	printf("Total running time: %lu\n", get_time_usec() - start);
+        if (timed)
+            printf("%s write time: %lu us, %.2f MB/s per process\n", multi ? "write_multi" : "H5Dwrite loop", write_usec,
+                   (double)nts * numparticles * (6 * sizeof(float) + 2 * sizeof(int)) / (1024.0 * 1024.0) /
+                   (write_usec / 1000000.0));
     }
 
     free(x);